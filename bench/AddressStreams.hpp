@@ -0,0 +1,166 @@
+// DO-NOT-REMOVE begin-copyright-block 
+//QFlex consists of several software components that are governed by various
+//licensing terms, in addition to software that was developed internally.
+//Anyone interested in using QFlex needs to fully understand and abide by the
+//licenses governing all the software components.
+//
+//### Software developed externally (not by the QFlex group)
+//
+//    * [NS-3](https://www.gnu.org/copyleft/gpl.html)
+//    * [QEMU](http://wiki.qemu.org/License) 
+//    * [SimFlex] (http://parsa.epfl.ch/simflex/)
+//
+//Software developed internally (by the QFlex group)
+//**QFlex License**
+//
+//QFlex
+//Copyright (c) 2016, Parallel Systems Architecture Lab, EPFL
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//    * Neither the name of the Parallel Systems Architecture Laboratory, EPFL,
+//      nor the names of its contributors may be used to endorse or promote
+//      products derived from this software without specific prior written
+//      permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE PARALLEL SYSTEMS ARCHITECTURE LABORATORY,
+//EPFL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+//GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+//LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+//THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// DO-NOT-REMOVE end-copyright-block   
+#ifndef FLEXUS_BENCH_ADDRESS_STREAMS_HPP_INCLUDED
+#define FLEXUS_BENCH_ADDRESS_STREAMS_HPP_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace nBench {
+
+// One memory reference: a block-aligned address, the core issuing it, and
+// whether it is a store
+struct Access {
+  uint64_t theAddress;
+  int32_t theCore;
+  bool theWrite;
+};
+
+typedef std::vector<Access> trace_t;
+
+static const int32_t kBlockShift = 6;
+
+// Synthetic reference streams over a footprint of aFootprint blocks (a power
+// of two).  Traces are generated up front so the timed loops only walk a
+// vector.
+class AddressStreams {
+  uint64_t theFootprint;
+  int32_t theCores;
+  std::mt19937_64 theRandom;
+
+  uint64_t address(uint64_t aBlock) const {
+    return (aBlock & (theFootprint - 1)) << kBlockShift;
+  }
+
+  bool coinFlip(uint32_t aOneIn) {
+    return (theRandom() % aOneIn) == 0;
+  }
+
+public:
+  AddressStreams(uint64_t aFootprint, int32_t aCores, uint64_t aSeed)
+    : theFootprint(aFootprint)
+    , theCores(aCores)
+    , theRandom(aSeed)
+  { }
+
+  static std::vector<std::string> names() {
+    return std::vector<std::string> { "uniform", "zipf", "strided", "producer-consumer" };
+  }
+
+  void generate(std::string const & aName, uint64_t aLength, trace_t & aTrace) {
+    aTrace.clear();
+    aTrace.reserve(aLength);
+    if (aName == "uniform") {
+      uniform(aLength, aTrace);
+    } else if (aName == "zipf") {
+      zipf(aLength, 0.99, aTrace);
+    } else if (aName == "strided") {
+      strided(aLength, 8, aTrace);
+    } else {
+      producerConsumer(aLength, 64, aTrace);
+    }
+  }
+
+  // Every block equally likely, one store in four
+  void uniform(uint64_t aLength, trace_t & aTrace) {
+    for (uint64_t i = 0; i < aLength; ++i) {
+      Access access = { address(theRandom()), static_cast<int32_t>(theRandom() % theCores), coinFlip(4) };
+      aTrace.push_back(access);
+    }
+  }
+
+  // Block popularity follows Zipf(anAlpha).  Ranks are scattered over the
+  // footprint by an odd multiplier so hot blocks do not share sets.
+  void zipf(uint64_t aLength, double anAlpha, trace_t & aTrace) {
+    std::vector<double> cdf(theFootprint);
+    double sum = 0;
+    for (uint64_t rank = 0; rank < theFootprint; ++rank) {
+      sum += 1.0 / std::pow(static_cast<double>(rank + 1), anAlpha);
+      cdf[rank] = sum;
+    }
+    std::uniform_real_distribution<double> pick(0, sum);
+    for (uint64_t i = 0; i < aLength; ++i) {
+      uint64_t rank = std::lower_bound(cdf.begin(), cdf.end(), pick(theRandom)) - cdf.begin();
+      Access access = { address(rank * 0x9E3779B97F4A7C15ULL), static_cast<int32_t>(theRandom() % theCores), coinFlip(4) };
+      aTrace.push_back(access);
+    }
+  }
+
+  // Each core sweeps its own slice of the footprint, aStride blocks apart
+  void strided(uint64_t aLength, uint64_t aStride, trace_t & aTrace) {
+    uint64_t slice = theFootprint / theCores;
+    for (uint64_t i = 0; i < aLength; ++i) {
+      int32_t core = i % theCores;
+      uint64_t step = i / theCores;
+      Access access = { address(core * slice + (step * aStride) % slice), core, (step & 3) == 3 };
+      aTrace.push_back(access);
+    }
+  }
+
+  // Pairs of cores hand off aBuffer-block buffers: the producer writes the
+  // whole buffer, then the consumer reads it, then they move to the next one
+  void producerConsumer(uint64_t aLength, uint64_t aBuffer, trace_t & aTrace) {
+    int32_t pairs = std::max(theCores / 2, 1);
+    uint64_t slice = theFootprint / pairs;
+    uint64_t buffers = std::max<uint64_t>(slice / aBuffer, 1);
+    std::vector<uint64_t> position(pairs, 0);
+    for (uint64_t i = 0; i < aLength; ++i) {
+      int32_t pair = i % pairs;
+      uint64_t step = position[pair]++;
+      uint64_t buffer = (step / (2 * aBuffer)) % buffers;
+      bool produce = ((step / aBuffer) & 1) == 0;
+      int32_t core = (2 * pair + (produce ? 0 : 1)) % theCores;
+      Access access = { address(pair * slice + buffer * aBuffer + step % aBuffer), core, produce };
+      aTrace.push_back(access);
+    }
+  }
+};
+
+} // namespace nBench
+
+#endif //FLEXUS_BENCH_ADDRESS_STREAMS_HPP_INCLUDED
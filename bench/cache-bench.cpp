@@ -0,0 +1,560 @@
+// DO-NOT-REMOVE begin-copyright-block 
+//QFlex consists of several software components that are governed by various
+//licensing terms, in addition to software that was developed internally.
+//Anyone interested in using QFlex needs to fully understand and abide by the
+//licenses governing all the software components.
+//
+//### Software developed externally (not by the QFlex group)
+//
+//    * [NS-3](https://www.gnu.org/copyleft/gpl.html)
+//    * [QEMU](http://wiki.qemu.org/License) 
+//    * [SimFlex] (http://parsa.epfl.ch/simflex/)
+//
+//Software developed internally (by the QFlex group)
+//**QFlex License**
+//
+//QFlex
+//Copyright (c) 2016, Parallel Systems Architecture Lab, EPFL
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//    * Neither the name of the Parallel Systems Architecture Laboratory, EPFL,
+//      nor the names of its contributors may be used to endorse or promote
+//      products derived from this software without specific prior written
+//      permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE PARALLEL SYSTEMS ARCHITECTURE LABORATORY,
+//EPFL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+//GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+//LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+//THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// DO-NOT-REMOVE end-copyright-block   
+// Microbenchmarks for the FastCMPCache structures: caches, directories,
+// sharing vectors and the protocol table, plus StatCounter updates.  Each is
+// driven by synthetic reference streams and reports lookups per second and
+// heap bytes per entry.  Runs without QEMU, so changes to these structures
+// can be compared on their own.
+
+#include <malloc.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <deque>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <new>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+
+#include <core/stats.hpp>
+
+#include <components/CommonQEMU/Slices/MemoryMessage.hpp>
+#include <components/CommonQEMU/Slices/RegionScoutMessage.hpp>
+
+#include <components/FastCMPCache/AbstractProtocol.hpp>
+#include <components/FastCMPCache/AbstractDirectory.hpp>
+#include <components/FastCMPCache/AbstractCache.hpp>
+#include <components/FastCMPCache/RTCache.hpp>
+#include <components/FastCMPCache/StdCache.hpp>
+
+#include <bench/AddressStreams.hpp>
+
+namespace Flexus {
+namespace Core {
+void Break() {}
+} }
+
+// Live heap bytes, so each structure's footprint can be measured
+static int64_t theHeapBytes = 0;
+
+void * operator new(std::size_t aSize) {
+  void * ptr = std::malloc(aSize ? aSize : 1);
+  if (! ptr) {
+    throw std::bad_alloc();
+  }
+  theHeapBytes += malloc_usable_size(ptr);
+  return ptr;
+}
+
+void * operator new[](std::size_t aSize) {
+  return operator new(aSize);
+}
+
+void operator delete(void * aPtr) noexcept {
+  if (aPtr) {
+    theHeapBytes -= malloc_usable_size(aPtr);
+    std::free(aPtr);
+  }
+}
+
+void operator delete[](void * aPtr) noexcept {
+  operator delete(aPtr);
+}
+
+void operator delete(void * aPtr, std::size_t) noexcept {
+  operator delete(aPtr);
+}
+
+void operator delete[](void * aPtr, std::size_t) noexcept {
+  operator delete(aPtr);
+}
+
+namespace nBench {
+
+using namespace nFastCMPCache;
+namespace Stat = Flexus::Stat;
+
+typedef MemoryMessage::MemoryMessageType MMType;
+
+struct Config {
+  uint64_t theAccesses;
+  uint64_t theFootprint;
+  int32_t theCores;
+  std::string theFilter;
+};
+
+// A request as the directory sees it: private-cache misses, upgrades and
+// evictions, with private-cache hits filtered out
+struct DirectoryOp {
+  uint64_t theAddress;
+  int32_t theCore;
+  MMType theType;
+};
+
+template <class Fn>
+double timed(Fn aFn) {
+  std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+  aFn();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+class Bench {
+  Config theConfig;
+  std::string theStream;
+  trace_t theTrace;
+  uint64_t theDistinctBlocks;
+  std::vector<DirectoryOp> theDirectoryOps;
+  uint64_t theResidentBlocks;
+  std::vector<Stat::StatCounter *> theCounters; //Stats are never unregistered, so these live forever
+  uint64_t theSink;
+
+  // Blocks each private cache holds, by Tagless directory set, to answer the
+  // set-tag probes the Tagless directory sends on every sharer removal
+  std::vector< std::vector<uint64_t> > thePrivateTags;
+  bool theTracksTags;
+
+  static const uint64_t kCacheSize = 1024 * 1024;
+  static const int32_t kBlockSize = 64;
+  static const int32_t kAssoc = 16;
+  static const size_t kPrivateBlocks = 4096;
+  static const int32_t kTaglessSets = 1024;
+
+public:
+  Bench(Config const & aConfig)
+    : theConfig(aConfig)
+    , theDistinctBlocks(0)
+    , theResidentBlocks(0)
+    , theSink(0)
+    , theTracksTags(false)
+  { }
+
+  void run() {
+    std::printf("%-12s %-18s %10s %12s %10s %12s\n", "structure", "stream", "ops", "Mlookups/s", "entries", "bytes/entry");
+    AddressStreams streams(theConfig.theFootprint, theConfig.theCores, 1);
+    for (std::string const & stream : AddressStreams::names()) {
+      theStream = stream;
+      streams.generate(stream, theConfig.theAccesses, theTrace);
+      countDistinctBlocks();
+      generateDirectoryOps();
+
+      if (selected("StdCache")) benchStdCache();
+      if (selected("RTCache")) benchRTCache();
+      if (selected("Infinite")) benchDirectory("Infinite", "Infinite", 0);
+      if (selected("Standard")) benchDirectory("Standard", "Standard:sets=8192:assoc=16", 8192 * 16);
+      if (selected("Tagless")) benchDirectory("Tagless", "Tagless:sets=" + std::to_string(kTaglessSets) + ":buckets=64:hash=simple:hash=xor", 0);
+      if (selected("SharingVec")) benchSharingVector();
+      if (selected("Protocol")) benchProtocol();
+      if (selected("StatCounter")) benchStatCounter();
+    }
+    if (theSink == 42) {
+      std::printf("\n");
+    }
+  }
+
+private:
+  bool selected(std::string const & aStructure) const {
+    return theConfig.theFilter.empty() || aStructure.find(theConfig.theFilter) != std::string::npos;
+  }
+
+  std::string statName(std::string const & aStructure) const {
+    return "bench-" + aStructure + "-" + theStream;
+  }
+
+  void report(std::string const & aStructure, uint64_t anOps, double aSeconds, uint64_t anEntries, int64_t aBytes) {
+    std::printf("%-12s %-18s %10llu %12.2f ", aStructure.c_str(), theStream.c_str(), static_cast<unsigned long long>(anOps), anOps / aSeconds / 1e6);
+    if (anEntries > 0) {
+      std::printf("%10llu %12.1f\n", static_cast<unsigned long long>(anEntries), static_cast<double>(aBytes) / anEntries);
+    } else {
+      std::printf("%10s %12s\n", "-", "-");
+    }
+    std::fflush(stdout);
+  }
+
+  void countDistinctBlocks() {
+    std::unordered_set<uint64_t> blocks;
+    for (Access const & access : theTrace) {
+      blocks.insert(access.theAddress);
+    }
+    theDistinctBlocks = blocks.size();
+  }
+
+  // Filter the trace through per-core FIFO private caches of kPrivateBlocks
+  // blocks, with invalidate-on-write, to get the directory's request stream
+  void generateDirectoryOps() {
+    struct Residency {
+      uint64_t theSharers;
+      bool theExclusive;
+    };
+    std::unordered_map<uint64_t, Residency> blocks;
+    std::vector< std::deque<uint64_t> > fifos(theConfig.theCores);
+
+    theDirectoryOps.clear();
+    for (Access const & access : theTrace) {
+      uint64_t bit = 1ULL << access.theCore;
+      Residency & block = blocks[access.theAddress];
+      bool was_resident = block.theSharers & bit;
+      if (! access.theWrite) {
+        if (was_resident) {
+          continue;
+        }
+        DirectoryOp op = { access.theAddress, access.theCore, MemoryMessage::ReadReq };
+        theDirectoryOps.push_back(op);
+        block.theExclusive = (block.theSharers == 0);
+        block.theSharers |= bit;
+      } else {
+        if (block.theSharers == bit && block.theExclusive) {
+          continue;
+        }
+        DirectoryOp op = { access.theAddress, access.theCore, was_resident ? MemoryMessage::UpgradeReq : MemoryMessage::WriteReq };
+        theDirectoryOps.push_back(op);
+        block.theSharers = bit;
+        block.theExclusive = true;
+      }
+      if (was_resident) {
+        continue;
+      }
+
+      std::deque<uint64_t> & fifo = fifos[access.theCore];
+      fifo.push_back(access.theAddress);
+      if (fifo.size() > kPrivateBlocks) {
+        uint64_t victim = fifo.front();
+        fifo.pop_front();
+        Residency & evicted = blocks[victim];
+        if (evicted.theSharers & bit) {
+          DirectoryOp op = { victim, access.theCore, MemoryMessage::EvictClean };
+          theDirectoryOps.push_back(op);
+          evicted.theSharers &= ~bit;
+        }
+      }
+    }
+
+    theResidentBlocks = 0;
+    for (auto const & block : blocks) {
+      if (block.second.theSharers != 0) {
+        ++theResidentBlocks;
+      }
+    }
+  }
+
+  static void touch(AbstractCache & aCache, Access const & anAccess) {
+    LookupResult_p result = aCache.lookup(anAccess.theAddress);
+    if (result->getState() == kInvalid) {
+      result->allocate(anAccess.theWrite ? kModified : kExclusive);
+    } else if (anAccess.theWrite) {
+      result->changeState(kModified, true, false);
+    } else {
+      result->updateLRU();
+    }
+  }
+
+  // Warm the cache with one pass over the trace, then time a second pass
+  void benchCache(std::string const & aStructure, std::function<AbstractCache* ()> aFactory) {
+    int64_t heap = theHeapBytes;
+    std::unique_ptr<AbstractCache> cache(aFactory());
+    for (Access const & access : theTrace) {
+      touch(*cache, access);
+    }
+    int64_t bytes = theHeapBytes - heap;
+
+    double seconds = timed([&]() {
+      for (Access const & access : theTrace) {
+        touch(*cache, access);
+      }
+    });
+    report(aStructure, theTrace.size(), seconds, std::min<uint64_t>(theDistinctBlocks, kCacheSize / kBlockSize), bytes);
+  }
+
+  void benchStdCache() {
+    benchCache("StdCache", [this]() {
+      return new StdCache(statName("StdCache"), kBlockSize, kCacheSize / kBlockSize / kAssoc, kAssoc,
+                          [](uint64_t, CoherenceState_t) {},
+                          [](uint64_t, bool, bool) { return false; },
+                          0, Flexus::SharedTypes::eL2, "LRU");
+    });
+  }
+
+  void benchRTCache() {
+    benchCache("RTCache", [this]() {
+      std::string policy("SetLRU");
+      return new RTCache(statName("RTCache"), kBlockSize, kCacheSize / kBlockSize / kAssoc, kAssoc,
+                         [](uint64_t, CoherenceState_t) {},
+                         [](uint64_t, int32_t) {},
+                         [](uint64_t, bool, bool) { return false; },
+                         0, Flexus::SharedTypes::eL2, 1024, 16, 2048, 8, false, policy);
+    });
+  }
+
+  std::vector<uint64_t> & privateTags(int32_t aCore, uint64_t anAddress) {
+    return thePrivateTags[aCore * kTaglessSets + ((anAddress >> kBlockShift) & (kTaglessSets - 1))];
+  }
+
+  void addPrivateTag(int32_t aCore, uint64_t anAddress) {
+    if (theTracksTags) {
+      privateTags(aCore, anAddress).push_back(anAddress);
+    }
+  }
+
+  void removePrivateTag(int32_t aCore, uint64_t anAddress) {
+    if (theTracksTags) {
+      std::vector<uint64_t> & tags = privateTags(aCore, anAddress);
+      std::vector<uint64_t>::iterator iter = std::find(tags.begin(), tags.end(), anAddress);
+      if (iter != tags.end()) {
+        *iter = tags.back();
+        tags.pop_back();
+      }
+    }
+  }
+
+  void answerProbe(RegionScoutMessage & aMessage, int32_t aCore) {
+    if (theTracksTags && aMessage.type() == RegionScoutMessage::eSetTagProbe) {
+      for (uint64_t tag : privateTags(aCore, aMessage.region())) {
+        aMessage.addTag(PhysicalMemoryAddress(tag));
+      }
+    }
+  }
+
+  void directoryOp(AbstractDirectory & aDirectory, DirectoryOp const & anOp) {
+    SharingVector sharers;
+    SharingState state;
+    AbstractEntry_p entry;
+    std::list<std::function<void(void)> > extra_actions;
+    PhysicalMemoryAddress address(anOp.theAddress);
+
+    std::tie(sharers, state, entry) = aDirectory.lookup(anOp.theCore, address, anOp.theType, extra_actions);
+
+    MMType response = anOp.theType;
+    switch (anOp.theType) {
+      case MemoryMessage::ReadReq:
+        response = MemoryMessage::MissReplyWritable;
+        if (state != ZeroSharers) {
+          int32_t owner = sharers.getFirstSharer();
+          if (owner >= 0 && owner != anOp.theCore) {
+            aDirectory.processSnoopResponse(owner, MemoryMessage::ReturnReply, entry, address);
+          }
+          response = MemoryMessage::MissReply;
+        }
+        break;
+      case MemoryMessage::WriteReq:
+      case MemoryMessage::UpgradeReq:
+        for (int32_t sharer : sharers.toList()) {
+          if (sharer != anOp.theCore) {
+            removePrivateTag(sharer, anOp.theAddress);
+            aDirectory.processSnoopResponse(sharer, MemoryMessage::InvalidateAck, entry, address);
+          }
+        }
+        response = (anOp.theType == MemoryMessage::WriteReq) ? MemoryMessage::MissReplyWritable : MemoryMessage::UpgradeReply;
+        break;
+      default:
+        break;
+    }
+    if (anOp.theType == MemoryMessage::EvictClean) {
+      removePrivateTag(anOp.theCore, anOp.theAddress);
+    } else if (anOp.theType != MemoryMessage::UpgradeReq) {
+      addPrivateTag(anOp.theCore, anOp.theAddress);
+    }
+
+    while (! extra_actions.empty()) {
+      extra_actions.front()();
+      extra_actions.pop_front();
+    }
+    aDirectory.processRequestResponse(anOp.theCore, anOp.theType, response, entry, address, state == ZeroSharers);
+    aDirectory.updateLRU(anOp.theCore, entry, address);
+  }
+
+  AbstractDirectory * createDirectory(std::string const & aStructure, std::string const & aSpec) {
+    AbstractDirectory * directory = CREATE_DIRECTORY(aSpec);
+    directory->setNumCores(theConfig.theCores);
+    directory->setNumCaches(theConfig.theCores);
+    directory->setBlockSize(kBlockSize);
+    directory->setPortOperations( [this](RegionScoutMessage & aMessage, int32_t aCore) { answerProbe(aMessage, aCore); },
+                                  [](std::function<void(void)> aFn) { aFn(); } );
+    directory->setInvalidateAction( [](PhysicalMemoryAddress, SharingVector) {} );
+    directory->initialize(statName(aStructure));
+    return directory;
+  }
+
+  // A fresh directory replays the filtered request stream; the replay is
+  // timed.  Bounded directories count their capacity as entries, unbounded
+  // ones the blocks still cached when the stream ends.  Tagless times
+  // include answering its probes, as the private caches do in a simulation.
+  void benchDirectory(std::string const & aStructure, std::string const & aSpec, uint64_t aCapacity) {
+    theTracksTags = (aStructure == "Tagless");
+    thePrivateTags.assign(theTracksTags ? theConfig.theCores * kTaglessSets : 0, std::vector<uint64_t>());
+
+    int64_t heap = theHeapBytes;
+    std::unique_ptr<AbstractDirectory> directory(createDirectory(aStructure, aSpec));
+    double seconds = timed([&]() {
+      for (DirectoryOp const & op : theDirectoryOps) {
+        directoryOp(*directory, op);
+      }
+    });
+    int64_t bytes = theHeapBytes - heap;
+    if (theTracksTags) {
+      for (std::vector<uint64_t> const & tags : thePrivateTags) {
+        if (tags.capacity() > 0) {
+          bytes -= malloc_usable_size(const_cast<uint64_t *>(tags.data()));
+        }
+      }
+    }
+    report(aStructure, theDirectoryOps.size(), seconds, aCapacity ? aCapacity : theResidentBlocks, bytes);
+  }
+
+  void benchSharingVector() {
+    uint64_t entries = std::min<uint64_t>(theConfig.theFootprint, 65536);
+    int64_t heap = theHeapBytes;
+    std::vector<SharingVector> vectors(entries);
+    int64_t bytes = theHeapBytes - heap;
+
+    double seconds = timed([&]() {
+      for (Access const & access : theTrace) {
+        SharingVector & sharers = vectors[(access.theAddress >> kBlockShift) & (entries - 1)];
+        if (access.theWrite) {
+          theSink += sharers.toList().size();
+          sharers.clear();
+          sharers.addSharer(access.theCore);
+        } else {
+          if (! sharers.isSharer(access.theCore)) {
+            sharers.addSharer(access.theCore);
+          }
+          theSink += sharers.countSharers() + sharers.getFirstSharer();
+        }
+      }
+    });
+    report("SharingVec", theTrace.size(), seconds, entries, bytes);
+  }
+
+  // Looks up every (cache state, sharing state, request) combination the
+  // SingleCMP protocol defines for reads, fetches and writes
+  void benchProtocol() {
+    static const CoherenceState_t kCacheStates[4] = { kInvalid, kShared, kExclusive, kModified };
+    static const SharingState kSharingStates[3] = { ZeroSharers, OneSharer, ManySharers };
+
+    std::unique_ptr<AbstractProtocol> protocol(CREATE_PROTOCOL("SingleCMP"));
+    double seconds = timed([&]() {
+      for (Access const & access : theTrace) {
+        uint64_t hash = (access.theAddress >> kBlockShift) ^ access.theCore;
+        MMType type = access.theWrite ? MemoryMessage::WriteReq : ((hash & 0x10) ? MemoryMessage::FetchReq : MemoryMessage::ReadReq);
+        PhysicalMemoryAddress address(access.theAddress);
+        PrimaryAction const & action = protocol->getAction(kCacheStates[hash & 3], kSharingStates[(hash >> 2) % 3], type, address);
+        theSink += action.allocate;
+      }
+    });
+    report("Protocol", theTrace.size(), seconds, 0, 0);
+  }
+
+  // A hit and a miss counter per core, updated through the "all" and
+  // "bench" measurements
+  void benchStatCounter() {
+    int64_t heap = theHeapBytes;
+    size_t first = theCounters.size();
+    for (int32_t i = 0; i < 2 * theConfig.theCores; ++i) {
+      theCounters.push_back(new Stat::StatCounter(statName("StatCounter") + "-" + std::to_string(i)));
+    }
+    int64_t bytes = theHeapBytes - heap;
+    Stat::StatCounter ** counters = &theCounters[first];
+
+    double seconds = timed([&]() {
+      for (Access const & access : theTrace) {
+        Stat::StatCounter & counter = *counters[2 * access.theCore + access.theWrite];
+        ++counter;
+        counter += kBlockSize;
+      }
+    });
+    report("StatCounter", theTrace.size(), seconds, 2 * theConfig.theCores, bytes);
+  }
+};
+
+} // namespace nBench
+
+void usage() {
+  std::cout << "Usage: cache-bench [-n accesses] [-f footprint-blocks] [-c cores] [structure]" << std::endl;
+  std::cout << "  structure: StdCache, RTCache, Infinite, Standard, Tagless, SharingVec, Protocol or StatCounter" << std::endl;
+}
+
+int main(int argc, char ** argv) {
+  nBench::Config config;
+  config.theAccesses = 1 << 21;
+  config.theFootprint = 1 << 18;
+  config.theCores = 16;
+
+  for (int32_t i = 1; i < argc; ++i) {
+    std::string arg(argv[i]);
+    if ((arg == "-n" || arg == "-f" || arg == "-c") && i + 1 < argc) {
+      uint64_t value = std::strtoull(argv[++i], nullptr, 0);
+      if (arg == "-n") {
+        config.theAccesses = value;
+      } else if (arg == "-f") {
+        config.theFootprint = value;
+      } else {
+        config.theCores = value;
+      }
+    } else if (arg[0] != '-' && config.theFilter.empty()) {
+      config.theFilter = arg;
+    } else {
+      usage();
+      return 1;
+    }
+  }
+  if (config.theCores < 2 || config.theCores > 64 || (config.theFootprint & (config.theFootprint - 1)) != 0 || config.theFootprint < 1024) {
+    std::cout << "Cores must be 2-64 and the footprint a power of two of at least 1024 blocks" << std::endl;
+    return 1;
+  }
+
+  Flexus::Stat::getStatManager()->initialize();
+  Flexus::Stat::getStatManager()->openMeasurement("bench");
+
+  nBench::Bench(config).run();
+  return 0;
+}
@@ -43,6 +43,7 @@
 
 COMPONENT_PARAMETERS(
   PARAMETER( Cores, int, "Number of cores", "cores", 1 )
+  PARAMETER( Predictor, std::string, "Branch predictor type (Combining | TAGE)", "predictor", "Combining" )
 );
 
 typedef std::pair< uint64_t, uint32_t> ulong_pair;
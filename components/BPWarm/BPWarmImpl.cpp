@@ -55,6 +55,10 @@ class FLEXUS_COMPONENT(BPWarm) {
   FLEXUS_COMPONENT_IMPL(BPWarm);
 
   std::unique_ptr<FastBranchPredictor> theBranchPredictor;
+  std::string thePredictorType;
+  //Predictors replaced by reconfigure(); kept because the StatManager still
+  //refers to their stats
+  std::vector< std::unique_ptr<FastBranchPredictor> > theRetiredPredictors;
 
   std::vector< std::vector< VirtualMemoryAddress > > theFetchAddress;
   std::vector< std::vector< BPredState > >           theFetchState;
@@ -167,7 +171,32 @@ public:
       theOne[i] = false;
     }
 
-    theBranchPredictor.reset( FastBranchPredictor::combining(statName(), flexusIndex()) );
+    createPredictor();
+  }
+
+  void createPredictor() {
+    if (cfg.Predictor == "Combining") {
+      theBranchPredictor.reset( FastBranchPredictor::combining(statName(), flexusIndex()) );
+    } else if (cfg.Predictor == "TAGE") {
+      theBranchPredictor.reset( FastBranchPredictor::tage(statName(), flexusIndex()) );
+    } else {
+      DBG_Assert( false, ( << "Unknown branch predictor type: " << cfg.Predictor ) );
+    }
+    thePredictorType = cfg.Predictor;
+  }
+
+  bool isReconfigurable(std::string const & aSwitch) const {
+    return aSwitch == "predictor";
+  }
+
+  //A different predictor type has no warmed state to inherit, so it starts
+  //cold in the reconfigured copy
+  void reconfigure() {
+    if (cfg.Predictor != thePredictorType) {
+      DBG_( Crit, ( << statName() << " switching from " << thePredictorType << " to a cold " << cfg.Predictor << " predictor" ) );
+      theRetiredPredictors.push_back( std::move(theBranchPredictor) );
+      createPredictor();
+    }
   }
 
   void finalize() {}
@@ -184,6 +213,11 @@ public:
     theBranchPredictor->loadState(aDirName);
   }
 
+  //Each predictor reads only its own bpred file
+  bool loadsIndependently() const {
+    return true;
+  }
+
 public:
   ///////////////// InsnIn port
   bool available( interface::InsnIn const &,
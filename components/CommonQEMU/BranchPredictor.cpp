@@ -46,6 +46,7 @@
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
 
+#include <algorithm>
 #include <list>
 #include <iostream>
 #include <iomanip>
@@ -58,12 +59,6 @@
 
 #include <boost/dynamic_bitset.hpp>
 
-#include <boost/multi_index_container.hpp>
-#include <boost/multi_index/member.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index/sequenced_index.hpp>
-using namespace boost::multi_index;
-
 #include <core/target.hpp>
 #include <core/debug/debug.hpp>
 #include <core/types.hpp>
@@ -71,6 +66,7 @@ using namespace boost::multi_index;
 
 #include <boost/serialization/serialization.hpp>
 #include <boost/serialization/tracking.hpp>
+#include <boost/serialization/split_member.hpp>
 #include <boost/serialization/list.hpp>
 #include <boost/serialization/vector.hpp>
 #include <boost/serialization/export.hpp>
@@ -89,8 +85,8 @@ namespace SharedTypes {
 
 struct BTBEntry {
   VirtualMemoryAddress thePC;
-  mutable eBranchType theBranchType;
-  mutable VirtualMemoryAddress theTarget;
+  eBranchType theBranchType;
+  VirtualMemoryAddress theTarget;
   BTBEntry( VirtualMemoryAddress aPC, eBranchType aType, VirtualMemoryAddress aTarget)
     : thePC( aPC )
     , theBranchType( aType )
@@ -108,31 +104,21 @@ private:
 
 };
 
-struct by_baddr {};
-typedef multi_index_container
-< BTBEntry
-, indexed_by
-< sequenced<>
-, ordered_unique
-< tag<by_baddr>
-, member< BTBEntry, VirtualMemoryAddress, &BTBEntry::thePC>
->
->
->
-btb_set_t;
+//Flexpoint image of one BTB set, least recently used entry first.  The flat
+//BTB below converts to and from this form so that flexpoints written by the
+//old multi_index BTB remain loadable (and vice versa).
+struct BTBSetImage {
+  std::list<BTBEntry> theEntries;
+};
 
 template<class Archive>
-void save(Archive & ar, const btb_set_t & t, uint32_t version) {
-  std::list<BTBEntry> btb;
-  std::copy( t.begin(), t.end(), std::back_inserter(btb));
+void save(Archive & ar, const BTBSetImage & t, uint32_t version) {
   // the hackish const is necessary to satisfy boost 1.33.1
-  ar << (const std::list<BTBEntry>)btb;
+  ar << (const std::list<BTBEntry>)t.theEntries;
 }
 template<class Archive>
-void load(Archive & ar, btb_set_t & t, uint32_t version) {
-  std::list<BTBEntry> btb;
-  ar >> btb;
-  std::copy( btb.begin(), btb.end(), std::back_inserter(t));
+void load(Archive & ar, BTBSetImage & t, uint32_t version) {
+  ar >> t.theEntries;
 }
 
 } //SharedTypes
@@ -141,7 +127,7 @@ void load(Archive & ar, btb_set_t & t, uint32_t version) {
 namespace boost {
 namespace serialization {
 template<class Archive>
-inline void serialize( Archive & ar, Flexus::SharedTypes::btb_set_t & t, const uint32_t file_version ) {
+inline void serialize( Archive & ar, Flexus::SharedTypes::BTBSetImage & t, const uint32_t file_version ) {
   split_free(ar, t, file_version);
 }
 }
@@ -192,8 +178,29 @@ eDirection reverse(eDirection direction) {
   return direction;
 }
 
+//Direction tables hold one 2-bit saturating counter per byte, encoded exactly
+//like eDirection.  Flexpoints store them as eDirection vectors.
+typedef std::vector< uint8_t > counter_table_t;
+
+std::vector< eDirection > toDirections( counter_table_t const & aTable ) {
+  std::vector< eDirection > directions;
+  directions.reserve(aTable.size());
+  for (uint8_t counter : aTable) {
+    directions.push_back( eDirection(counter) );
+  }
+  return directions;
+}
+
+void fromDirections( std::vector< eDirection > const & aDirections, counter_table_t & aTable ) {
+  aTable.clear();
+  aTable.reserve(aDirections.size());
+  for (eDirection direction : aDirections) {
+    aTable.push_back( static_cast<uint8_t>(direction) );
+  }
+}
+
 struct gShare {
-  std::vector< eDirection > thePatternTable;
+  counter_table_t thePatternTable;
   uint32_t theShiftReg;
   int32_t theShiftRegSize;
   uint32_t thePatternMask;
@@ -201,14 +208,26 @@ struct gShare {
 private:
   friend class boost::serialization::access;
   template<class Archive>
-  void serialize(Archive & ar, const uint32_t version) {
+  void save(Archive & ar, const uint32_t version) const {
+    const std::vector< eDirection > pattern_table( toDirections(thePatternTable) );
     uint32_t shift_reg = theShiftReg;
-    ar & thePatternTable;
-    ar & theShiftRegSize;
-    ar & thePatternMask;
-    ar & shift_reg;
+    ar << pattern_table;
+    ar << theShiftRegSize;
+    ar << thePatternMask;
+    ar << shift_reg;
+  }
+  template<class Archive>
+  void load(Archive & ar, const uint32_t version) {
+    std::vector< eDirection > pattern_table;
+    uint32_t shift_reg;
+    ar >> pattern_table;
+    ar >> theShiftRegSize;
+    ar >> thePatternMask;
+    ar >> shift_reg;
+    fromDirections(pattern_table, thePatternTable);
     theShiftReg = (theShiftReg & theShiftRegSize );
   }
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
   gShare( ) {}
 
 public:
@@ -256,11 +275,11 @@ public:
   }
 
   eDirection direction( VirtualMemoryAddress anAddress) {
-    return thePatternTable[index(anAddress)];
+    return eDirection(thePatternTable[index(anAddress)]);
   }
 
   eDirection direction ( VirtualMemoryAddress anAddress, uint32_t aShiftRegState ) {
-    return thePatternTable[index(anAddress, aShiftRegState)];
+    return eDirection(thePatternTable[index(anAddress, aShiftRegState)]);
   }
 
   void update(VirtualMemoryAddress anAddress, eDirection aDirection) {
@@ -274,18 +293,28 @@ public:
 };
 
 struct Bimodal {
-  std::vector< eDirection > theTable;
+  counter_table_t theTable;
   int32_t theSize;
   uint64_t theIndexMask;
 
 private:
   friend class boost::serialization::access;
   template<class Archive>
-  void serialize(Archive & ar, const uint32_t version) {
-    ar & theTable;
-    ar & theSize;
-    ar & theIndexMask;
+  void save(Archive & ar, const uint32_t version) const {
+    const std::vector< eDirection > table( toDirections(theTable) );
+    ar << table;
+    ar << theSize;
+    ar << theIndexMask;
+  }
+  template<class Archive>
+  void load(Archive & ar, const uint32_t version) {
+    std::vector< eDirection > table;
+    ar >> table;
+    ar >> theSize;
+    ar >> theIndexMask;
+    fromDirections(table, theTable);
   }
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
   Bimodal( ) {}
 
 public:
@@ -314,7 +343,7 @@ public:
   }
 
   eDirection direction( VirtualMemoryAddress anAddress) {
-    return theTable[index(anAddress)];
+    return eDirection(theTable[index(anAddress)]);
   }
 
   void update(VirtualMemoryAddress anAddress, eDirection aDirection) {
@@ -322,81 +351,213 @@ public:
   }
 };
 
+//Flat set-associative BTB.  Every way packs its tag and branch type into one
+//word (kNonBranch marks an invalid way), with targets in a parallel array.
+//Recency is a 4-bit age per way, packed into one word per set, with age 0
+//being the most recently used way.  Ages within a set always form a
+//permutation of 0..assoc-1, so replacement is exact LRU.
 struct BTB {
-  std::vector< btb_set_t > theBTB;
+  std::vector< uint64_t > theTags;
+  std::vector< uint64_t > theTargets;
+  std::vector< uint64_t > theAges;
   uint32_t theBTBSets;
   uint32_t theBTBAssoc;
   uint64_t theIndexMask;
+  uint32_t theIndexBits;
+
+  static const uint32_t kTypeBits = 3;
+  static const uint64_t kTypeMask = ( 1ULL << kTypeBits ) - 1;
+  static const uint32_t kAgeBits = 4;
+  static const uint64_t kAgeMask = ( 1ULL << kAgeBits ) - 1;
 
 private:
   friend class boost::serialization::access;
   template<class Archive>
-  void serialize(Archive & ar, const uint32_t version) {
-    ar & theBTB;
-    ar & theBTBSets;
-    ar & theBTBAssoc;
-    ar & theIndexMask;
+  void save(Archive & ar, const uint32_t version) const {
+    std::vector< BTBSetImage > image( theBTBSets );
+    for (uint32_t set = 0; set < theBTBSets; ++set) {
+      //Emit valid ways from least to most recently used
+      for (int32_t age = theBTBAssoc - 1; age >= 0; --age) {
+        uint32_t entry = set * theBTBAssoc + wayOfAge(set, age);
+        if ( (theTags[entry] & kTypeMask) != kNonBranch ) {
+          image[set].theEntries.push_back( BTBEntry( entryPC(set, theTags[entry]), eBranchType(theTags[entry] & kTypeMask), VirtualMemoryAddress(theTargets[entry]) ) );
+        }
+      }
+    }
+    const std::vector< BTBSetImage > & const_image = image;
+    ar << const_image;
+    ar << theBTBSets;
+    ar << theBTBAssoc;
+    ar << theIndexMask;
   }
+  template<class Archive>
+  void load(Archive & ar, const uint32_t version) {
+    std::vector< BTBSetImage > image;
+    ar >> image;
+    ar >> theBTBSets;
+    ar >> theBTBAssoc;
+    ar >> theIndexMask;
+    DBG_Assert( image.size() == theBTBSets );
+    resize();
+    for (uint32_t set = 0; set < theBTBSets; ++set) {
+      std::list<BTBEntry>::iterator iter = image[set].theEntries.begin();
+      for (; iter != image[set].theEntries.end(); ++iter) {
+        update( iter->thePC, iter->theBranchType, iter->theTarget );
+      }
+    }
+  }
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
   BTB() {}
 
+  void resize() {
+    //Packing the type below the tag steals kTypeBits high bits from the PC,
+    //which are recovered from the set index.
+    DBG_Assert( ((theBTBSets - 1) & (theBTBSets)) == 0);
+    DBG_Assert( theBTBSets >= ( 1U << kTypeBits ) );
+    DBG_Assert( theBTBAssoc > 0 && theBTBAssoc <= ( 1U << kAgeBits ), ( << "BTB associativity " << theBTBAssoc << " exceeds the packed LRU width" ) );
+    theIndexMask = theBTBSets - 1;
+    theIndexBits = log2(theBTBSets);
+    theTags.assign( theBTBSets * theBTBAssoc, 0 );
+    theTargets.assign( theBTBSets * theBTBAssoc, 0 );
+    uint64_t ages = 0;
+    for (uint32_t way = 0; way < theBTBAssoc; ++way) {
+      ages |= static_cast<uint64_t>(way) << (way * kAgeBits);
+    }
+    theAges.assign( theBTBSets, ages );
+  }
+
+  uint64_t packedTag( VirtualMemoryAddress anAddress, eBranchType aType ) const {
+    uint64_t pc = anAddress;
+    uint64_t tag = ( ( pc >> (theIndexBits + 2) ) << 2 ) | ( pc & 3 );
+    return ( tag << kTypeBits ) | aType;
+  }
+
+  VirtualMemoryAddress entryPC( uint32_t aSet, uint64_t aPackedTag ) const {
+    uint64_t tag = aPackedTag >> kTypeBits;
+    return VirtualMemoryAddress( ( ( tag >> 2 ) << (theIndexBits + 2) ) | ( static_cast<uint64_t>(aSet) << 2 ) | ( tag & 3 ) );
+  }
+
+  uint32_t age( uint32_t aSet, uint32_t aWay ) const {
+    return ( theAges[aSet] >> (aWay * kAgeBits) ) & kAgeMask;
+  }
+
+  uint32_t wayOfAge( uint32_t aSet, uint32_t anAge ) const {
+    for (uint32_t way = 0; way < theBTBAssoc; ++way) {
+      if (age(aSet, way) == anAge) {
+        return way;
+      }
+    }
+    DBG_Assert( false, ( << "BTB set " << aSet << " has no way of age " << anAge ) );
+    return 0;
+  }
+
+  //Make aWay the most recently used way, aging every way younger than it
+  void touch( uint32_t aSet, uint32_t aWay ) {
+    uint64_t ages = theAges[aSet];
+    uint64_t old_age = ( ages >> (aWay * kAgeBits) ) & kAgeMask;
+    for (uint32_t way = 0; way < theBTBAssoc; ++way) {
+      if ( ( ( ages >> (way * kAgeBits) ) & kAgeMask ) < old_age ) {
+        ages += 1ULL << (way * kAgeBits);
+      }
+    }
+    theAges[aSet] = ages & ~( kAgeMask << (aWay * kAgeBits) );
+  }
+
+  //Make aWay the least recently used way, rejuvenating every way older than it
+  void demote( uint32_t aSet, uint32_t aWay ) {
+    uint64_t ages = theAges[aSet];
+    uint64_t old_age = ( ages >> (aWay * kAgeBits) ) & kAgeMask;
+    for (uint32_t way = 0; way < theBTBAssoc; ++way) {
+      if ( ( ( ages >> (way * kAgeBits) ) & kAgeMask ) > old_age ) {
+        ages -= 1ULL << (way * kAgeBits);
+      }
+    }
+    ages &= ~( kAgeMask << (aWay * kAgeBits) );
+    theAges[aSet] = ages | ( static_cast<uint64_t>(theBTBAssoc - 1) << (aWay * kAgeBits) );
+  }
+
+  //Returns the way to fill in aSet: an invalid way if there is one, otherwise
+  //the least recently used way
+  uint32_t victim( uint32_t aSet ) const {
+    uint64_t const * tags = &theTags[aSet * theBTBAssoc];
+    for (uint32_t way = 0; way < theBTBAssoc; ++way) {
+      if ( (tags[way] & kTypeMask) == kNonBranch ) {
+        return way;
+      }
+    }
+    return wayOfAge(aSet, theBTBAssoc - 1);
+  }
+
+  //Returns the flat entry index holding anAddress, or -1
+  int32_t find( VirtualMemoryAddress anAddress ) const {
+    uint32_t set = index(anAddress);
+    uint64_t tag = packedTag(anAddress, kNonBranch);
+    uint64_t const * tags = &theTags[set * theBTBAssoc];
+    for (uint32_t way = 0; way < theBTBAssoc; ++way) {
+      if ( (tags[way] & ~kTypeMask) == tag && (tags[way] & kTypeMask) != kNonBranch ) {
+        return set * theBTBAssoc + way;
+      }
+    }
+    return -1;
+  }
+
 public:
   BTB( int32_t aBTBSets, int32_t aBTBAssoc )
     : theBTBSets(aBTBSets)
     , theBTBAssoc(aBTBAssoc) {
     //aBTBSize must be a power of 2
-    DBG_Assert( ((aBTBSets - 1) & (aBTBSets)) == 0);
-    theBTB.resize(aBTBSets);
-    theIndexMask = aBTBSets - 1;
+    resize();
   }
 
-  int32_t index( VirtualMemoryAddress anAddress) {
+  int32_t index( VirtualMemoryAddress anAddress) const {
     // Shift address by 2, since we assume word-aligned PCs
     return (anAddress >> 2) & theIndexMask;
   }
 
-  bool contains(VirtualMemoryAddress anAddress) {
-    return (theBTB[index(anAddress)].get<by_baddr>().count(anAddress) > 0);
+  bool contains(VirtualMemoryAddress anAddress) const {
+    return find(anAddress) >= 0;
   }
 
-  eBranchType type(VirtualMemoryAddress anAddress) {
-    int32_t idx = index(anAddress);
-    btb_set_t::index<by_baddr>::type::iterator iter = theBTB[idx].get<by_baddr>().find(anAddress);
-    if (iter == theBTB[idx].get<by_baddr>().end()) {
+  eBranchType type(VirtualMemoryAddress anAddress) const {
+    int32_t entry = find(anAddress);
+    if (entry < 0) {
       return kNonBranch;
     }
-    return iter->theBranchType;
+    return eBranchType(theTags[entry] & kTypeMask);
   }
 
-  boost::optional<VirtualMemoryAddress> target(VirtualMemoryAddress anAddress) {
-    int32_t idx = index(anAddress);
-    btb_set_t::index<by_baddr>::type::iterator iter = theBTB[idx].get<by_baddr>().find(anAddress);
-    if (iter == theBTB[idx].get<by_baddr>().end() ) {
+  boost::optional<VirtualMemoryAddress> target(VirtualMemoryAddress anAddress) const {
+    int32_t entry = find(anAddress);
+    if (entry < 0) {
       return boost::none;
     }
-    return iter->theTarget;
+    return VirtualMemoryAddress(theTargets[entry]);
   }
 
   bool update( VirtualMemoryAddress aPC, eBranchType aType, VirtualMemoryAddress aTarget) {
-    int32_t idx = index(aPC);
-    btb_set_t::index<by_baddr>::type::iterator iter = theBTB[idx].get<by_baddr>().find(aPC);
-    if (iter != theBTB[idx].get<by_baddr>().end()) {
+    uint32_t set = index(aPC);
+    int32_t entry = find(aPC);
+    if (entry >= 0) {
+      uint32_t way = entry - set * theBTBAssoc;
       if (aType == kNonBranch) {
-        theBTB[idx].get<by_baddr>().erase(iter);
+        theTags[entry] = 0;
+        theTargets[entry] = 0;
+        demote(set, way);
       } else {
-        iter->theBranchType = aType;
+        theTags[entry] = packedTag(aPC, aType);
         if (aTarget) {
           DBG_(Verb, ( << "BTB setting target for " << aPC << " to " << aTarget ) );
-          iter->theTarget = aTarget;
+          theTargets[entry] = aTarget;
         }
-        theBTB[idx].relocate( theBTB[idx].end(), theBTB[idx].project<0>(iter));
+        touch(set, way);
       }
       return false; //not a new entry
     } else if (aType != kNonBranch) {
-      if (theBTB[idx].size() >= theBTBAssoc) {
-        theBTB[idx].pop_front();
-      }
+      uint32_t way = victim(set);
       DBG_(Verb, ( << "BTB adding new branch for " << aPC << " to " << aTarget ) );
-      theBTB[idx].push_back( BTBEntry( aPC, aType, aTarget) );
+      theTags[set * theBTBAssoc + way] = packedTag(aPC, aType);
+      theTargets[set * theBTBAssoc + way] = aTarget;
+      touch(set, way);
       return true; //new entry
     }
     return false; //not a new entry
@@ -509,11 +670,13 @@ struct CombiningImpl : public BranchPredictor {
 
     DBG_ (Verb, ( << theIndex << "-BPRED-COND:  " << aFetch.theAddress << " BIMOD " << bimodal << " GSHARE " << gshare << " META " << meta << " OVERALL " << prediction ) );
 
-    if (prediction <= kTaken && theBTB.target( aFetch.theAddress ) ) {
-      return * theBTB.target(aFetch.theAddress );
-    } else {
-      return VirtualMemoryAddress(0);
+    if (prediction <= kTaken) {
+      boost::optional<VirtualMemoryAddress> target = theBTB.target( aFetch.theAddress );
+      if (target) {
+        return *target;
+      }
     }
+    return VirtualMemoryAddress(0);
   }
 
   VirtualMemoryAddress predict( FetchAddr & aFetch ) {
@@ -537,21 +700,13 @@ struct CombiningImpl : public BranchPredictor {
       case kUnconditional:
         ++thePredictions;
         ++thePredictions_Unconditional;
-        if (theBTB.target(aFetch.theAddress)) {
-          aFetch.theBPState->thePredictedTarget = *theBTB.target(aFetch.theAddress);
-        } else {
-          aFetch.theBPState->thePredictedTarget = VirtualMemoryAddress(0);
-        }
+        aFetch.theBPState->thePredictedTarget = theBTB.target(aFetch.theAddress).get_value_or(VirtualMemoryAddress(0));
         aFetch.theBPState->theGShareShiftReg = theGShare.shiftReg();
         break;
       case kCall:
         ++thePredictions;
         ++thePredictions_Unconditional;
-        if (theBTB.target(aFetch.theAddress)) {
-          aFetch.theBPState->thePredictedTarget = *theBTB.target(aFetch.theAddress);
-        } else {
-          aFetch.theBPState->thePredictedTarget = VirtualMemoryAddress(0);
-        }
+        aFetch.theBPState->thePredictedTarget = theBTB.target(aFetch.theAddress).get_value_or(VirtualMemoryAddress(0));
         aFetch.theBPState->theGShareShiftReg = theGShare.shiftReg();
         //Need to push address onto retstack
         break;
@@ -890,11 +1045,13 @@ struct FastCombiningImpl : public FastBranchPredictor {
 
     DBG_ (Verb, ( << theIndex << "-BPRED-COND:  " << anAddress << " BIMOD " << bimodal << " GSHARE " << gshare << " META " << meta << " OVERALL " << prediction ) );
 
-    if (prediction <= kTaken && theBTB.target( anAddress ) ) {
-      return * theBTB.target(anAddress );
-    } else {
-      return VirtualMemoryAddress(0);
+    if (prediction <= kTaken) {
+      boost::optional<VirtualMemoryAddress> target = theBTB.target( anAddress );
+      if (target) {
+        return *target;
+      }
     }
+    return VirtualMemoryAddress(0);
   }
 
   void predict( VirtualMemoryAddress anAddress, BPredState & aBPState ) {
@@ -917,21 +1074,13 @@ struct FastCombiningImpl : public FastBranchPredictor {
       case kUnconditional:
         ++thePredictions;
         ++thePredictions_Unconditional;
-        if (theBTB.target(anAddress)) {
-          aBPState.thePredictedTarget = *theBTB.target(anAddress);
-        } else {
-          aBPState.thePredictedTarget = VirtualMemoryAddress(0);
-        }
+        aBPState.thePredictedTarget = theBTB.target(anAddress).get_value_or(VirtualMemoryAddress(0));
         aBPState.theGShareShiftReg = theGShare.shiftReg();
         break;
       case kCall:
         ++thePredictions;
         ++thePredictions_Unconditional;
-        if (theBTB.target(anAddress)) {
-          aBPState.thePredictedTarget = *theBTB.target(anAddress);
-        } else {
-          aBPState.thePredictedTarget = VirtualMemoryAddress(0);
-        }
+        aBPState.thePredictedTarget = theBTB.target(anAddress).get_value_or(VirtualMemoryAddress(0));
         aBPState.theGShareShiftReg = theGShare.shiftReg();
         //Need to push address onto retstack
         break;
@@ -1167,6 +1316,671 @@ struct FastCombiningImpl : public FastBranchPredictor {
 
 };
 
+//Global branch history for the TAGE/ITTAGE predictors.  Outcomes live in a
+//circular bit buffer, newest at thePtr, so the history can be far longer than
+//a machine word while shifting in an outcome stays O(1).
+struct TageHistory {
+  static const uint32_t kBufferSize = 256;
+  std::vector< uint8_t > theBits;
+  uint32_t thePtr;
+  uint32_t thePath;
+
+private:
+  friend class boost::serialization::access;
+  template<class Archive>
+  void serialize(Archive & ar, const uint32_t version) {
+    ar & theBits;
+    ar & thePtr;
+    ar & thePath;
+  }
+
+public:
+  TageHistory()
+    : theBits( kBufferSize, 0 )
+    , thePtr(0)
+    , thePath(0)
+  {}
+
+  //Outcome anAge branches ago; 0 is the most recent
+  uint32_t bit( uint32_t anAge ) const {
+    return theBits[ (thePtr + anAge) & (kBufferSize - 1) ];
+  }
+
+  void push( bool anOutcome, VirtualMemoryAddress aPC ) {
+    thePtr = (thePtr - 1) & (kBufferSize - 1);
+    theBits[thePtr] = anOutcome ? 1 : 0;
+    thePath = ( (thePath << 1) | ((aPC >> 2) & 1) ) & 0xFFFF;
+  }
+};
+
+//The most recent theOrigLength history bits folded down to theCompLength bits
+//by XOR.  Maintained incrementally as outcomes are shifted in, so index and
+//tag hashes for long histories cost a few operations per branch.
+struct FoldedHistory {
+  uint32_t theComp;
+  uint32_t theCompLength;
+  uint32_t theOrigLength;
+  uint32_t theOutPoint;
+
+  void init( uint32_t anOrigLength, uint32_t aCompLength ) {
+    theComp = 0;
+    theOrigLength = anOrigLength;
+    theCompLength = aCompLength;
+    theOutPoint = anOrigLength % aCompLength;
+  }
+
+  //Call after every TageHistory::push
+  void update( TageHistory const & aHistory ) {
+    theComp = (theComp << 1) | aHistory.bit(0);
+    theComp ^= aHistory.bit(theOrigLength) << theOutPoint;
+    theComp ^= theComp >> theCompLength;
+    theComp &= (1U << theCompLength) - 1;
+  }
+
+  //Recompute from scratch, e.g. after restoring the history from a flexpoint
+  void rebuild( TageHistory const & aHistory ) {
+    theComp = 0;
+    for (uint32_t age = 0; age < theOrigLength; ++age) {
+      theComp ^= aHistory.bit(age) << (age % theCompLength);
+    }
+  }
+};
+
+struct TageEntry {
+  int8_t theCounter;  //3-bit signed; taken when >= 0
+  uint8_t theUseful;  //2-bit
+  uint16_t theTag;
+
+  TageEntry()
+    : theCounter(0)
+    , theUseful(0)
+    , theTag(0)
+  {}
+
+private:
+  friend class boost::serialization::access;
+  template<class Archive>
+  void serialize(Archive & ar, const uint32_t version) {
+    ar & theCounter;
+    ar & theUseful;
+    ar & theTag;
+  }
+};
+
+struct IttageEntry {
+  uint64_t theTarget;
+  uint16_t theTag;
+  uint8_t theConfidence;  //2-bit
+  uint8_t theUseful;      //1-bit
+
+  IttageEntry()
+    : theTarget(0)
+    , theTag(0)
+    , theConfidence(0)
+    , theUseful(0)
+  {}
+
+private:
+  friend class boost::serialization::access;
+  template<class Archive>
+  void serialize(Archive & ar, const uint32_t version) {
+    ar & theTarget;
+    ar & theTag;
+    ar & theConfidence;
+    ar & theUseful;
+  }
+};
+
+//Compact TAGE conditional predictor and ITTAGE indirect target predictor,
+//following Seznec's CBP designs.  The BTB identifies branches and provides
+//the base target, a bimodal table provides the base direction, and each
+//tagged component is one flat array indexed with a geometric history length.
+//History is updated at feedback.  The indices and tags hashed at predict time
+//travel in the BPredState, so feedback trains the entries the prediction
+//read even when other cores sharing the predictor have moved the history.
+struct FastTageImpl : public FastBranchPredictor {
+
+  static const int32_t kTables = 7;
+  static const int32_t kLogTableSize = 10;
+  static const int32_t kTagBits = 11;
+  static const int32_t kTargetTables = 5;
+  static const int32_t kLogTargetTableSize = 8;
+  static const int32_t kTargetTagBits = 12;
+  static const int32_t kUsefulResetPeriod = 1 << 18;
+
+  static_assert( kTables == BPredState::kTageTables && kTargetTables == BPredState::kTageTargetTables, "BPredState must hold one index and tag per tagged table" );
+
+  static const uint32_t theHistoryLengths[kTables];
+  static const uint32_t theTargetHistoryLengths[kTargetTables];
+
+  struct Lookup {
+    uint32_t theIndex[kTables];
+    uint16_t theTag[kTables];
+    int32_t theProvider;     //-1 when the base predictor provides
+    int32_t theAltProvider;  //-1 when the base predictor provides
+    bool theProviderTaken;
+    bool theAltTaken;
+    bool theTaken;
+  };
+
+  struct TargetLookup {
+    uint32_t theIndex[kTargetTables];
+    uint16_t theTag[kTargetTables];
+    int32_t theProvider;
+    int32_t theAltProvider;
+    VirtualMemoryAddress theTarget;
+  };
+
+  std::string theName;
+  uint32_t theIndex;
+  uint32_t theSerial;
+  BTB theBTB;
+  Bimodal theBase;
+  std::vector< TageEntry > theTagged;
+  std::vector< IttageEntry > theTargets;
+  TageHistory theHistory;
+  FoldedHistory theIndexFold[kTables];
+  FoldedHistory theTagFold[2][kTables];
+  FoldedHistory theTargetIndexFold[kTargetTables];
+  FoldedHistory theTargetTagFold[2][kTargetTables];
+  int32_t theUseAltOnNA;
+  uint32_t theTick;
+  uint32_t theRandom;
+
+  Stat::StatCounter theBranches;          //Retired Branches
+  Stat::StatCounter theBranches_Unconditional;
+  Stat::StatCounter theBranches_Conditional;
+  Stat::StatCounter theBranches_Call;
+  Stat::StatCounter theBranches_Return;
+
+  Stat::StatCounter thePredictions;
+  Stat::StatCounter thePredictions_Base;
+  Stat::StatCounter thePredictions_Tagged;
+  Stat::StatCounter thePredictions_Unconditional;
+  Stat::StatCounter thePredictions_Indirect;
+
+  Stat::StatCounter theCorrect;
+  Stat::StatCounter theCorrect_Conditional;
+  Stat::StatCounter theCorrect_Unconditional;
+
+  Stat::StatCounter theMispredict;
+  Stat::StatCounter theMispredict_NewBranch;
+  Stat::StatCounter theMispredict_Direction;
+  Stat::StatCounter theMispredict_Target;
+
+  Stat::StatCounter theAllocations;
+  Stat::StatCounter theAllocations_Failed;
+
+  FastTageImpl( std::string const & aName, uint32_t anIndex )
+    : theName(aName)
+    , theIndex(anIndex)
+    , theSerial(0)
+    , theBTB( 1024, 16 )
+    , theBase( 16384 )
+    , theTagged( kTables << kLogTableSize )
+    , theTargets( kTargetTables << kLogTargetTableSize )
+    , theUseAltOnNA(0)
+    , theTick(0)
+    , theRandom(0x2545F491)
+    , theBranches                      ( aName + "-branches" )
+    , theBranches_Unconditional        ( aName + "-branches:unconditional" )
+    , theBranches_Conditional          ( aName + "-branches:conditional" )
+    , theBranches_Call                 ( aName + "-branches:call" )
+    , theBranches_Return               ( aName + "-branches:return" )
+    , thePredictions                   ( aName + "-predictions" )
+    , thePredictions_Base              ( aName + "-predictions:base" )
+    , thePredictions_Tagged            ( aName + "-predictions:tagged" )
+    , thePredictions_Unconditional     ( aName + "-predictions:unconditional" )
+    , thePredictions_Indirect          ( aName + "-predictions:indirect" )
+    , theCorrect                       ( aName + "-correct" )
+    , theCorrect_Conditional           ( aName + "-correct:conditional" )
+    , theCorrect_Unconditional         ( aName + "-correct:unconditional" )
+    , theMispredict                    ( aName + "-mispredict" )
+    , theMispredict_NewBranch          ( aName + "-mispredict:new" )
+    , theMispredict_Direction          ( aName + "-mispredict:direction" )
+    , theMispredict_Target             ( aName + "-mispredict:target" )
+    , theAllocations                   ( aName + "-tage:allocations" )
+    , theAllocations_Failed            ( aName + "-tage:allocations:failed" ) {
+    for (int32_t i = 0; i < kTables; ++i) {
+      theIndexFold[i].init( theHistoryLengths[i], kLogTableSize );
+      theTagFold[0][i].init( theHistoryLengths[i], kTagBits );
+      theTagFold[1][i].init( theHistoryLengths[i], kTagBits - 1 );
+    }
+    for (int32_t i = 0; i < kTargetTables; ++i) {
+      theTargetIndexFold[i].init( theTargetHistoryLengths[i], kLogTargetTableSize );
+      theTargetTagFold[0][i].init( theTargetHistoryLengths[i], kTargetTagBits );
+      theTargetTagFold[1][i].init( theTargetHistoryLengths[i], kTargetTagBits - 1 );
+    }
+  }
+
+  uint32_t random() {
+    theRandom ^= theRandom << 13;
+    theRandom ^= theRandom >> 17;
+    theRandom ^= theRandom << 5;
+    return theRandom;
+  }
+
+  uint32_t pathHash( uint32_t aLength, int32_t aLogSize, int32_t aTable ) const {
+    uint32_t path = theHistory.thePath & ( (1U << std::min<uint32_t>(aLength, 16)) - 1 );
+    return path ^ ( path >> (aLogSize - aTable) );
+  }
+
+  TageEntry & tagged( int32_t aTable, Lookup const & aLookup ) {
+    return theTagged[ (aTable << kLogTableSize) + aLookup.theIndex[aTable] ];
+  }
+
+  IttageEntry & target( int32_t aTable, TargetLookup const & aLookup ) {
+    return theTargets[ (aTable << kLogTargetTableSize) + aLookup.theIndex[aTable] ];
+  }
+
+  //Hash the current history into every table, recording the result in
+  //aBPState for feedback
+  void hash( VirtualMemoryAddress anAddress, BPredState & aBPState ) const {
+    uint64_t pc = anAddress >> 2;
+    for (int32_t i = 0; i < kTables; ++i) {
+      aBPState.theTageIndex[i] = ( pc ^ (pc >> (kLogTableSize - i)) ^ theIndexFold[i].theComp ^ pathHash(theHistoryLengths[i], kLogTableSize, i) ) & ( (1U << kLogTableSize) - 1 );
+      aBPState.theTageTag[i] = ( pc ^ theTagFold[0][i].theComp ^ (theTagFold[1][i].theComp << 1) ) & ( (1U << kTagBits) - 1 );
+    }
+    for (int32_t i = 0; i < kTargetTables; ++i) {
+      aBPState.theTageTargetIndex[i] = ( pc ^ (pc >> (kLogTargetTableSize - i)) ^ theTargetIndexFold[i].theComp ^ pathHash(theTargetHistoryLengths[i], kLogTargetTableSize, i) ) & ( (1U << kLogTargetTableSize) - 1 );
+      aBPState.theTageTargetTag[i] = ( pc ^ theTargetTagFold[0][i].theComp ^ (theTargetTagFold[1][i].theComp << 1) ) & ( (1U << kTargetTagBits) - 1 );
+    }
+  }
+
+  void lookup( VirtualMemoryAddress anAddress, BPredState const & aBPState, Lookup & aLookup ) {
+    aLookup.theProvider = -1;
+    aLookup.theAltProvider = -1;
+    std::copy( aBPState.theTageIndex, aBPState.theTageIndex + kTables, aLookup.theIndex );
+    std::copy( aBPState.theTageTag, aBPState.theTageTag + kTables, aLookup.theTag );
+    for (int32_t i = kTables - 1; i >= 0; --i) {
+      if (tagged(i, aLookup).theTag == aLookup.theTag[i]) {
+        if (aLookup.theProvider < 0) {
+          aLookup.theProvider = i;
+        } else {
+          aLookup.theAltProvider = i;
+          break;
+        }
+      }
+    }
+
+    bool base_taken = theBase.direction(anAddress) <= kTaken;
+    aLookup.theAltTaken = ( aLookup.theAltProvider >= 0 ) ? ( tagged(aLookup.theAltProvider, aLookup).theCounter >= 0 ) : base_taken;
+    if (aLookup.theProvider < 0) {
+      aLookup.theProviderTaken = base_taken;
+      aLookup.theTaken = base_taken;
+    } else {
+      TageEntry const & provider = tagged(aLookup.theProvider, aLookup);
+      aLookup.theProviderTaken = provider.theCounter >= 0;
+      //Newly allocated entries are often wrong; trust the alternate instead
+      //while theUseAltOnNA says so.
+      bool weak = ( provider.theCounter == 0 || provider.theCounter == -1 );
+      if (weak && provider.theUseful == 0 && theUseAltOnNA >= 0) {
+        aLookup.theTaken = aLookup.theAltTaken;
+      } else {
+        aLookup.theTaken = aLookup.theProviderTaken;
+      }
+    }
+  }
+
+  void lookupTarget( VirtualMemoryAddress anAddress, BPredState const & aBPState, TargetLookup & aLookup ) {
+    aLookup.theProvider = -1;
+    aLookup.theAltProvider = -1;
+    std::copy( aBPState.theTageTargetIndex, aBPState.theTageTargetIndex + kTargetTables, aLookup.theIndex );
+    std::copy( aBPState.theTageTargetTag, aBPState.theTageTargetTag + kTargetTables, aLookup.theTag );
+    for (int32_t i = kTargetTables - 1; i >= 0; --i) {
+      if (target(i, aLookup).theTag == aLookup.theTag[i] && target(i, aLookup).theTarget != 0) {
+        if (aLookup.theProvider < 0) {
+          aLookup.theProvider = i;
+        } else {
+          aLookup.theAltProvider = i;
+          break;
+        }
+      }
+    }
+
+    aLookup.theTarget = theBTB.target(anAddress).get_value_or(VirtualMemoryAddress(0));
+    if (aLookup.theProvider >= 0) {
+      IttageEntry const & provider = target(aLookup.theProvider, aLookup);
+      if (provider.theConfidence == 0 && aLookup.theAltProvider >= 0) {
+        aLookup.theTarget = VirtualMemoryAddress( target(aLookup.theAltProvider, aLookup).theTarget );
+      } else {
+        aLookup.theTarget = VirtualMemoryAddress( provider.theTarget );
+      }
+    }
+  }
+
+  void predict( VirtualMemoryAddress anAddress, BPredState & aBPState ) {
+    aBPState.thePredictedType = theBTB.type(anAddress);
+    aBPState.theSerial = theSerial++;
+    aBPState.thePredictedTarget = VirtualMemoryAddress(0);
+    aBPState.thePrediction = kStronglyTaken;
+    aBPState.theBimodalPrediction = kStronglyTaken;
+    aBPState.theMetaPrediction = kStronglyTaken;
+    aBPState.theGSharePrediction = kStronglyTaken;
+    aBPState.theGShareShiftReg = 0;
+    //The BTB may not know the type yet, so keep both hashes for feedback
+    hash(anAddress, aBPState);
+
+    switch ( aBPState.thePredictedType ) {
+      case kNonBranch:
+        break;
+      case kConditional: {
+        Lookup lookup;
+        this->lookup(anAddress, aBPState, lookup);
+        ++thePredictions;
+        if (lookup.theProvider < 0) {
+          ++thePredictions_Base;
+        } else {
+          ++thePredictions_Tagged;
+        }
+        aBPState.thePrediction = lookup.theTaken ? kTaken : kNotTaken;
+        aBPState.theBimodalPrediction = theBase.direction(anAddress);
+        if (lookup.theTaken) {
+          aBPState.thePredictedTarget = theBTB.target(anAddress).get_value_or(VirtualMemoryAddress(0));
+        }
+        break;
+      }
+      case kUnconditional:
+      case kCall:
+      case kReturn: {
+        TargetLookup lookup;
+        lookupTarget(anAddress, aBPState, lookup);
+        ++thePredictions;
+        ++thePredictions_Unconditional;
+        if (lookup.theProvider >= 0) {
+          ++thePredictions_Indirect;
+        }
+        aBPState.thePredictedTarget = lookup.theTarget;
+        break;
+      }
+      default:
+        break;
+    }
+
+    if ( aBPState.thePredictedType != kNonBranch ) {
+      DBG_( Verb, ( << theIndex << "-TAGE-PREDICT: PC \t" << anAddress
+                    << " serial " << aBPState.theSerial
+                    << " Target \t" << aBPState.thePredictedTarget
+                    << "\tType " << aBPState.thePredictedType ) );
+    }
+  }
+
+  void updateDirection( VirtualMemoryAddress anAddress, Lookup const & aLookup, bool aTaken ) {
+    if (aLookup.theProvider >= 0) {
+      TageEntry & provider = tagged(aLookup.theProvider, aLookup);
+      bool weak = ( provider.theCounter == 0 || provider.theCounter == -1 );
+      if (weak && provider.theUseful == 0 && aLookup.theProviderTaken != aLookup.theAltTaken) {
+        if (aLookup.theAltTaken == aTaken) {
+          theUseAltOnNA = std::min(theUseAltOnNA + 1, 7);
+        } else {
+          theUseAltOnNA = std::max(theUseAltOnNA - 1, -8);
+        }
+      }
+    }
+
+    //Allocate longer-history entries on a misprediction, unless the provider
+    //was right and only the alternate choice was wrong
+    bool allocate = ( aLookup.theTaken != aTaken ) && ( aLookup.theProvider < kTables - 1 );
+    if (allocate && aLookup.theProvider >= 0 && aLookup.theProviderTaken == aTaken) {
+      allocate = false;
+    }
+    if (allocate) {
+      int32_t start = aLookup.theProvider + 1;
+      if ( start < kTables - 1 && (random() & 1) ) {
+        ++start;
+      }
+      bool allocated = false;
+      for (int32_t i = start; i < kTables; ++i) {
+        TageEntry & entry = tagged(i, aLookup);
+        if (entry.theUseful == 0) {
+          entry.theTag = aLookup.theTag[i];
+          entry.theCounter = aTaken ? 0 : -1;
+          allocated = true;
+          ++theAllocations;
+          break;
+        }
+      }
+      if (! allocated) {
+        ++theAllocations_Failed;
+        for (int32_t i = aLookup.theProvider + 1; i < kTables; ++i) {
+          TageEntry & entry = tagged(i, aLookup);
+          if (entry.theUseful > 0) {
+            --entry.theUseful;
+          }
+        }
+      }
+    }
+
+    //Graceful aging of the useful bits
+    if ( (++theTick & (kUsefulResetPeriod - 1)) == 0 ) {
+      for (TageEntry & entry : theTagged) {
+        entry.theUseful >>= 1;
+      }
+    }
+
+    if (aLookup.theProvider >= 0) {
+      TageEntry & provider = tagged(aLookup.theProvider, aLookup);
+      if (provider.theUseful == 0) {
+        //The alternate keeps learning while the provider proves itself
+        if (aLookup.theAltProvider >= 0) {
+          updateCounter( tagged(aLookup.theAltProvider, aLookup).theCounter, aTaken );
+        } else {
+          theBase.update( anAddress, apply( aTaken ? kTaken : kNotTaken, theBase.direction(anAddress) ) );
+        }
+      }
+      updateCounter( provider.theCounter, aTaken );
+      if (aLookup.theProviderTaken != aLookup.theAltTaken) {
+        if (aLookup.theProviderTaken == aTaken) {
+          provider.theUseful = std::min(provider.theUseful + 1, 3);
+        } else if (provider.theUseful > 0) {
+          --provider.theUseful;
+        }
+      }
+    } else {
+      theBase.update( anAddress, apply( aTaken ? kTaken : kNotTaken, theBase.direction(anAddress) ) );
+    }
+  }
+
+  static void updateCounter( int8_t & aCounter, bool aTaken ) {
+    if (aTaken) {
+      if (aCounter < 3) {
+        ++aCounter;
+      }
+    } else if (aCounter > -4) {
+      --aCounter;
+    }
+  }
+
+  void updateTarget( TargetLookup const & aLookup, VirtualMemoryAddress anActualTarget ) {
+    if (aLookup.theProvider >= 0) {
+      IttageEntry & provider = target(aLookup.theProvider, aLookup);
+      bool provider_correct = ( provider.theTarget == static_cast<uint64_t>(anActualTarget) );
+      if (provider_correct) {
+        provider.theConfidence = std::min(provider.theConfidence + 1, 3);
+      } else if (provider.theConfidence > 0) {
+        --provider.theConfidence;
+      } else {
+        provider.theTarget = anActualTarget;
+      }
+      if (aLookup.theAltProvider >= 0 && target(aLookup.theAltProvider, aLookup).theTarget != provider.theTarget) {
+        provider.theUseful = provider_correct ? 1 : 0;
+      }
+    }
+
+    if (aLookup.theTarget != anActualTarget && aLookup.theProvider < kTargetTables - 1) {
+      bool allocated = false;
+      for (int32_t i = aLookup.theProvider + 1; i < kTargetTables; ++i) {
+        IttageEntry & entry = target(i, aLookup);
+        if (entry.theUseful == 0) {
+          entry.theTag = aLookup.theTag[i];
+          entry.theTarget = anActualTarget;
+          entry.theConfidence = 0;
+          allocated = true;
+          break;
+        }
+      }
+      if (! allocated) {
+        for (int32_t i = aLookup.theProvider + 1; i < kTargetTables; ++i) {
+          target(i, aLookup).theUseful = 0;
+        }
+      }
+    }
+  }
+
+  void updateHistory( VirtualMemoryAddress anAddress, bool aTaken ) {
+    theHistory.push(aTaken, anAddress);
+    for (int32_t i = 0; i < kTables; ++i) {
+      theIndexFold[i].update(theHistory);
+      theTagFold[0][i].update(theHistory);
+      theTagFold[1][i].update(theHistory);
+    }
+    for (int32_t i = 0; i < kTargetTables; ++i) {
+      theTargetIndexFold[i].update(theHistory);
+      theTargetTagFold[0][i].update(theHistory);
+      theTargetTagFold[1][i].update(theHistory);
+    }
+  }
+
+  void rebuildFolds() {
+    for (int32_t i = 0; i < kTables; ++i) {
+      theIndexFold[i].rebuild(theHistory);
+      theTagFold[0][i].rebuild(theHistory);
+      theTagFold[1][i].rebuild(theHistory);
+    }
+    for (int32_t i = 0; i < kTargetTables; ++i) {
+      theTargetIndexFold[i].rebuild(theHistory);
+      theTargetTagFold[0][i].rebuild(theHistory);
+      theTargetTagFold[1][i].rebuild(theHistory);
+    }
+  }
+
+  void stats( VirtualMemoryAddress anAddress, eBranchType anActualType, eDirection anActualDirection, VirtualMemoryAddress anActualTarget, BPredState & aBPState) {
+    if (anActualType != aBPState.thePredictedType) {
+      ++theMispredict;
+      ++theMispredict_NewBranch;
+      DBG_( Verb, ( << "TAGE-RESOLVE Mispredict New-Branch " << anActualType << " @" << anAddress << " " << anActualDirection << " to " << anActualTarget ) );
+    } else if ( anActualType == kConditional ) {
+      bool predicted_taken = ( aBPState.thePrediction <= kTaken );
+      bool taken = ( anActualDirection <= kTaken );
+      if (predicted_taken != taken) {
+        ++theMispredict;
+        ++theMispredict_Direction;
+      } else if (taken && anActualTarget != aBPState.thePredictedTarget) {
+        ++theMispredict;
+        ++theMispredict_Target;
+      } else {
+        ++theCorrect;
+        ++theCorrect_Conditional;
+      }
+    } else if ( anActualType != kNonBranch ) {
+      if (anActualTarget == aBPState.thePredictedTarget) {
+        ++theCorrect;
+        ++theCorrect_Unconditional;
+      } else {
+        DBG_( Verb, ( << "TAGE-RESOLVE Mispredict (Uncond-Target) " << anActualType << " @" << anAddress << " to " << anActualTarget << " predicted target " << aBPState.thePredictedTarget ) );
+        ++theMispredict;
+        ++theMispredict_Target;
+      }
+    }
+
+    switch (anActualType) {
+      case kConditional:
+        theBranches++;
+        theBranches_Conditional++;
+        break;
+      case kUnconditional:
+        theBranches++;
+        theBranches_Unconditional++;
+        break;
+      case kCall:
+        theBranches++;
+        theBranches_Call++;
+        break;
+      case kReturn:
+        theBranches++;
+        theBranches_Return++;
+        break;
+      default:
+        break;
+    }
+  }
+
+  void feedback( VirtualMemoryAddress anAddress,  eBranchType anActualType, eDirection anActualDirection, VirtualMemoryAddress anActualTarget, BPredState & aBPState) {
+    stats(anAddress, anActualType, anActualDirection, anActualTarget, aBPState);
+
+    //Train the entries hashed at predict time
+    if (anActualType == kConditional) {
+      Lookup lookup;
+      this->lookup(anAddress, aBPState, lookup);
+      updateDirection(anAddress, lookup, anActualDirection <= kTaken);
+    } else if (anActualType != kNonBranch && anActualTarget) {
+      TargetLookup lookup;
+      lookupTarget(anAddress, aBPState, lookup);
+      updateTarget(lookup, anActualTarget);
+    }
+
+    theBTB.update(anAddress, anActualType, anActualTarget);
+
+    if (anActualType != kNonBranch) {
+      updateHistory(anAddress, anActualType != kConditional || anActualDirection <= kTaken);
+    }
+
+    DBG_(Verb, ( << theIndex << "-TAGE-FEEDBACK: PC \t" << anAddress
+                 << " serial " << aBPState.theSerial
+                 << " Target \t" << anActualTarget
+                 << "\tType " << anActualType << " dir " << anActualDirection
+                 << " pred " << aBPState.thePrediction ) );
+  }
+
+  void saveState(std::string const & aDirName) const {
+    std::string fname( aDirName);
+    fname += "/bpredtage-" + boost::padded_string_cast < 2, '0' > (theIndex);
+    std::ofstream ofs(fname.c_str());
+    boost::archive::text_oarchive oa(ofs);
+
+    oa << theBTB;
+    oa << theBase;
+    oa << theTagged;
+    oa << theTargets;
+    oa << theHistory;
+    oa << theUseAltOnNA;
+    oa << theTick;
+    oa << theRandom;
+
+    // close archive
+    ofs.close();
+  }
+
+  void loadState(std::string const & aDirName) {
+    std::string fname( aDirName);
+    fname += "/bpredtage-" + boost::padded_string_cast < 2, '0' > (theIndex);
+    std::ifstream ifs(fname.c_str());
+    if (ifs.good()) {
+      boost::archive::text_iarchive ia(ifs);
+
+      ia >> theBTB;
+      ia >> theBase;
+      ia >> theTagged;
+      ia >> theTargets;
+      ia >> theHistory;
+      ia >> theUseAltOnNA;
+      ia >> theTick;
+      ia >> theRandom;
+      DBG_Assert( theTagged.size() == static_cast<size_t>(kTables << kLogTableSize) && theTargets.size() == static_cast<size_t>(kTargetTables << kLogTargetTableSize), ( << theName << " TAGE geometry in " << fname << " does not match this build" ) );
+      rebuildFolds();
+      DBG_( Dev, ( << theName << " loaded TAGE branch predictor.  BTB size: " << theBTB.theBTBSets << " by " << theBTB.theBTBAssoc << " Base size: " << theBase.theSize << " Tagged tables: " << kTables << " Target tables: " << kTargetTables ) );
+
+      ifs.close();
+    } else {
+      DBG_(Dev, ( << "Unable to load bpred state " << fname << ". Using default state." ) );
+    }
+  }
+
+};
+
+const uint32_t FastTageImpl::theHistoryLengths[FastTageImpl::kTables] = { 5, 9, 15, 25, 44, 76, 130 };
+const uint32_t FastTageImpl::theTargetHistoryLengths[FastTageImpl::kTargetTables] = { 4, 10, 24, 58, 130 };
+
 BranchPredictor * BranchPredictor::combining(std::string const & aName, uint32_t anIndex) {
   return new CombiningImpl(aName, anIndex);
 }
@@ -1175,6 +1989,10 @@ FastBranchPredictor * FastBranchPredictor::combining(std::string const & aName,
   return new FastCombiningImpl(aName, anIndex);
 }
 
+FastBranchPredictor * FastBranchPredictor::tage(std::string const & aName, uint32_t anIndex) {
+  return new FastTageImpl(aName, anIndex);
+}
+
 std::ostream & operator << (std::ostream & anOstream, eBranchType aType) {
   char const * types[] = {
     "NonBranch"
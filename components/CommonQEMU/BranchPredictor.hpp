@@ -65,6 +65,7 @@ struct BranchPredictor {
 
 struct FastBranchPredictor {
   static FastBranchPredictor * combining(std::string const & aName, uint32_t anIndex);
+  static FastBranchPredictor * tage(std::string const & aName, uint32_t anIndex);
   //virtual void feedback( BranchFeedback const & aFeedback) = 0;
   virtual void predict( VirtualMemoryAddress anAddress, BPredState & aBPState) = 0;
   virtual void feedback( VirtualMemoryAddress anAddress,  eBranchType anActualType, eDirection anActualDirection, VirtualMemoryAddress anActualAddress, BPredState & aBPState) = 0;
@@ -0,0 +1,153 @@
+// DO-NOT-REMOVE begin-copyright-block 
+//QFlex consists of several software components that are governed by various
+//licensing terms, in addition to software that was developed internally.
+//Anyone interested in using QFlex needs to fully understand and abide by the
+//licenses governing all the software components.
+//
+//### Software developed externally (not by the QFlex group)
+//
+//    * [NS-3](https://www.gnu.org/copyleft/gpl.html)
+//    * [QEMU](http://wiki.qemu.org/License) 
+//    * [SimFlex] (http://parsa.epfl.ch/simflex/)
+//
+//Software developed internally (by the QFlex group)
+//**QFlex License**
+//
+//QFlex
+//Copyright (c) 2016, Parallel Systems Architecture Lab, EPFL
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//    * Neither the name of the Parallel Systems Architecture Laboratory, EPFL,
+//      nor the names of its contributors may be used to endorse or promote
+//      products derived from this software without specific prior written
+//      permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE PARALLEL SYSTEMS ARCHITECTURE LABORATORY,
+//EPFL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+//GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+//LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+//THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// DO-NOT-REMOVE end-copyright-block   
+#include "CacheImage.hpp"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <core/debug/debug.hpp>
+
+#define DBG_DefineCategories CacheImageCat
+#define DBG_SetDefaultOps AddCat(CacheImageCat)
+#include DBG_Control()
+
+namespace nCacheImage {
+
+static const char kImageMagic[8] = { 'F', 'X', 'C', 'I', 'M', 'G', '0', '1' };
+
+static std::size_t padded(std::size_t aBytes) {
+  return (aBytes + 7) & ~static_cast<std::size_t>(7);
+}
+
+ImageWriter::ImageWriter(std::string const & aFileName)
+  : theFile(aFileName.c_str(), std::ios::binary | std::ios::trunc) {
+  theFile.write(kImageMagic, sizeof(kImageMagic));
+}
+
+void ImageWriter::writeSection(uint64_t aSets, uint32_t anAssoc, void const * aRecords, uint32_t aRecordSize, uint64_t aCount) {
+  static const char kZeros[8] = { 0 };
+
+  ImageSection header;
+  header.theRecordSize = aRecordSize;
+  header.theAssoc = anAssoc;
+  header.theSets = aSets;
+  header.theCount = aCount;
+  theFile.write(reinterpret_cast<char const *>(&header), sizeof(header));
+
+  std::size_t bytes = static_cast<std::size_t>(aRecordSize) * aCount;
+  theFile.write(static_cast<char const *>(aRecords), bytes);
+  theFile.write(kZeros, padded(bytes) - bytes);
+}
+
+ImageReader::ImageReader(std::string const & aFileName)
+  : theFileName(aFileName)
+  , theMap(nullptr)
+  , theSize(0)
+  , theOffset(sizeof(kImageMagic)) {
+  int fd = open(aFileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) == 0 && static_cast<std::size_t>(info.st_size) >= sizeof(kImageMagic)) {
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE;
+#endif
+    void * map = mmap(nullptr, info.st_size, PROT_READ, flags, fd, 0);
+    if (map != MAP_FAILED) {
+      madvise(map, info.st_size, MADV_SEQUENTIAL);
+      theMap = static_cast<char const *>(map);
+      theSize = info.st_size;
+    }
+  }
+  close(fd);
+
+  if (theMap && std::memcmp(theMap, kImageMagic, sizeof(kImageMagic)) != 0) {
+    DBG_( Dev, ( << aFileName << " is not a cache image" ) );
+    munmap(const_cast<char *>(theMap), theSize);
+    theMap = nullptr;
+  }
+}
+
+ImageReader::~ImageReader() {
+  if (theMap) {
+    munmap(const_cast<char *>(theMap), theSize);
+  }
+}
+
+void const * ImageReader::nextSection(uint64_t aSets, uint32_t anAssoc, uint32_t aRecordSize, uint64_t & aCount) {
+  aCount = 0;
+  if (! theMap || theOffset + sizeof(ImageSection) > theSize) {
+    DBG_( Dev, ( << theFileName << ": missing image section" ) );
+    return nullptr;
+  }
+
+  ImageSection header;
+  std::memcpy(&header, theMap + theOffset, sizeof(header));
+  if (header.theRecordSize != aRecordSize || header.theSets != aSets || header.theAssoc != anAssoc) {
+    DBG_( Dev, ( << theFileName << ": image section holds " << header.theSets << " x " << header.theAssoc
+                 << " records of " << header.theRecordSize << " bytes, expected " << aSets << " x " << anAssoc
+                 << " records of " << aRecordSize << " bytes" ) );
+    return nullptr;
+  }
+
+  std::size_t bytes = static_cast<std::size_t>(aRecordSize) * header.theCount;
+  std::size_t start = theOffset + sizeof(header);
+  if (start + bytes > theSize) {
+    DBG_( Dev, ( << theFileName << ": image section truncated" ) );
+    return nullptr;
+  }
+
+  theOffset = start + padded(bytes);
+  aCount = header.theCount;
+  return theMap + start;
+}
+
+} // namespace nCacheImage
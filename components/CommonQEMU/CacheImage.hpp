@@ -0,0 +1,125 @@
+// DO-NOT-REMOVE begin-copyright-block 
+//QFlex consists of several software components that are governed by various
+//licensing terms, in addition to software that was developed internally.
+//Anyone interested in using QFlex needs to fully understand and abide by the
+//licenses governing all the software components.
+//
+//### Software developed externally (not by the QFlex group)
+//
+//    * [NS-3](https://www.gnu.org/copyleft/gpl.html)
+//    * [QEMU](http://wiki.qemu.org/License) 
+//    * [SimFlex] (http://parsa.epfl.ch/simflex/)
+//
+//Software developed internally (by the QFlex group)
+//**QFlex License**
+//
+//QFlex
+//Copyright (c) 2016, Parallel Systems Architecture Lab, EPFL
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//    * Neither the name of the Parallel Systems Architecture Laboratory, EPFL,
+//      nor the names of its contributors may be used to endorse or promote
+//      products derived from this software without specific prior written
+//      permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE PARALLEL SYSTEMS ARCHITECTURE LABORATORY,
+//EPFL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+//GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+//LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+//THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// DO-NOT-REMOVE end-copyright-block   
+#ifndef _CACHE_IMAGE_HPP_
+#define _CACHE_IMAGE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace nCacheImage {
+
+// A cache image is the 8-byte magic "FXCIMG01" followed by sections.  Each
+// section is an ImageSection header and then theCount records of
+// theRecordSize bytes, stored exactly as the serializer structs sit in
+// memory and padded to 8 bytes.  Loading maps the file and hands out
+// pointers into the mapping, so nothing is parsed entry by entry.
+//
+// Images are meant for reloading on the machine that wrote them: they use
+// host byte order and are rejected if a record size differs from the
+// current build (e.g. a different MAX_NUM_SHARERS).
+struct ImageSection {
+  uint32_t theRecordSize;
+  uint32_t theAssoc;
+  uint64_t theSets;
+  uint64_t theCount;
+};
+
+class ImageWriter {
+  std::ofstream theFile;
+
+  void writeSection(uint64_t aSets, uint32_t anAssoc, void const * aRecords, uint32_t aRecordSize, uint64_t aCount);
+
+public:
+  explicit ImageWriter(std::string const & aFileName);
+
+  bool good() const {
+    return theFile.good();
+  }
+
+  // Appends one section.  Sets and associativity are only checked on load;
+  // sections with a variable number of records pass 0 for both.
+  template <class Record>
+  void section(uint64_t aSets, uint32_t anAssoc, std::vector<Record> const & aRecords) {
+    static_assert( std::is_trivially_copyable<Record>::value, "Image records are copied as raw bytes" );
+    writeSection(aSets, anAssoc, aRecords.data(), sizeof(Record), aRecords.size());
+  }
+};
+
+class ImageReader {
+  std::string theFileName;
+  char const * theMap;
+  std::size_t theSize;
+  std::size_t theOffset;
+
+  void const * nextSection(uint64_t aSets, uint32_t anAssoc, uint32_t aRecordSize, uint64_t & aCount);
+
+public:
+  // Maps aFileName read-only.  good() is false if the file does not exist
+  // or is not a cache image.
+  explicit ImageReader(std::string const & aFileName);
+  ~ImageReader();
+
+  ImageReader(ImageReader const &) = delete;
+  ImageReader & operator=(ImageReader const &) = delete;
+
+  bool good() const {
+    return theMap != nullptr;
+  }
+
+  // Returns the records of the next section and sets aCount, or nullptr if
+  // the section does not match the expected geometry and record size.
+  template <class Record>
+  Record const * section(uint64_t aSets, uint32_t anAssoc, uint64_t & aCount) {
+    static_assert( std::is_trivially_copyable<Record>::value, "Image records are copied as raw bytes" );
+    return static_cast<Record const *>(nextSection(aSets, anAssoc, sizeof(Record), aCount));
+  }
+};
+
+} // namespace nCacheImage
+
+#endif //_CACHE_IMAGE_HPP_
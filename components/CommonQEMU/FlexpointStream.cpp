@@ -0,0 +1,324 @@
+// DO-NOT-REMOVE begin-copyright-block 
+//QFlex consists of several software components that are governed by various
+//licensing terms, in addition to software that was developed internally.
+//Anyone interested in using QFlex needs to fully understand and abide by the
+//licenses governing all the software components.
+//
+//### Software developed externally (not by the QFlex group)
+//
+//    * [NS-3](https://www.gnu.org/copyleft/gpl.html)
+//    * [QEMU](http://wiki.qemu.org/License) 
+//    * [SimFlex] (http://parsa.epfl.ch/simflex/)
+//
+//Software developed internally (by the QFlex group)
+//**QFlex License**
+//
+//QFlex
+//Copyright (c) 2016, Parallel Systems Architecture Lab, EPFL
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//    * Neither the name of the Parallel Systems Architecture Laboratory, EPFL,
+//      nor the names of its contributors may be used to endorse or promote
+//      products derived from this software without specific prior written
+//      permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE PARALLEL SYSTEMS ARCHITECTURE LABORATORY,
+//EPFL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+//GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+//LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+//THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// DO-NOT-REMOVE end-copyright-block   
+#include "FlexpointStream.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <zlib.h>
+
+#include <boost/iostreams/filter/gzip.hpp>
+
+#include <core/debug/debug.hpp>
+#include <core/component.hpp>
+
+#define DBG_DefineCategories Flexpoint
+#define DBG_SetDefaultOps AddCat(Flexpoint)
+#include DBG_Control()
+
+namespace nFlexpoint {
+
+// Fast flexpoint layout: the 8-byte magic "FXFLXPT1", a uint32_t block size,
+// then blocks of { uint32_t raw length, uint32_t compressed length, zlib
+// data }.  A block with raw length 0 ends the file.  Blocks are independent,
+// so a window of them can be (de)compressed concurrently.
+static const char kFastMagic[8] = { 'F', 'X', 'F', 'L', 'X', 'P', 'T', '1' };
+static const uint32_t kBlockSize = 4 * 1024 * 1024;
+
+// Many components save and load their flexpoints at the same time, so
+// the default leaves most of the machine to the others.  While components
+// load in parallel, each gets an equal share of the cores, so loaders times
+// codec workers never exceeds the core count.
+static const uint32_t kDefaultWorkers = 4;
+
+static uint32_t workerCount(uint32_t aThreads) {
+  uint32_t cores = std::max(1U, std::thread::hardware_concurrency());
+  uint32_t share = std::max(1U, cores / Flexus::Core::ComponentManager::getComponentManager().loadThreads());
+  if (aThreads == 0) {
+    aThreads = kDefaultWorkers;
+  }
+  return std::min(aThreads, share);
+}
+
+eFlexpointCodec parseFlexpointCodec(std::string const & aName) {
+  if (aName == "none") {
+    return kRawFlexpoint;
+  } else if (aName == "gzip") {
+    return kGZipFlexpoint;
+  } else if (aName == "fast") {
+    return kFastFlexpoint;
+  }
+  DBG_Assert( false, ( << "Unknown flexpoint codec \"" << aName << "\" (expected none | gzip | fast)" ) );
+  return kGZipFlexpoint;
+}
+
+// Output side: fills one window of blocks, compresses the window on
+// worker threads and writes the results in order.  Blocks are allocated as
+// the window first reaches them, so small files only ever hold one.
+class BlockCompressBuf : public std::streambuf {
+  std::ostream & theSink;
+  std::vector< std::vector<char> > theBlocks;
+  std::vector< std::vector<char> > theCompressed;
+  std::size_t theCurrent;
+
+  void startBlock() {
+    std::vector<char> & block = theBlocks[theCurrent];
+    if (block.empty()) {
+      block.resize(kBlockSize);
+    }
+    setp(block.data(), block.data() + block.size());
+  }
+
+  static void compressBlock(char const * aData, std::size_t aLength, std::vector<char> & anOut) {
+    uLongf out_len = compressBound(aLength);
+    anOut.resize(out_len);
+    int status = compress2(reinterpret_cast<Bytef *>(anOut.data()), &out_len, reinterpret_cast<Bytef const *>(aData), aLength, Z_BEST_SPEED);
+    DBG_Assert( status == Z_OK, ( << "Flexpoint block compression failed: " << status ) );
+    anOut.resize(out_len);
+  }
+
+  void writeWindow(std::size_t aLastLength) {
+    std::size_t count = theCurrent + 1;
+    std::vector< std::future<void> > jobs;
+    for (std::size_t i = 0; i < count; ++i) {
+      std::size_t length = (i == theCurrent) ? aLastLength : kBlockSize;
+      if (length == 0) {
+        break;
+      }
+      jobs.push_back( std::async( std::launch::async, &BlockCompressBuf::compressBlock, theBlocks[i].data(), length, std::ref(theCompressed[i]) ) );
+    }
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+      jobs[i].get();
+      uint32_t header[2];
+      header[0] = (i == theCurrent) ? aLastLength : kBlockSize;
+      header[1] = theCompressed[i].size();
+      theSink.write(reinterpret_cast<char const *>(header), sizeof(header));
+      theSink.write(theCompressed[i].data(), theCompressed[i].size());
+    }
+    theCurrent = 0;
+    startBlock();
+  }
+
+public:
+  BlockCompressBuf(std::ostream & aSink, uint32_t aThreads)
+    : theSink(aSink)
+    , theBlocks(workerCount(aThreads))
+    , theCompressed(theBlocks.size())
+    , theCurrent(0) {
+    theSink.write(kFastMagic, sizeof(kFastMagic));
+    theSink.write(reinterpret_cast<char const *>(&kBlockSize), sizeof(kBlockSize));
+    startBlock();
+  }
+
+  // Write out whatever is buffered and the end-of-file marker
+  void finish() {
+    writeWindow(pptr() - pbase());
+    uint32_t trailer[2] = { 0, 0 };
+    theSink.write(reinterpret_cast<char const *>(trailer), sizeof(trailer));
+    theSink.flush();
+  }
+
+protected:
+  int_type overflow(int_type aChar) {
+    if (++theCurrent == theBlocks.size()) {
+      theCurrent = theBlocks.size() - 1;
+      writeWindow(kBlockSize);
+    } else {
+      startBlock();
+    }
+    if (! traits_type::eq_int_type(aChar, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(aChar);
+      pbump(1);
+    }
+    return traits_type::not_eof(aChar);
+  }
+};
+
+// Input side: reads the next window of compressed blocks, decompresses
+// them on worker threads and serves them in order.
+class BlockDecompressBuf : public std::streambuf {
+  std::istream & theSource;
+  std::size_t theWindow;
+  std::vector< std::vector<char> > theBlocks;
+  std::vector< std::vector<char> > theCompressed;
+  std::size_t theCount;
+  std::size_t theCurrent;
+  bool theEnd;
+
+  static void decompressBlock(std::vector<char> const & anIn, std::vector<char> & anOut) {
+    uLongf out_len = anOut.size();
+    int status = uncompress(reinterpret_cast<Bytef *>(anOut.data()), &out_len, reinterpret_cast<Bytef const *>(anIn.data()), anIn.size());
+    DBG_Assert( status == Z_OK && out_len == anOut.size(), ( << "Corrupt flexpoint block: " << status ) );
+  }
+
+  bool readWindow() {
+    theCount = 0;
+    theCurrent = 0;
+    std::vector< std::future<void> > jobs;
+    while (! theEnd && theCount < theWindow) {
+      uint32_t header[2];
+      if (! theSource.read(reinterpret_cast<char *>(header), sizeof(header)) || header[0] == 0) {
+        theEnd = true;
+        break;
+      }
+      theCompressed[theCount].resize(header[1]);
+      theSource.read(theCompressed[theCount].data(), header[1]);
+      DBG_Assert( theSource.good(), ( << "Truncated flexpoint block" ) );
+      theBlocks[theCount].resize(header[0]);
+      jobs.push_back( std::async( std::launch::async, &BlockDecompressBuf::decompressBlock, std::cref(theCompressed[theCount]), std::ref(theBlocks[theCount]) ) );
+      ++theCount;
+    }
+    for (auto & job : jobs) {
+      job.get();
+    }
+    return theCount > 0;
+  }
+
+public:
+  BlockDecompressBuf(std::istream & aSource, uint32_t aThreads)
+    : theSource(aSource)
+    , theWindow(workerCount(aThreads))
+    , theBlocks(theWindow)
+    , theCompressed(theWindow)
+    , theCount(0)
+    , theCurrent(0)
+    , theEnd(false) {
+    uint32_t block_size;
+    theSource.read(reinterpret_cast<char *>(&block_size), sizeof(block_size));
+    setg(0, 0, 0);
+  }
+
+protected:
+  int_type underflow() {
+    if (gptr() < egptr()) {
+      return traits_type::to_int_type(*gptr());
+    }
+    if (theCount > 0 && gptr() != 0) {
+      ++theCurrent;
+    }
+    if (theCurrent >= theCount && ! readWindow()) {
+      return traits_type::eof();
+    }
+    std::vector<char> & block = theBlocks[theCurrent];
+    setg(block.data(), block.data(), block.data() + block.size());
+    return traits_type::to_int_type(*gptr());
+  }
+};
+
+FlexpointOutput::FlexpointOutput(std::string const & aFileName, eFlexpointCodec aCodec, uint32_t aThreads, bool aBinary)
+  : theFile(aFileName.c_str(), aBinary ? (std::ios::out | std::ios::binary) : std::ios::out) {
+  switch (aCodec) {
+    case kGZipFlexpoint:
+      theGZip.reset(new boost::iostreams::filtering_ostream());
+      theGZip->push(boost::iostreams::gzip_compressor(boost::iostreams::gzip_params(9)));
+      theGZip->push(theFile);
+      break;
+    case kFastFlexpoint:
+      theBlockBuf.reset(new BlockCompressBuf(theFile, aThreads));
+      theBlockStream.reset(new std::ostream(theBlockBuf.get()));
+      break;
+    case kRawFlexpoint:
+      break;
+  }
+}
+
+FlexpointOutput::~FlexpointOutput() {
+  if (theGZip) {
+    theGZip->reset();
+  }
+  if (theBlockBuf) {
+    theBlockStream->flush();
+    theBlockBuf->finish();
+  }
+}
+
+std::ostream & FlexpointOutput::stream() {
+  if (theGZip) {
+    return *theGZip;
+  } else if (theBlockStream) {
+    return *theBlockStream;
+  }
+  return theFile;
+}
+
+FlexpointInput::FlexpointInput(std::string const & aFileName, uint32_t aThreads, bool aBinary)
+  : theFile(aFileName.c_str(), aBinary ? (std::ios::in | std::ios::binary) : std::ios::in) {
+  if (! theFile.is_open()) {
+    return;
+  }
+
+  char magic[sizeof(kFastMagic)];
+  theFile.read(magic, sizeof(magic));
+  std::streamsize got = theFile.gcount();
+  theFile.clear();
+
+  if (got == sizeof(magic) && std::memcmp(magic, kFastMagic, sizeof(magic)) == 0) {
+    theBlockBuf.reset(new BlockDecompressBuf(theFile, aThreads));
+    theBlockStream.reset(new std::istream(theBlockBuf.get()));
+    return;
+  }
+
+  theFile.seekg(0);
+  if (got >= 2 && static_cast<unsigned char>(magic[0]) == 0x1f && static_cast<unsigned char>(magic[1]) == 0x8b) {
+    theGZip.reset(new boost::iostreams::filtering_istream());
+    theGZip->push(boost::iostreams::gzip_decompressor());
+    theGZip->push(theFile);
+  }
+}
+
+FlexpointInput::~FlexpointInput() {}
+
+std::istream & FlexpointInput::stream() {
+  if (theGZip) {
+    return *theGZip;
+  } else if (theBlockStream) {
+    return *theBlockStream;
+  }
+  return theFile;
+}
+
+} // namespace nFlexpoint
@@ -0,0 +1,108 @@
+// DO-NOT-REMOVE begin-copyright-block 
+//QFlex consists of several software components that are governed by various
+//licensing terms, in addition to software that was developed internally.
+//Anyone interested in using QFlex needs to fully understand and abide by the
+//licenses governing all the software components.
+//
+//### Software developed externally (not by the QFlex group)
+//
+//    * [NS-3](https://www.gnu.org/copyleft/gpl.html)
+//    * [QEMU](http://wiki.qemu.org/License) 
+//    * [SimFlex] (http://parsa.epfl.ch/simflex/)
+//
+//Software developed internally (by the QFlex group)
+//**QFlex License**
+//
+//QFlex
+//Copyright (c) 2016, Parallel Systems Architecture Lab, EPFL
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//    * Neither the name of the Parallel Systems Architecture Laboratory, EPFL,
+//      nor the names of its contributors may be used to endorse or promote
+//      products derived from this software without specific prior written
+//      permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE PARALLEL SYSTEMS ARCHITECTURE LABORATORY,
+//EPFL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+//GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+//LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+//THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// DO-NOT-REMOVE end-copyright-block   
+#ifndef _FLEXPOINT_STREAM_HPP_
+#define _FLEXPOINT_STREAM_HPP_
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <boost/iostreams/filtering_stream.hpp>
+
+namespace nFlexpoint {
+
+// Flexpoint file encodings.  Readers detect the encoding from the first
+// bytes of the file, so only writers need to be told which one to use.
+enum eFlexpointCodec {
+  kRawFlexpoint,
+  kGZipFlexpoint,   // single gzip stream, level 9 (the historical format)
+  kFastFlexpoint    // independent deflate-1 blocks, compressed in parallel
+};
+
+// Parse a codec name as given in a component parameter: "none", "gzip" or
+// "fast".  Asserts on anything else.
+eFlexpointCodec parseFlexpointCodec(std::string const & aName);
+
+class BlockCompressBuf;
+class BlockDecompressBuf;
+
+// Writes a flexpoint file with the requested codec.  aThreads of 0 uses up
+// to four workers for the fast codec; during a parallel load, workers are
+// further capped to this loader's share of the cores.  Everything is
+// flushed when the object is destroyed.
+class FlexpointOutput {
+  std::ofstream theFile;
+  std::unique_ptr<boost::iostreams::filtering_ostream> theGZip;
+  std::unique_ptr<BlockCompressBuf> theBlockBuf;
+  std::unique_ptr<std::ostream> theBlockStream;
+
+public:
+  FlexpointOutput(std::string const & aFileName, eFlexpointCodec aCodec, uint32_t aThreads = 0, bool aBinary = true);
+  ~FlexpointOutput();
+
+  std::ostream & stream();
+};
+
+// Reads a flexpoint file written in any of the codecs above.
+class FlexpointInput {
+  std::ifstream theFile;
+  std::unique_ptr<boost::iostreams::filtering_istream> theGZip;
+  std::unique_ptr<BlockDecompressBuf> theBlockBuf;
+  std::unique_ptr<std::istream> theBlockStream;
+
+public:
+  FlexpointInput(std::string const & aFileName, uint32_t aThreads = 0, bool aBinary = true);
+  ~FlexpointInput();
+
+  //False if the file could not be opened
+  bool good() const {
+    return theFile.is_open();
+  }
+  std::istream & stream();
+};
+
+} // namespace nFlexpoint
+
+#endif //_FLEXPOINT_STREAM_HPP_
@@ -44,43 +44,108 @@
 #ifndef _GLOBAL_HASHER_HPP_
 #define _GLOBAL_HASHER_HPP_
 
-#include <set>
 #include <list>
-
-#include <functional>
+#include <string>
+#include <vector>
 
 namespace nGlobalHasher {
 
 typedef Flexus::SharedTypes::PhysicalMemoryAddress Address;
 
 class GlobalHasher {
+public:
+  static const int32_t kMaxHashes = 8;
+
 private:
-  typedef std::function<int(const Address &)> hash_fn_t;
-  typedef std::list<hash_fn_t>::iterator hash_iterator_t;
+  enum HashPolicy {
+    eSimpleHash,
+    eXORHash,
+    eShiftHash,
+    eMatrixHash,
+    eFullPrimeHash
+  };
+
+  // One configured hash function.  theParam is the XOR shift, extra shift or
+  // prime depending on the policy; theMatrix is only used by matrix hashes.
+  struct HashFn {
+    HashPolicy thePolicy;
+    int32_t theOffset;
+    int32_t theParam;
+    std::vector<int> theMatrix;
+  };
 
   GlobalHasher();
 
   int32_t theHashShift;
   int32_t theHashMask;
 
-  std::list<hash_fn_t> theHashList;
+  HashFn theHashFns[kMaxHashes];
+  int32_t theNumHashes;
 
   bool has_been_initialized;
 
-  int32_t simple_hash(int32_t offset, const Address & addr) const;
-  int32_t xor_hash(int32_t offset, int32_t xor_shift, const Address & addr) const;
-  int32_t shift_hash(int32_t offset, int32_t shift, const Address & addr) const;
-  int32_t full_prime_hash(int32_t offset, int32_t prime, const Address & addr) const;
+  int32_t simple_hash(int32_t offset, uint64_t addr) const {
+    return ((addr >> theHashShift) & theHashMask) + offset;
+  }
+  int32_t xor_hash(int32_t offset, int32_t xor_shift, uint64_t addr) const {
+    return (((addr >> theHashShift) ^ (addr >> xor_shift)) & theHashMask) + offset;
+  }
+  int32_t shift_hash(int32_t offset, int32_t shift, uint64_t addr) const {
+    return ((addr >> (theHashShift + shift)) & theHashMask) + offset;
+  }
+  int32_t full_prime_hash(int32_t offset, int32_t prime, uint64_t addr) const {
+    return (addr % prime) + offset;
+  }
+  int32_t matrix_hash(int32_t offset, const std::vector<int> & matrix, uint64_t addr) const {
+    addr >>= theHashShift;
+    int32_t ret = 0;
+    for (size_t i = 0; i < matrix.size(); i++, addr >>= 1) {
+      ret ^= matrix[i] & -static_cast<int32_t>(addr & 1);
+    }
+    return (ret & theHashMask) + offset;
+  }
+
+  int32_t hash(const HashFn & fn, uint64_t addr) const {
+    switch (fn.thePolicy) {
+      case eSimpleHash:
+        return simple_hash(fn.theOffset, addr);
+      case eXORHash:
+        return xor_hash(fn.theOffset, fn.theParam, addr);
+      case eShiftHash:
+        return shift_hash(fn.theOffset, fn.theParam, addr);
+      case eMatrixHash:
+        return matrix_hash(fn.theOffset, fn.theMatrix, addr);
+      case eFullPrimeHash:
+      default:
+        return full_prime_hash(fn.theOffset, fn.theParam, addr);
+    }
+  }
+
+  std::vector<int> createMatrix(std::string args, int32_t num_buckets, int32_t shift) const;
 
-  std::function<int(int)> createMatrixHash(std::string args, int32_t num_buckets, int32_t shift, int32_t mask, int32_t offset) const;
+  void addHash(HashPolicy policy, int32_t offset, int32_t param);
 
 public:
-  std::set<int> hashAddr(const Address & addr);
+  // Fills buckets with the distinct bucket indices of addr, in hash order,
+  // and returns how many were written (at most kMaxHashes).
+  int32_t hashAddr(const Address & addr, int32_t buckets[kMaxHashes]) const {
+    int32_t count = 0;
+    for (int32_t i = 0; i < theNumHashes; i++) {
+      int32_t bucket = hash(theHashFns[i], addr);
+      bool duplicate = false;
+      for (int32_t j = 0; j < count; j++) {
+        duplicate |= (buckets[j] == bucket);
+      }
+      buckets[count] = bucket;
+      count += duplicate ? 0 : 1;
+    }
+    return count;
+  }
 
   void initialize(std::list<std::string> &hash_configs, int32_t initial_shift, int32_t buckets_per_hash, bool partitioned);
 
   int32_t numHashes() {
-    return theHashList.size();
+    return theNumHashes;
   }
 
   static GlobalHasher & theHasher();
@@ -48,6 +48,7 @@
 #include <boost/serialization/version.hpp>
 #include <boost/serialization/split_member.hpp>
 #include <core/boost_extensions/intrusive_ptr.hpp>
+#include <core/fast_alloc.hpp>
 #include <core/types.hpp>
 #include <core/debug/debug.hpp>
 
@@ -73,7 +74,7 @@ typedef uint32_t node_id_t;
 //
 // definition of the directory entry type
 //
-class DirectoryEntry : public boost::counted_base {
+class DirectoryEntry : public boost::counted_base, public FastAlloc {
 public:
   static const uint64_t kPastReaders = 0xFFFFFFFFFFFFFFFFULL;
   static const uint32_t kWasModified = 0x10000UL;
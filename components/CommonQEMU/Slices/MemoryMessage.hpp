@@ -50,6 +50,7 @@
 #define FLEXUS_MemoryMessage_TYPE_PROVIDED
 
 #include <core/boost_extensions/intrusive_ptr.hpp>
+#include <core/fast_alloc.hpp>
 
 #include <core/types.hpp>
 #include <core/exception.hpp>
@@ -68,7 +69,7 @@ uint32_t memoryMessageSerial ( void );
 
 #define HEADER_SIZE 8
 
-struct MemoryMessage : public boost::counted_base { /*, public FastAlloc*/
+struct MemoryMessage : public boost::counted_base, public FastAlloc {
   typedef PhysicalMemoryAddress MemoryAddress;
 
   // enumerated message type
@@ -56,6 +56,7 @@
 #include <tuple>
 
 #include <core/boost_extensions/intrusive_ptr.hpp>
+#include <core/fast_alloc.hpp>
 #include <core/types.hpp>
 #include <core/flexus.hpp>
 
@@ -97,7 +98,7 @@ struct TransactionStatManager {
 
 uint64_t getTTGUID();
 
-class TransactionTracker : public boost::counted_base { /*, public FastAlloc*/
+class TransactionTracker : public boost::counted_base, public FastAlloc {
   typedef Flexus::SharedTypes::PhysicalMemoryAddress MemoryAddress;
 
   static std::shared_ptr<TransactionTracer> theTracer;
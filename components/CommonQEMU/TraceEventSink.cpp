@@ -0,0 +1,137 @@
+// DO-NOT-REMOVE begin-copyright-block 
+//QFlex consists of several software components that are governed by various
+//licensing terms, in addition to software that was developed internally.
+//Anyone interested in using QFlex needs to fully understand and abide by the
+//licenses governing all the software components.
+//
+//### Software developed externally (not by the QFlex group)
+//
+//    * [NS-3](https://www.gnu.org/copyleft/gpl.html)
+//    * [QEMU](http://wiki.qemu.org/License) 
+//    * [SimFlex] (http://parsa.epfl.ch/simflex/)
+//
+//Software developed internally (by the QFlex group)
+//**QFlex License**
+//
+//QFlex
+//Copyright (c) 2016, Parallel Systems Architecture Lab, EPFL
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//    * Neither the name of the Parallel Systems Architecture Laboratory, EPFL,
+//      nor the names of its contributors may be used to endorse or promote
+//      products derived from this software without specific prior written
+//      permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE PARALLEL SYSTEMS ARCHITECTURE LABORATORY,
+//EPFL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+//GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+//LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+//THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// DO-NOT-REMOVE end-copyright-block   
+#include "TraceEventSink.hpp"
+
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+
+#include <core/debug/debug.hpp>
+
+#define DBG_DeclareCategories TraceTrack
+#define DBG_SetDefaultOps AddCat(TraceTrack)
+#include DBG_Control()
+
+namespace nTraceTracker {
+
+TraceEventSink::TraceEventSink(std::string const & aFileName, std::size_t aBufferRecords)
+  : theFileName(aFileName)
+  , theBufferRecords(aBufferRecords > 0 ? aBufferRecords : 1)
+  , theFile(aFileName.c_str(), std::ios::out | std::ios::binary)
+  , theDrainPending(false)
+  , theClosing(false)
+  , theClosed(false)
+  , theRecords(0) {
+  DBG_Assert( theFile.good(), ( << "Unable to open TraceTracker event log " << theFileName ) );
+  theFill.reserve(theBufferRecords);
+  theDrain.reserve(theBufferRecords);
+  theWriter = std::thread( [this]() {
+    writerLoop();
+  } );
+}
+
+TraceEventSink::~TraceEventSink() {
+  close();
+}
+
+void TraceEventSink::handOff() {
+  std::unique_lock<std::mutex> lock(theLock);
+  theDrainDone.wait(lock, [this]() {
+    return !theDrainPending;
+  } );
+  theRecords += theFill.size();
+  theFill.swap(theDrain);
+  theFill.clear();
+  theDrainPending = true;
+  theDrainReady.notify_one();
+}
+
+void TraceEventSink::close() {
+  if (theClosed) {
+    return;
+  }
+  if (!theFill.empty()) {
+    handOff();
+  }
+  {
+    std::lock_guard<std::mutex> lock(theLock);
+    theClosing = true;
+  }
+  theDrainReady.notify_one();
+  theWriter.join();
+  theClosed = true;
+  DBG_(Dev, ( << "TraceTracker event log " << theFileName << ": " << theRecords << " records" ) );
+}
+
+void TraceEventSink::writerLoop() {
+  boost::iostreams::filtering_stream<boost::iostreams::output> out;
+  out.push(boost::iostreams::gzip_compressor());
+  out.push(theFile);
+
+  uint32_t record_size = sizeof(TraceEvent);
+  out.write("FXTRACE1", 8);
+  out.write(reinterpret_cast<char const *>(&record_size), sizeof(record_size));
+
+  std::unique_lock<std::mutex> lock(theLock);
+  while (true) {
+    theDrainReady.wait(lock, [this]() {
+      return theDrainPending || theClosing;
+    } );
+    if (theDrainPending) {
+      //The simulation thread does not touch theDrain while a drain is
+      //pending, so write it without holding the lock.
+      lock.unlock();
+      out.write(reinterpret_cast<char const *>(theDrain.data()), theDrain.size() * sizeof(TraceEvent));
+      lock.lock();
+      theDrainPending = false;
+      theDrainDone.notify_one();
+    } else {
+      break;
+    }
+  }
+  lock.unlock();
+  out.reset();
+  theFile.close();
+}
+
+} // namespace nTraceTracker
@@ -0,0 +1,157 @@
+// DO-NOT-REMOVE begin-copyright-block 
+//QFlex consists of several software components that are governed by various
+//licensing terms, in addition to software that was developed internally.
+//Anyone interested in using QFlex needs to fully understand and abide by the
+//licenses governing all the software components.
+//
+//### Software developed externally (not by the QFlex group)
+//
+//    * [NS-3](https://www.gnu.org/copyleft/gpl.html)
+//    * [QEMU](http://wiki.qemu.org/License) 
+//    * [SimFlex] (http://parsa.epfl.ch/simflex/)
+//
+//Software developed internally (by the QFlex group)
+//**QFlex License**
+//
+//QFlex
+//Copyright (c) 2016, Parallel Systems Architecture Lab, EPFL
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//    * Neither the name of the Parallel Systems Architecture Laboratory, EPFL,
+//      nor the names of its contributors may be used to endorse or promote
+//      products derived from this software without specific prior written
+//      permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE PARALLEL SYSTEMS ARCHITECTURE LABORATORY,
+//EPFL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+//GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+//LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+//THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// DO-NOT-REMOVE end-copyright-block   
+#ifndef _TRACE_EVENT_SINK_HPP_
+#define _TRACE_EVENT_SINK_HPP_
+
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <core/types.hpp>
+
+namespace nTraceTracker {
+
+enum eTraceEventType {
+  eEvtAccess,
+  eEvtCommit,
+  eEvtStore,
+  eEvtPrefetch,
+  eEvtFill,
+  eEvtPrefetchFill,
+  eEvtPrefetchHit,
+  eEvtPrefetchRedundant,
+  eEvtInsert,
+  eEvtEviction,
+  eEvtInvalidation,
+  eEvtInvalidAck,
+  eEvtInvalidTagCreate,
+  eEvtInvalidTagRefill,
+  eEvtInvalidTagReplace,
+  eEvtAccessLoad,
+  eEvtAccessStore,
+  eEvtAccessFetch,
+  eEvtAccessAtomic
+};
+
+enum eTraceEventFlags {
+  kEvtWrite      = 0x01,
+  kEvtMiss       = 0x02,
+  kEvtPriv       = 0x04,
+  kEvtPrefetched = 0x08,
+  kEvtDrop       = 0x10,
+  kEvtFetch      = 0x20
+};
+
+// One fixed-size record per tracker event.  theAux holds the fill level for
+// fills and the access size for the accessX events; theOffset is the offset
+// within the block for the accessX events.
+struct TraceEvent {
+  uint64_t theAddress;
+  uint64_t thePC;
+  uint64_t theCycle;
+  uint16_t theNode;
+  uint8_t theLevel;
+  uint8_t theType;
+  uint8_t theFlags;
+  uint8_t theAux;
+  uint16_t theOffset;
+};
+
+// Buffered binary log of TraceTracker events.  Records are appended to a
+// fill buffer; full buffers are handed to a background thread that writes
+// them through a gzip compressor, so the simulation thread only blocks if it
+// fills a second buffer before the writer has drained the first.
+//
+// File layout: the 8-byte magic "FXTRACE1", a uint32_t record size, then
+// records back to back, all gzip-compressed.
+class TraceEventSink {
+  std::string theFileName;
+  std::size_t theBufferRecords;
+  std::ofstream theFile;
+
+  std::vector<TraceEvent> theFill;
+  std::vector<TraceEvent> theDrain;
+
+  std::mutex theLock;
+  std::condition_variable theDrainReady;
+  std::condition_variable theDrainDone;
+  bool theDrainPending;
+  bool theClosing;
+  bool theClosed;
+  std::thread theWriter;
+
+  uint64_t theRecords;
+
+  void writerLoop();
+  void handOff();
+
+public:
+  TraceEventSink(std::string const & aFileName, std::size_t aBufferRecords);
+  ~TraceEventSink();
+
+  //Events recorded after close() are dropped
+  void record(TraceEvent const & anEvent) {
+    if (theClosed) {
+      return;
+    }
+    theFill.push_back(anEvent);
+    if (theFill.size() >= theBufferRecords) {
+      handOff();
+    }
+  }
+
+  //Flush all buffered records and close the file.  Safe to call twice.
+  void close();
+
+  uint64_t records() const {
+    return theRecords;
+  }
+};
+
+} // namespace nTraceTracker
+
+#endif
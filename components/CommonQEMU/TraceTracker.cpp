@@ -42,6 +42,8 @@
 //THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // DO-NOT-REMOVE end-copyright-block   
 #include "TraceTracker.hpp"
+#include "TraceEventSink.hpp"
+#include <core/flexus.hpp>
 #include <core/boost_extensions/padded_string_cast.hpp>
 
 #define DBG_DefineCategories TraceTrack
@@ -91,88 +93,137 @@ void TraceTracker::access(int32_t aNode, SharedTypes::tFillLevel cache, address_
                           bool prefetched, bool write, bool miss, bool priv, uint64_t ltime) {
   DBG_(MyLevel, ( << "[" << aNode << ":" << cache << "] access 0x" << std::hex << addr));
   //DBG_(Dev, (<< "[" << aNode << ":" << cache << "] access 0x" << std::hex << addr << " (ts:" << ltime <<")"));
+  logEvent(aNode, cache, eEvtAccess, addr, pc, (prefetched ? kEvtPrefetched : 0) | (write ? kEvtWrite : 0) | (miss ? kEvtMiss : 0) | (priv ? kEvtPriv : 0));
 }
 
 void TraceTracker::commit(int32_t aNode, SharedTypes::tFillLevel cache, address_t addr, address_t pc, uint64_t aLogicalTime) {
   DBG_(MyLevel, ( << "[" << aNode << ":" << cache << "] commit 0x" << std::hex << addr));
+  logEvent(aNode, cache, eEvtCommit, addr, pc);
 }
 
 void TraceTracker::store(int32_t aNode, SharedTypes::tFillLevel cache, address_t addr, address_t pc,
                          bool miss, bool priv, uint64_t aLogicalTime) {
   DBG_(MyLevel, ( << "[" << aNode << ":" << cache << "] store 0x" << std::hex << addr));
+  logEvent(aNode, cache, eEvtStore, addr, pc, kEvtWrite | (miss ? kEvtMiss : 0) | (priv ? kEvtPriv : 0));
 }
 
 void TraceTracker::prefetch(int32_t aNode, SharedTypes::tFillLevel cache, address_t block) {
   DBG_(MyLevel, ( << "[" << aNode << ":" << cache << "] prefetch 0x" << std::hex << block));
+  logEvent(aNode, cache, eEvtPrefetch, block);
 }
 
 
 void TraceTracker::fill(int32_t aNode, SharedTypes::tFillLevel cache, address_t block, SharedTypes::tFillLevel fillLevel, bool isFetch, bool isWrite) {
   DBG_(MyLevel, ( << "[" << aNode << ":" << cache << "] fill 0x" << std::hex << block));
   DBG_Assert(fillLevel != SharedTypes::eUnknown);
+  logEvent(aNode, cache, eEvtFill, block, 0, (isFetch ? kEvtFetch : 0) | (isWrite ? kEvtWrite : 0), fillLevel);
 }
 
 void TraceTracker::prefetchFill(int32_t aNode, SharedTypes::tFillLevel cache, address_t block, SharedTypes::tFillLevel fillLevel) {
   DBG_(MyLevel, ( << "[" << aNode << ":" << cache << "] prefetch fill 0x" << std::hex << block));
   DBG_Assert(fillLevel != SharedTypes::eUnknown);
+  logEvent(aNode, cache, eEvtPrefetchFill, block, 0, 0, fillLevel);
 }
 
 void TraceTracker::prefetchHit(int32_t aNode, Flexus::SharedTypes::tFillLevel cache, address_t block, bool isWrite) {
   DBG_(MyLevel, ( << "[" << aNode << ":" << cache << "] prefetch hit 0x" << std::hex << block));
+  logEvent(aNode, cache, eEvtPrefetchHit, block, 0, (isWrite ? kEvtWrite : 0));
 }
 
 void TraceTracker::prefetchRedundant(int32_t aNode, Flexus::SharedTypes::tFillLevel cache, address_t block) {
   DBG_(MyLevel, ( << "[" << aNode << ":" << cache << "] prefetch redundant 0x" << std::hex << block));
+  logEvent(aNode, cache, eEvtPrefetchRedundant, block);
 }
 
 
 void TraceTracker::insert(int32_t aNode, SharedTypes::tFillLevel cache, address_t block) {
   DBG_(MyLevel, ( << "[" << aNode << ":" << cache << "] insert 0x" << std::hex << block));
+  logEvent(aNode, cache, eEvtInsert, block);
 }
 
 void TraceTracker::eviction(int32_t aNode, SharedTypes::tFillLevel cache, address_t block, bool drop) {
   DBG_(MyLevel, ( << "[" << aNode << ":" << cache << "] evict 0x" << std::hex << block));
+  logEvent(aNode, cache, eEvtEviction, block, 0, (drop ? kEvtDrop : 0));
 }
 
 void TraceTracker::invalidation(int32_t aNode, SharedTypes::tFillLevel cache, address_t block) {
   DBG_(MyLevel, ( << "[" << aNode << ":" << cache << "] invalidate 0x" << std::hex << block));
+  logEvent(aNode, cache, eEvtInvalidation, block);
 }
 
 void TraceTracker::invalidAck(int32_t aNode, SharedTypes::tFillLevel cache, address_t block) {
   DBG_(MyLevel, ( << "[" << aNode << ":" << cache << "] invAck 0x" << std::hex << block));
+  logEvent(aNode, cache, eEvtInvalidAck, block);
 }
 
 void TraceTracker::invalidTagCreate(int32_t aNode, SharedTypes::tFillLevel cache, address_t block) {
   DBG_(MyLevel, ( << "[" << aNode << ":" << cache << "] invTagCreate 0x" << std::hex << block));
+  logEvent(aNode, cache, eEvtInvalidTagCreate, block);
 }
 
 void TraceTracker::invalidTagRefill(int32_t aNode, SharedTypes::tFillLevel cache, address_t block) {
   DBG_(MyLevel, ( << "[" << aNode << ":" << cache << "] invTagRefill 0x" << std::hex << block));
+  logEvent(aNode, cache, eEvtInvalidTagRefill, block);
 }
 
 void TraceTracker::invalidTagReplace(int32_t aNode, SharedTypes::tFillLevel cache, address_t block) {
   DBG_(MyLevel, ( << "[" << aNode << ":" << cache << "] invTagReplace 0x" << std::hex << block));
+  logEvent(aNode, cache, eEvtInvalidTagReplace, block);
 }
 
 void TraceTracker::accessLoad(int32_t aNode, SharedTypes::tFillLevel cache, address_t block, uint32_t offset, int32_t size) {
   DBG_(MyLevel, ( << "[" << aNode << ":" << cache << "] accessLoad 0x" << std::hex << block << "," << offset));
+  logEvent(aNode, cache, eEvtAccessLoad, block, 0, 0, size, offset);
 }
 
 void TraceTracker::accessStore(int32_t aNode, SharedTypes::tFillLevel cache, address_t block, uint32_t offset, int32_t size) {
   DBG_(MyLevel, ( << "[" << aNode << ":" << cache << "] accessStore 0x" << std::hex << block << "," << offset));
+  logEvent(aNode, cache, eEvtAccessStore, block, 0, kEvtWrite, size, offset);
 }
 
 void TraceTracker::accessFetch(int32_t aNode, SharedTypes::tFillLevel cache, address_t block, uint32_t offset, int32_t size) {
   DBG_(MyLevel, ( << "[" << aNode << ":" << cache << "] accessLoad 0x" << std::hex << block << "," << offset));
+  logEvent(aNode, cache, eEvtAccessFetch, block, 0, kEvtFetch, size, offset);
 }
 
 void TraceTracker::accessAtomic(int32_t aNode, SharedTypes::tFillLevel cache, address_t block, uint32_t offset, int32_t size) {
   DBG_(MyLevel, ( << "[" << aNode << ":" << cache << "] accessAtomic 0x" << std::hex << block << "," << offset));
+  logEvent(aNode, cache, eEvtAccessAtomic, block, 0, kEvtWrite, size, offset);
+}
+
+void TraceTracker::logEvent(int32_t aNode, SharedTypes::tFillLevel cache, int aType, address_t anAddress,
+                            address_t aPC, int aFlags, int anAux, uint32_t anOffset) {
+  if (!theEventSink) {
+    return;
+  }
+  TraceEvent evt;
+  evt.theAddress = anAddress;
+  evt.thePC = aPC;
+  evt.theCycle = theFlexus->cycleCount();
+  evt.theNode = aNode;
+  evt.theLevel = cache;
+  evt.theType = aType;
+  evt.theFlags = aFlags;
+  evt.theAux = anAux;
+  evt.theOffset = anOffset;
+  theEventSink->record(evt);
 }
 
 TraceTracker::TraceTracker()
 {}
 
+TraceTracker::~TraceTracker()
+{}
+
+void TraceTracker::openEventLog(std::string const & aFileName, std::size_t aBufferRecords) {
+  DBG_(Dev, ( << "TraceTracker logging events to " << aFileName));
+  theEventSink.reset(new TraceEventSink(aFileName, aBufferRecords));
+}
+
+void TraceTracker::closeEventLog() {
+  theEventSink.reset();
+}
+
 void TraceTracker::initialize() {
   DBG_(Iface, ( << "initializing TraceTracker"));
   Flexus::Stat::getStatManager()->addFinalizer( [this](){return this->finalize();});
@@ -180,6 +231,9 @@ void TraceTracker::initialize() {
 
 void TraceTracker::finalize() {
   DBG_(Iface, ( << "finalizing TraceTracker"));
+  if (theEventSink) {
+    theEventSink->close();
+  }
 }
 
 
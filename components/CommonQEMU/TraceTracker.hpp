@@ -61,11 +61,15 @@
 namespace nTraceTracker {
 
 
-typedef uint32_t address_t;
+typedef uint64_t address_t;
 
+class TraceEventSink;
 
 class TraceTracker {
+  std::unique_ptr<TraceEventSink> theEventSink;
 
+  void logEvent(int32_t aNode, Flexus::SharedTypes::tFillLevel cache, int aType, address_t anAddress,
+                address_t aPC = 0, int aFlags = 0, int anAux = 0, uint32_t anOffset = 0);
 
 public:
   void access      (int32_t aNode, Flexus::SharedTypes::tFillLevel cache, address_t addr, address_t pc, bool prefetched, bool write, bool miss, bool priv, uint64_t ltime);
@@ -90,9 +94,16 @@ public:
   void accessAtomic(int32_t aNode, Flexus::SharedTypes::tFillLevel cache, address_t block, uint32_t offset, int32_t size);
 
   TraceTracker();
+  ~TraceTracker();
   void initialize();
   void finalize();
 
+  //Write every event to a compressed binary log for offline analysis
+  void openEventLog(std::string const & aFileName, std::size_t aBufferRecords);
+  //Flush the log and stop its writer thread; events are dropped until the
+  //log is opened again
+  void closeEventLog();
+
 
 };
 
@@ -100,4 +111,22 @@ public:
 
 extern nTraceTracker::TraceTracker theTraceTracker;
 
+namespace nTraceTracker {
+
+//Components that report to the tracker bind a pointer to it when they are
+//initialized, and get a null pointer when their trace_tracker_on parameter
+//is off.  Each hook is then a single predictable null check per message.
+inline TraceTracker * bindTraceTracker(bool anEnable) {
+  return anEnable ? &theTraceTracker : 0;
+}
+
+} // namespace nTraceTracker
+
+//Build with -DFLEXUS_NO_TRACE_TRACKER to compile every hook out.
+#ifdef FLEXUS_NO_TRACE_TRACKER
+#define TRACE_TRACKER_HOOK(aTracker, aCall) do { } while (0)
+#else
+#define TRACE_TRACKER_HOOK(aTracker, aCall) do { if (aTracker) { (aTracker)->aCall; } } while (0)
+#endif
+
 #endif
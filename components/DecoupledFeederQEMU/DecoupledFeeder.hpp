@@ -60,6 +60,20 @@ COMPONENT_PARAMETERS(
   //PARAMETER( WhiteBoxDebug, bool, "WhiteBox debugging on/off", "whitebox_debug", false )
   //PARAMETER( WhiteBoxPeriod, int, "WhiteBox period", "whitebox_debug_period", 10000 )
   PARAMETER( SendNonAllocatingStores, bool, "Send NonAllocatingStores on/off", "send_non_allocating_stores", false )
+  PARAMETER( SweepSpec, std::string, "Configuration sweep file to fork variants from once warmed (empty = none)", "sweep_spec", "" )
+  PARAMETER( SweepCycle, uint64_t, "Cycle at which the configuration sweep forks", "sweep_cycle", 0 )
+  PARAMETER( CheckpointInterval, uint64_t, "Cycles between Flexus checkpoints (0 = never)", "ckpt_interval", 0 )
+  PARAMETER( LoadCheckpoint, std::string, "Flexus checkpoint directory to resume from (empty = none)", "ckpt_load", "" )
+  PARAMETER( LoadMismatchOk, bool, "Resume from ckpt_load even if the emulator's instruction counts differ from the checkpoint", "ckpt_load_mismatch_ok", false )
+  PARAMETER( LoadThreads, uint32_t, "Threads for loading component state (0 = all cores, 1 = serial)", "ckpt_load_threads", 0 )
+  PARAMETER( SampleUnit, uint64_t, "Cycles measured per sample (0 = no sampling)", "sample_unit", 0 )
+  PARAMETER( SamplePeriod, uint64_t, "Cycles between the starts of consecutive samples (= sample_unit for back-to-back samples)", "sample_period", 0 )
+  PARAMETER( SampleMetric, std::string, "Stat expression evaluated on each sample, e.g. {sys-cycles}/sum{.*-feeder-ICount}", "sample_metric", "" )
+  PARAMETER( SampleStats, std::string, "Regex of stats recorded in each sample measurement", "sample_stats", ".*" )
+  PARAMETER( SampleConfidence, double, "Confidence level of the stopping rule", "sample_confidence", 0.95 )
+  PARAMETER( SampleError, double, "Relative confidence interval half-width at which sampling stops", "sample_error", 0.03 )
+  PARAMETER( SampleMin, uint32_t, "Minimum samples before the stopping rule applies", "sample_min", 30 )
+  PARAMETER( SampleMax, uint32_t, "Stop after this many samples regardless (0 = no limit)", "sample_max", 0 )
 );
 
 typedef std::pair< uint64_t, uint32_t> ulong_pair;
@@ -44,6 +44,7 @@
 #include <components/DecoupledFeederQEMU/DecoupledFeeder.hpp>
 
 #include <components/DecoupledFeederQEMU/QemuTracer.hpp>
+#include <components/DecoupledFeederQEMU/SamplingController.hpp>
 #include <components/uFetch/uFetchTypes.hpp>
 #include <core/qemu/api_wrappers.hpp>
 
@@ -76,6 +77,14 @@ extern "C" {
   int64_t * theLastICounts;
   Stat::StatCounter ** theICounts;
 
+  //Flexus checkpointing: resume on the first housekeeping event, once every
+  //component is initialized, then save every CheckpointInterval cycles.  Each
+  //save breaks simulation so the driver can snapshot the emulator to match.
+  bool theCheckpointLoaded;
+  uint64_t theNextCheckpoint;
+
+  SamplingController * theSampler;
+
 public:
   FLEXUS_COMPONENT_CONSTRUCTOR(DecoupledFeeder)
     : base( FLEXUS_PASS_CONSTRUCTOR_ARGS ) {
@@ -128,6 +137,16 @@ public:
 	//TODO fix this with actual QEMU_insert_callback.
     //thePeriodicHap = new periodic_hap_t(this, cfg.HousekeepingPeriod);
     Qemu::API::QEMU_insert_callback(QEMUFLEX_GENERIC_CALLBACK, Qemu::API::QEMU_periodic_event,(void*)this, (void*)&houseKeeping);
+    if (! cfg.SweepSpec.empty()) {
+      theFlexus->scheduleForkSweep(cfg.SweepSpec, cfg.SweepCycle);
+    }
+    theCheckpointLoaded = cfg.LoadCheckpoint.empty();
+    theNextCheckpoint = 0;
+    theSampler = nullptr;
+    if (cfg.SampleUnit > 0) {
+      theSampler = SamplingController::construct(cfg.SampleUnit, cfg.SamplePeriod, cfg.SampleMetric, cfg.SampleStats, cfg.SampleConfidence, cfg.SampleError, cfg.SampleMin, cfg.SampleMax);
+      theSampler->start();
+    }
     theFlexus->advanceCycles(0);
     theCMPWidth = cfg.CMPWidth;
     if (theCMPWidth == 0) {
@@ -185,11 +204,33 @@ public:
   }
 
   void doHousekeeping() {
+    if (! theCheckpointLoaded) {
+      theFlexus->setLoadThreads(cfg.LoadThreads);
+      theFlexus->setLoadMismatchOk(cfg.LoadMismatchOk);
+      theFlexus->loadState(cfg.LoadCheckpoint);
+      theCheckpointLoaded = true;
+    }
+
     updateInstructionCounts();
     theTracer->updateStats();
     
     theFlexus->advanceCycles(cfg.HousekeepingPeriod);
     theFlexus->invokeDrives();
+
+    if (cfg.CheckpointInterval > 0) {
+      checkpointIfDue();
+    }
+  }
+
+  void checkpointIfDue() {
+    uint64_t cycle = theFlexus->cycleCount();
+    if (theNextCheckpoint == 0) {
+      theNextCheckpoint = (cycle / cfg.CheckpointInterval + 1) * cfg.CheckpointInterval;
+    }
+    if (cycle >= theNextCheckpoint) {
+      theFlexus->quiesceAndSave(cycle / cfg.CheckpointInterval);
+      theNextCheckpoint = (cycle / cfg.CheckpointInterval + 1) * cfg.CheckpointInterval;
+    }
   }
 
   void OnPeriodicEvent(Qemu::API::conf_object_t * ignored, long long aPeriod) {
@@ -0,0 +1,172 @@
+// DO-NOT-REMOVE begin-copyright-block 
+//QFlex consists of several software components that are governed by various
+//licensing terms, in addition to software that was developed internally.
+//Anyone interested in using QFlex needs to fully understand and abide by the
+//licenses governing all the software components.
+//
+//### Software developed externally (not by the QFlex group)
+//
+//    * [NS-3](https://www.gnu.org/copyleft/gpl.html)
+//    * [QEMU](http://wiki.qemu.org/License) 
+//    * [SimFlex] (http://parsa.epfl.ch/simflex/)
+//
+//Software developed internally (by the QFlex group)
+//**QFlex License**
+//
+//QFlex
+//Copyright (c) 2016, Parallel Systems Architecture Lab, EPFL
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//    * Neither the name of the Parallel Systems Architecture Laboratory, EPFL,
+//      nor the names of its contributors may be used to endorse or promote
+//      products derived from this software without specific prior written
+//      permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE PARALLEL SYSTEMS ARCHITECTURE LABORATORY,
+//EPFL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+//GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+//LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+//THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// DO-NOT-REMOVE end-copyright-block   
+#include <components/DecoupledFeederQEMU/SamplingController.hpp>
+
+#include <functional>
+
+#include <core/boost_extensions/padded_string_cast.hpp>
+#include <core/flexus.hpp>
+#include <core/stats.hpp>
+
+#define DBG_DeclareCategories Feeder
+#define DBG_SetDefaultOps AddCat(Feeder)
+#include DBG_Control()
+
+namespace nDecoupledFeeder {
+
+namespace Stat = Flexus::Stat;
+using Flexus::Core::theFlexus;
+
+class SamplingControllerImpl : public SamplingController {
+  uint64_t theUnit;
+  uint64_t thePeriod;
+  std::string theMetric;
+  std::string theStatSpec;
+  double theConfidence;
+  double theError;
+  uint32_t theMinSamples;
+  uint32_t theMaxSamples;
+
+  //Back-to-back samples with no warming between them
+  bool theContinuous;
+  int64_t thePeriodStart;
+  std::string theCurrentSample;
+  boost::intrusive_ptr<Stat::aux_::ConfidenceMeasurement> theSamples;
+
+public:
+  SamplingControllerImpl(uint64_t aUnit, uint64_t aPeriod, std::string const & aMetric, std::string const & aStatSpec, double aConfidence, double anError, uint32_t aMinSamples, uint32_t aMaxSamples)
+    : theUnit(aUnit)
+    , thePeriod(aPeriod)
+    , theMetric(aMetric)
+    , theStatSpec(aStatSpec)
+    , theConfidence(aConfidence)
+    , theError(anError)
+    , theMinSamples(aMinSamples)
+    , theMaxSamples(aMaxSamples)
+    , theContinuous(aPeriod == aUnit)
+    , thePeriodStart(0) {
+    DBG_Assert( theUnit > 0 );
+    DBG_Assert( thePeriod >= theUnit, ( << "sample_period must cover sample_unit" ) );
+    DBG_Assert( ! theMetric.empty(), ( << "sample_metric must be set when sampling" ) );
+    DBG_Assert( aConfidence > 0.0 && aConfidence < 1.0 );
+  }
+
+  void start() {
+    DBG_( Dev, ( << "Sampling " << theUnit << " of every " << thePeriod << " cycles; stop at +/-" << theError * 100 << "% for " << theMetric ) );
+    //Each sample's stats go to its own measurement; "samples" only collects
+    //the metric values, so it is opened over no stats
+    theSamples = Stat::getStatManager()->openConfidenceMeasurement("samples", 0, theMetric, theConfidence, theError, theMinSamples, []() {
+      theFlexus->requestStop();
+    }, "^$");
+    if (theContinuous) {
+      beginSample();
+    } else {
+      beginPeriod();
+    }
+  }
+
+private:
+  //Events must land strictly after the current tick to be fired by a later
+  //StatManager::tick()
+  void schedule(uint64_t anOffset, std::function<void()> anEvent) {
+    int64_t deadline = thePeriodStart + anOffset;
+    if (deadline <= Stat::getStatManager()->ticks()) {
+      deadline = Stat::getStatManager()->ticks() + 1;
+    }
+    Stat::getStatManager()->addEvent(deadline, anEvent);
+  }
+
+  void beginPeriod() {
+    thePeriodStart = Stat::getStatManager()->ticks();
+    schedule(thePeriod - theUnit, [this]() {
+      this->beginSample();
+    });
+  }
+
+  void beginSample() {
+    if (theContinuous) {
+      thePeriodStart = Stat::getStatManager()->ticks();
+    }
+    theCurrentSample = "sample-" + boost::padded_string_cast < 5, '0' > (theSamples->samples());
+    Stat::getStatManager()->openMeasurement(theCurrentSample, theStatSpec);
+    schedule(thePeriod, [this]() {
+      this->endSample();
+    });
+  }
+
+  void endSample() {
+    Stat::getStatManager()->closeMeasurement(theCurrentSample);
+
+    double value;
+    if (! Stat::getStatManager()->evaluate(theMetric, theCurrentSample, value)) {
+      DBG_( Crit, ( << "Cannot evaluate sample_metric on " << theCurrentSample << "; sampling stopped" ) );
+      return;
+    }
+    theSamples->addSample(value);
+    DBG_( Dev, ( << theCurrentSample << ": " << value << " mean " << theSamples->mean() << " +/-" << theSamples->relativeError() * 100 << "%" ) );
+
+    if (theSamples->converged()) {
+      return;
+    }
+    if (theMaxSamples > 0 && theSamples->samples() >= theMaxSamples) {
+      DBG_( Crit, ( << "Sampling stopped at sample_max: " << theMetric << " = " << theSamples->mean() << " +/-" << theSamples->relativeError() * 100 << "%" ) );
+      theFlexus->requestStop();
+      return;
+    }
+    if (theContinuous) {
+      beginSample();
+    } else {
+      beginPeriod();
+    }
+  }
+};
+
+SamplingController * SamplingController::construct(uint64_t aUnit, uint64_t aPeriod, std::string const & aMetric, std::string const & aStatSpec, double aConfidence, double anError, uint32_t aMinSamples, uint32_t aMaxSamples) {
+  return new SamplingControllerImpl(aUnit, aPeriod, aMetric, aStatSpec, aConfidence, anError, aMinSamples, aMaxSamples);
+}
+
+} //end nDecoupledFeeder
+
+#define DBG_Reset
+#include DBG_Control()
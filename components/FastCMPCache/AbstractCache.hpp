@@ -39,6 +39,7 @@
 
 #include <components/FastCMPCache/CoherenceStates.hpp>
 #include <components/FastCMPCache/LookupResult.hpp>
+#include <components/CommonQEMU/CacheImage.hpp>
 
 #include <functional>
 #include <boost/dynamic_bitset.hpp>
@@ -112,6 +113,16 @@ public:
   virtual void saveState( std::ostream & s ) = 0;
 
   virtual bool loadState( std::istream & s ) = 0;
+
+  // Raw memory-mappable images.  Caches that cannot write one return false
+  // and are saved with saveState instead.
+  virtual bool saveImage( std::string const & aFileName ) {
+    return false;
+  }
+
+  virtual bool loadImage( nCacheImage::ImageReader & anImage ) {
+    return false;
+  }
 };
 
 }  // namespace nFastCMPCache
@@ -41,11 +41,13 @@
 #include <core/types.hpp>
 
 #include <core/boost_extensions/intrusive_ptr.hpp>
+#include <core/fast_alloc.hpp>
 
 #include <components/CommonQEMU/Slices/RegionScoutMessage.hpp>
 
 #include <components/FastCMPCache/AbstractFactory.hpp>
 #include <components/CommonQEMU/Util.hpp>
+#include <components/CommonQEMU/CacheImage.hpp>
 
 #include <components/FastCMPCache/SharingVector.hpp>
 #include <components/FastCMPCache/AbstractProtocol.hpp>
@@ -71,7 +73,7 @@ struct AbstractDirectoryStats {
   }
 };
 
-class AbstractDirectoryEntry : public boost::counted_base {
+class AbstractDirectoryEntry : public boost::counted_base, public FastAlloc {
 public:
   virtual ~AbstractDirectoryEntry() {}
 };
@@ -235,8 +237,20 @@ public:
     return false;
   }
 
+  // See AbstractCache::saveImage
+  virtual bool saveImage( std::string const & aFileName ) {
+    return false;
+  }
+
+  virtual bool loadImage( nCacheImage::ImageReader & anImage ) {
+    return false;
+  }
+
   virtual void finalize() { }
 
+  // Called at stat update intervals so directories can flush locally accumulated stats
+  virtual void updateStats() { }
+
 // To work properly, every subclass should have the following two additional public members:
 //   1. static std::string name
 //  2. static AbstractDirectory* createInstance(std::string args)
@@ -67,6 +67,9 @@ COMPONENT_PARAMETERS(
   PARAMETER( SeparateID, bool, "Track Instruction and Data caches separately", "seperate_id", false)
 
   PARAMETER( CoherenceUnit, uint64_t, "Coherence Unit", "coherence_unit", 64)
+  PARAMETER( FlexpointCodec, std::string, "Codec for flexpoints (none | gzip | fast); loading detects it", "flexpoint_codec", "gzip" )
+  PARAMETER( FlexpointThreads, uint32_t, "Worker threads for the fast flexpoint codec (0 = up to 4)", "flexpoint_threads", 0 )
+  PARAMETER( ImageFlexpoints, bool, "Save flexpoints as raw memory-mappable images (.img); loading prefers them", "image_flexpoints", false )
 
 );
 
@@ -58,6 +58,10 @@
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
 
+#include <components/CommonQEMU/FlexpointStream.hpp>
+#include <components/CommonQEMU/CacheImage.hpp>
+#include <components/CommonQEMU/TraceTracker.hpp>
+
 #include <stdlib.h> // for random()
 
 /*
@@ -106,6 +110,7 @@ class FLEXUS_COMPONENT(FastCMPCache) {
   LookupResult_p snp_lookup;
 
   int32_t theIndex;
+  nTraceTracker::TraceTracker * theTracker;
 
   bool theAlwaysMulticast;
 
@@ -153,6 +158,29 @@ public:
     return true;
   }
 
+  //Each instance reads only its own flexpoint files
+  bool loadsIndependently() const {
+    return true;
+  }
+
+  //The protocol, multicast policy and tracker binding are rebuilt by
+  //reconfigure(); the flexpoint settings are read on every save and load
+  bool isReconfigurable(std::string const & aSwitch) const {
+    return aSwitch == "protocol"
+        || aSwitch == "always_multicast"
+        || aSwitch == "trace_tracker_on"
+        || aSwitch == "flexpoint_codec"
+        || aSwitch == "flexpoint_threads"
+        || aSwitch == "image_flexpoints";
+  }
+
+  void reconfigure() {
+    delete theProtocol;
+    theProtocol = CREATE_PROTOCOL(cfg.Protocol);
+    theAlwaysMulticast = cfg.AlwaysMulticast;
+    theTracker = nTraceTracker::bindTraceTracker(cfg.TraceTracker);
+  }
+
   void finalize( void ) {
     // Flush any pending actions
     performDelayedActions();
@@ -228,6 +256,7 @@ public:
     theEvictMessage.address() = PhysicalMemoryAddress(aTagset);
 
     theEvictMessage.type() = theProtocol->evict(aTagset, aLineState);
+    TRACE_TRACKER_HOOK(theTracker, eviction(theIndex, cfg.CacheLevel, aTagset, false));
 
    // if (theEvictMessage.type() == MemoryMessage::EvictDirty || cfg.CleanEvictions)
      {
@@ -304,6 +333,7 @@ public:
     theBlockMask = ~(cfg.BlockSize - 1);
 
     theIndex = flexusIndex();
+    theTracker = nTraceTracker::bindTraceTracker(cfg.TraceTracker);
 
     if (cfg.StdArray) {
       theCache = new StdCache(statName(),
@@ -420,6 +450,7 @@ public:
       DBG_Assert(aMessage.type() == MemoryMessage::Invalidate);
       if (lookup->getState() != kInvalid) {
         lookup->changeState(kInvalid, false, false);
+        TRACE_TRACKER_HOOK(theTracker, invalidation(theIndex, cfg.CacheLevel, addr));
       }
     }
 
@@ -479,6 +510,7 @@ public:
   void drive( interface::UpdateStatsDrive const &) {
     theDirStats->update();
     theCacheStats->update();
+    theDirectory->updateStats();
   }
 
 private:
@@ -680,6 +712,31 @@ private:
 
     (theCacheStats->*action.stat)++;
 
+    if (theTracker) {
+      //Evictions from the L1s are not accesses; everything else misses when
+      //it had to be satisfied by a snoop or by memory
+      bool write = false;
+      bool track = true;
+      switch (orig_msg_type) {
+        case MemoryMessage::WriteReq:
+        case MemoryMessage::UpgradeReq:
+        case MemoryMessage::NonAllocatingStoreReq:
+          write = true;
+          break;
+        case MemoryMessage::EvictClean:
+        case MemoryMessage::EvictDirty:
+        case MemoryMessage::EvictWritable:
+          track = false;
+          break;
+        default:
+          break;
+      }
+      if (track) {
+        int32_t node = cfg.SeparateID ? (anIndex >> 1) : anIndex;
+        TRACE_TRACKER_HOOK(theTracker, access(node, cfg.CacheLevel, addr, aMessage.pc(), false, write, snoop_success || accessed_memory, aMessage.isPriv(), 0));
+      }
+    }
+
     if (accessed_memory) {
       switch (orig_msg_type) {
         case MemoryMessage::ReadReq:
@@ -798,64 +855,66 @@ private:
   }
 
   void saveState(std::string const & aDirName) {
-    std::string fname( aDirName );
-    fname += "/" + statName() + "-dir.gz";
-    std::ofstream ofs(fname.c_str(), std::ios::binary);
-
-    boost::iostreams::filtering_stream<boost::iostreams::output> out;
-    out.push(boost::iostreams::gzip_compressor(boost::iostreams::gzip_params(9)));
-    out.push(ofs);
+    nFlexpoint::eFlexpointCodec codec = nFlexpoint::parseFlexpointCodec(cfg.FlexpointCodec);
 
-    theDirectory->saveState ( out , aDirName );
-
-    fname = aDirName;
-    fname += "/" + statName() + "-cache.gz";
-    std::ofstream c_ofs(fname.c_str(), std::ios::binary);
-
-    boost::iostreams::filtering_stream<boost::iostreams::output> c_out;
-    c_out.push(boost::iostreams::gzip_compressor(boost::iostreams::gzip_params(9)));
-    c_out.push(c_ofs);
+    if (! cfg.ImageFlexpoints || ! theDirectory->saveImage(aDirName + "/" + statName() + "-dir.img")) {
+      std::string fname( aDirName );
+      fname += "/" + statName() + "-dir.gz";
+      nFlexpoint::FlexpointOutput out(fname, codec, cfg.FlexpointThreads);
+      theDirectory->saveState ( out.stream() , aDirName );
+    }
 
-    theCache->saveState ( c_out );
+    if (! cfg.ImageFlexpoints || ! theCache->saveImage(aDirName + "/" + statName() + "-cache.img")) {
+      std::string fname( aDirName );
+      fname += "/" + statName() + "-cache.gz";
+      nFlexpoint::FlexpointOutput c_out(fname, codec, cfg.FlexpointThreads);
+      theCache->saveState ( c_out.stream() );
+    }
   }
 
   void loadState( std::string const & aDirName ) {
     std::string fname( aDirName);
+    nCacheImage::ImageReader image(fname + "/" + statName() + "-dir.img");
     fname += "/" + statName() + "-dir.gz";
-    std::ifstream ifs(fname.c_str(), std::ios::binary);
-    if (! ifs.good()) {
-      DBG_( Dev, ( << " saved checkpoint state " << fname << " not found.  Resetting to empty cache. " )  );
-    } else {
-      //ifs >> std::skipws;
-
-      boost::iostreams::filtering_stream<boost::iostreams::input> in;
-      in.push(boost::iostreams::gzip_decompressor());
-      in.push(ifs);
-
-      if ( ! theDirectory->loadState( in, aDirName ) ) {
-        DBG_ ( Dev, ( << "Error loading checkpoint state from file: " << fname <<
+    if (image.good()) {
+      if ( ! theDirectory->loadImage( image ) ) {
+        DBG_ ( Dev, ( << "Error loading directory image for " << statName() <<
                       ".  Make sure your checkpoints match your current cache configuration." ) );
         DBG_Assert ( false );
       }
+    } else {
+      nFlexpoint::FlexpointInput in(fname, cfg.FlexpointThreads);
+      if (! in.good()) {
+        DBG_( Dev, ( << " saved checkpoint state " << fname << " not found.  Resetting to empty cache. " )  );
+      } else {
+        if ( ! theDirectory->loadState( in.stream(), aDirName ) ) {
+          DBG_ ( Dev, ( << "Error loading checkpoint state from file: " << fname <<
+                        ".  Make sure your checkpoints match your current cache configuration." ) );
+          DBG_Assert ( false );
+        }
+      }
     }
     DBG_(Dev, ( << " Directory state loaded"));
     std::string c_fname( aDirName);
+    nCacheImage::ImageReader c_image(c_fname + "/" + statName() + "-cache.img");
     c_fname += "/" + statName() + "-cache.gz";
-    std::ifstream c_ifs(c_fname.c_str(), std::ios::binary);
-    if (! c_ifs.good()) {
-      DBG_( Dev, ( << " saved checkpoint state " << c_fname << " not found.  Resetting to empty cache. " )  );
-    } else {
-      //ifs >> std::skipws;
-
-      boost::iostreams::filtering_stream<boost::iostreams::input> c_in;
-      c_in.push(boost::iostreams::gzip_decompressor());
-      c_in.push(c_ifs);
-
-      if ( ! theCache->loadState( c_in ) ) {
-        DBG_ ( Dev, ( << "Error loading checkpoint state from file: " << c_fname <<
+    if (c_image.good()) {
+      if ( ! theCache->loadImage( c_image ) ) {
+        DBG_ ( Dev, ( << "Error loading cache image for " << statName() <<
                       ".  Make sure your checkpoints match your current cache configuration." ) );
         DBG_Assert ( false );
       }
+    } else {
+      nFlexpoint::FlexpointInput c_in(c_fname, cfg.FlexpointThreads);
+      if (! c_in.good()) {
+        DBG_( Dev, ( << " saved checkpoint state " << c_fname << " not found.  Resetting to empty cache. " )  );
+      } else {
+        if ( ! theCache->loadState( c_in.stream() ) ) {
+          DBG_ ( Dev, ( << "Error loading checkpoint state from file: " << c_fname <<
+                        ".  Make sure your checkpoints match your current cache configuration." ) );
+          DBG_Assert ( false );
+        }
+      }
     }
     DBG_(Dev, ( << " Cache state loaded"));
   }
@@ -293,6 +293,36 @@ public:
     return true;
   }
 
+  bool saveImage( std::string const & aFileName ) {
+    std::vector<StdDirEntryExtendedSerializer> entries;
+    entries.reserve(theDirectory.size());
+    inf_directory_t::iterator iter = theDirectory.begin();
+    for (; iter != theDirectory.end(); iter++) {
+      entries.push_back(iter->second->getSerializer());
+    }
+
+    nCacheImage::ImageWriter image(aFileName);
+    image.section(0, 0, entries);
+    DBG_Assert( image.good(), ( << "Failed to write directory image " << aFileName ));
+    return true;
+  }
+
+  bool loadImage( nCacheImage::ImageReader & anImage ) {
+    uint64_t count = 0;
+    StdDirEntryExtendedSerializer const * entries = anImage.section<StdDirEntryExtendedSerializer>(0, 0, count);
+    if (entries == nullptr) {
+      return false;
+    }
+
+    DBG_(Trace, ( << "Directory loading " << count << " entries." ));
+    for (uint64_t i = 0; i < count; i++) {
+      if (entries[i].state.any()) {
+        theDirectory.insert( std::pair<PhysicalMemoryAddress, InfiniteDirectoryEntry *>(PhysicalMemoryAddress(entries[i].tag), new InfiniteDirectoryEntry(entries[i])));
+      }
+    }
+    return true;
+  }
+
   static AbstractDirectory * createInstance(std::list<std::pair<std::string, std::string> > &args) {
     InfiniteDirectory * directory = new InfiniteDirectory();
 
@@ -378,8 +378,6 @@ public:
 private:
   // Private data
 
-  bool theTraceTrackerFlag;
-
   std::string theName;
 
   int32_t theBlockSize;
@@ -1474,24 +1472,7 @@ public:
           DBG_(Trace, ( << "Loading block " << std::hex << bs.tag << " in state " << bs.state << std::dec << " in set " << set << ", way " << way ));
         }
 
-        if (bstate != kInvalid) {
-          uint64_t rt_tag = get_rt_tag(bs.tag);
-          int rt_set_index  = get_rt_set(bs.tag);
-          int32_t offset    = get_block_offset(bs.tag);
-
-          rt_set_t * rt_set = &(theRVA[rt_set_index]);
-          rt_index * rt  = &(rt_set->get<by_tag>());
-          rt_iterator entry = rt->find(rt_tag);
-          rt_iterator end  = rt->end();
-          if (entry == end) {
-            rt_set = &theERB;
-            rt  = &(rt_set->get<by_tag>());
-            entry = rt->find(rt_tag);
-            end  = rt->end();
-            DBG_Assert(entry != end);
-          }
-          rt->modify(entry, AllocateBlock(offset, bstate, way));
-        }
+        linkLoadedBlock(bs.tag, bstate, way);
         DBG_Assert( isConsistent(bs.tag) );
       }
     }
@@ -1499,6 +1480,190 @@ public:
     return true;
   }
 
+  virtual bool saveImage( std::string const & aFileName ) {
+    nCacheImage::ImageWriter image(aFileName);
+
+    // RT sets from MRU to LRU, padded with the same empty regions as saveState
+    std::vector<RTSerializer> regions(theNumRTSets * theRTAssociativity);
+    RTSerializer * serial = regions.data();
+    for (int32_t set = 0; set < theNumRTSets; set++) {
+      rt_order_iterator entry = theRVA[set].get<by_order>().begin();
+      rt_order_iterator end = theRVA[set].get<by_order>().end();
+      int32_t way = 0;
+      for (; entry != end; entry++, way++, serial++) {
+        *serial = regionToImage(*entry);
+      }
+      for (; way < theRTAssociativity; way++, serial++) {
+        serial->tag = -1;
+        serial->owner = -1;
+        serial->way = way;
+        serial->state = 'S';
+      }
+    }
+    image.section(theNumRTSets, theRTAssociativity, regions);
+
+    regions.clear();
+    rt_order_iterator entry = theERB.get<by_order>().begin();
+    rt_order_iterator end = theERB.get<by_order>().end();
+    for (; entry != end; entry++) {
+      regions.push_back(regionToImage(*entry));
+    }
+    image.section(0, 0, regions);
+
+    std::vector<BlockSerializer> blocks(theNumDataSets * theAssociativity);
+    BlockSerializer * bs = blocks.data();
+    for (int32_t set = 0; set < theNumDataSets; set++) {
+      order_iterator block = theBlocks[set].get<by_order>().begin();
+      order_iterator end = theBlocks[set].get<by_order>().end();
+      int32_t way = 0;
+      for (; block != end; block++, way++, bs++) {
+        bs->tag = block->tag;
+        bs->way = block->way;
+        bs->state = stateToImage(block->state);
+      }
+      for (; way < theAssociativity; way++, bs++) {
+        bs->tag = 0;
+        bs->way = way;
+        bs->state = (uint8_t)'I';
+      }
+    }
+    image.section(theNumDataSets, theAssociativity, blocks);
+
+    DBG_Assert( image.good(), ( << "Failed to write cache image " << aFileName ));
+    return true;
+  }
+
+  virtual bool loadImage( nCacheImage::ImageReader & anImage ) {
+    uint64_t count = 0;
+    RTSerializer const * serial = anImage.section<RTSerializer>(theNumRTSets, theRTAssociativity, count);
+    if (serial == nullptr || count != (uint64_t)theNumRTSets * theRTAssociativity) {
+      return false;
+    }
+    for (int32_t set = 0; set < theNumRTSets; set++) {
+      for (int32_t way = 0; way < theRTAssociativity; way++, serial++) {
+        theRVA[set].get<by_order>().push_back(RTEntry(theBlocksPerRegion, serial->tag, way, regionFromImage(serial->state), serial->owner));
+      }
+    }
+
+    serial = anImage.section<RTSerializer>(0, 0, count);
+    if (serial == nullptr) {
+      return false;
+    }
+    for (uint64_t way = 0; way < count; way++, serial++) {
+      theERB.get<by_order>().push_back(RTEntry(theBlocksPerRegion, serial->tag, way, regionFromImage(serial->state), serial->owner));
+    }
+
+    BlockSerializer const * bs = anImage.section<BlockSerializer>(theNumDataSets, theAssociativity, count);
+    if (bs == nullptr || count != (uint64_t)theNumDataSets * theAssociativity) {
+      return false;
+    }
+    for (int32_t set = 0; set < theNumDataSets; set++) {
+      for (int32_t way = 0; way < theAssociativity; way++, bs++) {
+        CoherenceState_t bstate = stateFromImage(bs->state);
+        theBlocks[set].get<by_order>().push_back(BlockEntry(bs->tag, bstate, way));
+        linkLoadedBlock(bs->tag, bstate, way);
+        DBG_Assert( isConsistent(bs->tag) );
+      }
+    }
+    return true;
+  }
+
+private:
+  // Marks a freshly loaded valid block as present in its region entry,
+  // which is either in the RT or in the ERB.
+  void linkLoadedBlock(uint64_t aTag, CoherenceState_t aState, int32_t aWay) {
+    if (aState == kInvalid) {
+      return;
+    }
+    uint64_t rt_tag = get_rt_tag(aTag);
+    int rt_set_index  = get_rt_set(aTag);
+    int32_t offset    = get_block_offset(aTag);
+
+    rt_set_t * rt_set = &(theRVA[rt_set_index]);
+    rt_index * rt  = &(rt_set->get<by_tag>());
+    rt_iterator entry = rt->find(rt_tag);
+    rt_iterator end  = rt->end();
+    if (entry == end) {
+      rt_set = &theERB;
+      rt  = &(rt_set->get<by_tag>());
+      entry = rt->find(rt_tag);
+      end  = rt->end();
+      DBG_Assert(entry != end);
+    }
+    rt->modify(entry, AllocateBlock(offset, aState, aWay));
+  }
+
+  static RTSerializer regionToImage(RTEntry const & anEntry) {
+    RTSerializer serial = RTSerializer();
+    serial.tag = anEntry.tag;
+    serial.owner = anEntry.owner;
+    serial.way = anEntry.way;
+    switch (anEntry.region_state) {
+      case NON_SHARED_REGION:
+        serial.state = 'N';
+        break;
+      case SHARED_REGION:
+        serial.state = 'S';
+        break;
+      case PARTIAL_SHARED_REGION:
+        serial.state = 'P';
+        break;
+      default:
+        DBG_Assert(false, ( << "Don't know how to save state " << (int)anEntry.region_state ));
+        break;
+    }
+    return serial;
+  }
+
+  static RegionState regionFromImage(uint8_t aState) {
+    switch (aState) {
+      case 'N':
+        return NON_SHARED_REGION;
+      case 'S':
+        return SHARED_REGION;
+      case 'P':
+        return PARTIAL_SHARED_REGION;
+      default:
+        DBG_Assert(false, ( << "Unknown RegionState: " << aState));
+        return SHARED_REGION;
+    }
+  }
+
+  static uint8_t stateToImage(CoherenceState_t aState) {
+    switch (aState) {
+      case kModified:
+        return (uint8_t)'M';
+      case kOwned:
+        return (uint8_t)'O';
+      case kExclusive:
+        return (uint8_t)'E';
+      case kShared:
+        return (uint8_t)'S';
+      case kInvalid:
+        return (uint8_t)'I';
+      default:
+        DBG_Assert(false, ( << "Don't know how to save state " << aState ));
+        return (uint8_t)'I';
+    }
+  }
+
+  static CoherenceState_t stateFromImage(uint8_t aState) {
+    switch (aState) {
+      case (uint8_t)'M':
+        return kModified;
+      case (uint8_t)'O':
+        return kOwned;
+      case (uint8_t)'E':
+        return kExclusive;
+      case (uint8_t)'S':
+        return kShared;
+      case (uint8_t)'I':
+        return kInvalid;
+      default:
+        DBG_Assert(false, ( << "Unknown Block State: " << (uint8_t)aState));
+        return kInvalid;
+    }
+  }
 };
 
 };  // namespace nFastCMPCache
@@ -73,7 +73,15 @@ private:
     MinSharers
   } theReplPolicy;
 
-  std::vector<std::vector<StandardDirectoryEntry> > theDirectory;
+  // Entries are stored theAssociativity consecutive ways per set and never
+  // move.  Recency is tracked by a per-way age: 0 is MRU, theAssociativity-1
+  // is LRU, and the ages within a set are always a permutation.
+  std::vector<StandardDirectoryEntry> theDirectory;
+  std::vector<PhysicalMemoryAddress> theTags;
+  std::vector<uint8_t> theAges;
+
+  // One wrapper per way, handed out by lookup() instead of allocating a new one
+  std::vector<BlockEntryWrapper_p> theWrappers;
 
   StandardDirectory() : AbstractDirectory(), theReplPolicy(LRURepl) {};
 
@@ -83,8 +91,16 @@ private:
 
     DBG_Assert( theNumSets > 0 );
     DBG_Assert( theAssociativity > 0 );
-
-    theDirectory.resize(theNumSets, std::vector<StandardDirectoryEntry>(theAssociativity, StandardDirectoryEntry()));
+    DBG_Assert( theAssociativity <= 256, ( << "StandardDirectory supports at most 256 ways" ));
+
+    theDirectory.resize(theNumSets * theAssociativity);
+    theTags.resize(theNumSets * theAssociativity, PhysicalMemoryAddress(0));
+    theAges.resize(theNumSets * theAssociativity);
+    theWrappers.resize(theNumSets * theAssociativity);
+    for (int32_t i = 0; i < theNumSets * theAssociativity; i++) {
+      theAges[i] = i % theAssociativity;
+      theWrappers[i] = new BlockEntryWrapper(theDirectory[i]);
+    }
 
     theSetMask = theNumSets - 1;
 
@@ -119,17 +135,17 @@ private:
 
 protected:
   virtual void addSharer(int32_t index, AbstractEntry_p dir_entry, PhysicalMemoryAddress address) {
-    //StandardDirectoryEntry *my_entry = dynamic_cast<StandardDirectoryEntry*>(dir_entry);
-    StandardDirectoryEntry * my_entry(&(dynamic_cast<BlockEntryWrapper *>(dir_entry.get())->block));
+    // Every entry we hand out from lookup() is a BlockEntryWrapper
+    StandardDirectoryEntry * my_entry(&(static_cast<BlockEntryWrapper *>(dir_entry.get())->block));
     if (my_entry == nullptr) {
-      my_entry = findOrCreateEntry(address);
+      my_entry = &theDirectory[findOrCreateEntry(address)];
     }
     my_entry->addSharer(index);
   }
 
   virtual void addExclusiveSharer(int32_t index, AbstractEntry_p dir_entry, PhysicalMemoryAddress address) {
-    //StandardDirectoryEntry *my_entry = dynamic_cast<StandardDirectoryEntry*>(dir_entry);
-    StandardDirectoryEntry * my_entry(&(dynamic_cast<BlockEntryWrapper *>(dir_entry.get())->block));
+    // Every entry we hand out from lookup() is a BlockEntryWrapper
+    StandardDirectoryEntry * my_entry(&(static_cast<BlockEntryWrapper *>(dir_entry.get())->block));
     DBG_Assert(my_entry != nullptr);
     my_entry->addSharer(index);
     my_entry->makeExclusive(index);
@@ -141,8 +157,8 @@ protected:
   }
 
   virtual void removeSharer(int32_t index, AbstractEntry_p dir_entry, PhysicalMemoryAddress address) {
-    //StandardDirectoryEntry *my_entry = dynamic_cast<StandardDirectoryEntry*>(dir_entry);
-    StandardDirectoryEntry * my_entry(&(dynamic_cast<BlockEntryWrapper *>(dir_entry.get())->block));
+    // Every entry we hand out from lookup() is a BlockEntryWrapper
+    StandardDirectoryEntry * my_entry(&(static_cast<BlockEntryWrapper *>(dir_entry.get())->block));
     if (my_entry == nullptr) {
       return;
     }
@@ -150,8 +166,8 @@ protected:
   }
 
   virtual void makeSharerExclusive(int32_t index, AbstractEntry_p dir_entry, PhysicalMemoryAddress address) {
-    //StandardDirectoryEntry *my_entry = dynamic_cast<StandardDirectoryEntry*>(dir_entry);
-    StandardDirectoryEntry * my_entry(&(dynamic_cast<BlockEntryWrapper *>(dir_entry.get())->block));
+    // Every entry we hand out from lookup() is a BlockEntryWrapper
+    StandardDirectoryEntry * my_entry(&(static_cast<BlockEntryWrapper *>(dir_entry.get())->block));
     if (my_entry == nullptr) {
       return;
     }
@@ -159,36 +175,62 @@ protected:
     my_entry->makeExclusive(index);
   }
 
-  StandardDirectoryEntry * findOrCreateEntry(PhysicalMemoryAddress addr, bool make_lru = true) {
-    int32_t min_sharers = INT_MAX;
-    int32_t min_way = -1;
-    int32_t set = get_set(addr);
+  // Make way the MRU entry of the set starting at base
+  void touch(int32_t base, int32_t way) {
+    uint8_t age = theAges[base + way];
+    for (int32_t i = base; i < base + theAssociativity; i++) {
+      theAges[i] += (theAges[i] < age) ? 1 : 0;
+    }
+    theAges[base + way] = 0;
+  }
+
+  // Returns the index of addr's entry, or the index of the victim to replace if addr is not present
+  int32_t findOrCreateEntry(PhysicalMemoryAddress addr, bool make_lru = true) {
+    int32_t base = get_set(addr) * theAssociativity;
     for (int32_t way = 0; way < theAssociativity; way++) {
-      if (theDirectory[set][way].tag() == addr) {
+      if (theTags[base + way] == addr) {
         if (make_lru) {
-          std::vector<StandardDirectoryEntry>::iterator iter = theDirectory[set].begin();
-          std::rotate(iter, iter + way, iter + way + 1);
-          way = 0;
+          touch(base, way);
+        }
+        return base + way;
+      }
+    }
+
+    // LRURepl: the least recently used entry with no sharers, or the LRU entry
+    // MinSharers: the most recently used of the entries with the fewest sharers
+    int32_t victim = -1;
+    int32_t lru_way = 0;
+    int32_t victim_age = -1;
+    int32_t min_sharers = INT_MAX;
+    for (int32_t way = 0; way < theAssociativity; way++) {
+      int32_t age = theAges[base + way];
+      StandardDirectoryEntry & entry = theDirectory[base + way];
+      if (age == theAssociativity - 1) {
+        lru_way = way;
+      }
+      if (theReplPolicy == LRURepl) {
+        if (entry.state() == ZeroSharers && age > victim_age) {
+          victim = way;
+          victim_age = age;
+        }
+      } else {
+        int32_t sharers = entry.sharers().countSharers();
+        if (sharers < min_sharers || (sharers == min_sharers && age < victim_age)) {
+          victim = way;
+          victim_age = age;
+          min_sharers = sharers;
         }
-        return &(theDirectory[set][way]);
-      } else if (theReplPolicy == LRURepl && theDirectory[set][way].state() == ZeroSharers) {
-        min_way = way;
-      } else if (theReplPolicy == MinSharers && theDirectory[set][way].sharers().countSharers() < min_sharers) {
-        min_way = way;
-        min_sharers = theDirectory[set][way].sharers().countSharers();
       }
     }
 
-    if (min_way == -1) {
-      min_way = theAssociativity - 1;
+    if (victim == -1) {
+      victim = lru_way;
     }
     if (make_lru) {
-      std::vector<StandardDirectoryEntry>::iterator iter = theDirectory[set].begin();
-      std::rotate(iter, iter + min_way, iter + min_way + 1);
-      min_way = 0;
+      touch(base, victim);
     }
 
-    return &(theDirectory[set][min_way]);
+    return base + victim;
   }
 
 public:
@@ -200,15 +242,18 @@ public:
   virtual std::tuple<SharingVector, SharingState, AbstractEntry_p>
   lookup(int32_t index, PhysicalMemoryAddress address, MMType req_type, std::list<std::function<void(void)> > &xtra_actions) {
 
-    StandardDirectoryEntry * entry = findOrCreateEntry(address, !MemoryMessage::isEvictType(req_type));
-    DBG_Assert(entry != nullptr);
+    int32_t entry_index = findOrCreateEntry(address, !MemoryMessage::isEvictType(req_type));
+    StandardDirectoryEntry * entry = &theDirectory[entry_index];
     if (entry->tag() != address) {
       // We're evicting an existing entry
-      xtra_actions.push_back([&entry, this](){ theInvalidateAction(entry->tag(), entry->sharers());});
+      PhysicalMemoryAddress victim_tag = entry->tag();
+      SharingVector victim_sharers = entry->sharers();
+      xtra_actions.push_back([victim_tag, victim_sharers, this](){ theInvalidateAction(victim_tag, victim_sharers);});
       entry->reset(address);
+      theTags[entry_index] = address;
     }
 
-    BlockEntryWrapper_p wrapper(new BlockEntryWrapper(*entry));
+    AbstractEntry_p wrapper(theWrappers[entry_index]);
 
     return std::tie(entry->sharers(), entry->state(), wrapper);
   }
@@ -216,8 +261,8 @@ public:
   virtual std::tuple<SharingVector, SharingState, AbstractEntry_p, bool>
   snoopLookup(int32_t index, PhysicalMemoryAddress address, MMType req_type) {
 
-    StandardDirectoryEntry * entry = findOrCreateEntry(address, false);
-    DBG_Assert(entry != nullptr);
+    int32_t entry_index = findOrCreateEntry(address, false);
+    StandardDirectoryEntry * entry = &theDirectory[entry_index];
 
     bool valid = true;
     if (entry->tag() != address) {
@@ -228,7 +273,7 @@ public:
       return std::tie(sharers, state, wrapper, valid);
     }
 
-    BlockEntryWrapper_p wrapper(new BlockEntryWrapper(*entry));
+    AbstractEntry_p wrapper(theWrappers[entry_index]);
 
     return std::tie(entry->sharers(), entry->state(), wrapper, valid);
   }
@@ -241,10 +286,16 @@ public:
     oa << set_count;
     oa << associativity;
 
+    // Each set is written from MRU to LRU
     StdDirEntrySerializer serializer;
+    std::vector<int32_t> order(theAssociativity);
     for (int32_t set = 0; set < theNumSets; set++) {
+      int32_t base = set * theAssociativity;
       for (int32_t way = 0; way < theAssociativity; way++) {
-        serializer = theDirectory[set][way].getSerializer();
+        order[theAges[base + way]] = base + way;
+      }
+      for (int32_t i = 0; i < theAssociativity; i++) {
+        serializer = theDirectory[order[i]].getSerializer();
         DBG_(Trace, ( << "Directory saving block " << serializer ));
         oa << serializer;
       }
@@ -266,9 +317,47 @@ public:
     StdDirEntrySerializer serializer;
     for (int32_t set = 0; set < theNumSets; set++) {
       for (int32_t way = 0; way < theAssociativity; way++) {
+        int32_t index = set * theAssociativity + way;
         ia >> serializer;
-        theDirectory[set][way] = serializer;
+        theDirectory[index] = serializer;
+        theTags[index] = theDirectory[index].tag();
+        theAges[index] = way;
+      }
+    }
+    return true;
+  }
+
+  bool saveImage( std::string const & aFileName ) {
+    // Same MRU to LRU order as saveState
+    std::vector<StdDirEntrySerializer> entries(theNumSets * theAssociativity);
+    std::vector<int32_t> order(theAssociativity);
+    for (int32_t set = 0; set < theNumSets; set++) {
+      int32_t base = set * theAssociativity;
+      for (int32_t way = 0; way < theAssociativity; way++) {
+        order[theAges[base + way]] = base + way;
       }
+      for (int32_t i = 0; i < theAssociativity; i++) {
+        entries[base + i] = theDirectory[order[i]].getSerializer();
+      }
+    }
+
+    nCacheImage::ImageWriter image(aFileName);
+    image.section(theNumSets, theAssociativity, entries);
+    DBG_Assert( image.good(), ( << "Failed to write directory image " << aFileName ));
+    return true;
+  }
+
+  bool loadImage( nCacheImage::ImageReader & anImage ) {
+    uint64_t count = 0;
+    StdDirEntrySerializer const * entries = anImage.section<StdDirEntrySerializer>(theNumSets, theAssociativity, count);
+    if (entries == nullptr || count != theDirectory.size()) {
+      return false;
+    }
+
+    for (uint64_t index = 0; index < count; index++) {
+      theDirectory[index] = entries[index];
+      theTags[index] = theDirectory[index].tag();
+      theAges[index] = index % theAssociativity;
     }
     return true;
   }
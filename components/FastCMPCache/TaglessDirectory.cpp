@@ -40,8 +40,35 @@ struct TaglessDirectoryBucket : public AbstractDirectoryEntry {
   inf_directory_t  thePreciseDirectory;
 };
 
+static const int32_t kMaxTaglessHashes = 8;
+
+// The buckets an address maps to, one per hash function, as indices into the
+// directory's bucket array
+struct TaglessBucketSpan {
+  int32_t theIndices[kMaxTaglessHashes];
+  int32_t theSize;
+
+  TaglessBucketSpan() : theSize(0) {}
+
+  void push_back(int32_t anIndex) {
+    theIndices[theSize++] = anIndex;
+  }
+  int32_t size() const {
+    return theSize;
+  }
+  int32_t operator[](int32_t i) const {
+    return theIndices[i];
+  }
+  const int32_t * begin() const {
+    return theIndices;
+  }
+  const int32_t * end() const {
+    return theIndices + theSize;
+  }
+};
+
 struct TaglessLookupResult : public AbstractDirectoryEntry {
-  std::list<TaglessDirectoryBucket *> theBuckets;
+  TaglessBucketSpan theBuckets;
   BlockDirectoryEntry_p theTrueState;
   BlockDirectoryEntry theTaglessState;
 };
@@ -63,13 +90,10 @@ private:
   int32_t theSetShift;
   int32_t theSetMask;
 
-  std::vector<std::vector<TaglessDirectoryBucket> > theDirectory;
-
-  TaglessDirectory() : AbstractDirectory(), theTrackCollisions(false), theTrackBitCounts(false), theTrackBitPatterns(false), thePartitioned(true) {};
+  // All buckets, theTotalNumBuckets consecutive entries per set
+  std::vector<TaglessDirectoryBucket> theDirectory;
 
-  typedef std::function<int(uint64_t)> hash_fn_t;
-
-  std::list<hash_fn_t> hash_fns;
+  TaglessDirectory() : AbstractDirectory(), theTrackCollisions(false), theTrackBitCounts(false), theTrackBitPatterns(false), thePartitioned(true), theNumHashes(0) {};
 
   int32_t theHashShift;
   int32_t theHashMask;
@@ -80,42 +104,37 @@ private:
   int32_t theFreeBits;
   int32_t theNumPatterns;
 
-  Flexus::Stat::StatCounter * theDestructiveCollisions;
-  Flexus::Stat::StatCounter * theConstructiveCollisions;
-  Flexus::Stat::StatCounter * theNonCollisions;
-
-#define DEFINE_COLLISION_COUNTERS(type)           \
- Flexus::Stat::StatCounter *the ## type ## Collisions_All;     \
- Flexus::Stat::StatCounter *the ## type ## Collisions_OnChip_Read;   \
- Flexus::Stat::StatCounter *the ## type ## Collisions_OnChip_Fetch;  \
- Flexus::Stat::StatCounter *the ## type ## Collisions_OnChip_Write;  \
- Flexus::Stat::StatCounter *the ## type ## Collisions_OnChip_Upgrade;  \
- Flexus::Stat::StatCounter *the ## type ## Collisions_OnChip_Evict;  \
- Flexus::Stat::StatCounter *the ## type ## Collisions_OnChip_Other;  \
- Flexus::Stat::StatCounter *the ## type ## Collisions_OffChip_Read;  \
- Flexus::Stat::StatCounter *the ## type ## Collisions_OffChip_Fetch;  \
- Flexus::Stat::StatCounter *the ## type ## Collisions_OffChip_Write;  \
- Flexus::Stat::StatCounter *the ## type ## Collisions_OffChip_Upgrade;  \
- Flexus::Stat::StatCounter *the ## type ## Collisions_OffChip_Evict;  \
- Flexus::Stat::StatCounter *the ## type ## Collisions_OffChip_Other;
+  enum CollisionType {
+    eNonCollision,
+    eConstructiveCollision,
+    eDestructiveCollision,
+    kNumCollisionTypes
+  };
+
+  enum RequestClass {
+    eReadClass,
+    eFetchClass,
+    eWriteClass,
+    eUpgradeClass,
+    eEvictClass,
+    eOtherClass,
+    kNumRequestClasses
+  };
+
+  // Collision counters, indexed by [CollisionType][on_chip][RequestClass]
+  Flexus::Stat::StatCounter * theCollisions_All[kNumCollisionTypes];
+  Flexus::Stat::StatCounter * theCollisions[kNumCollisionTypes][2][kNumRequestClasses];
 
   Flexus::Stat::StatInstanceCounter<int64_t> *theExtraBits_All;
-  Flexus::Stat::StatInstanceCounter<int64_t> *theExtraBits_OnChip_Read;
-  Flexus::Stat::StatInstanceCounter<int64_t> *theExtraBits_OnChip_Fetch;
-  Flexus::Stat::StatInstanceCounter<int64_t> *theExtraBits_OnChip_Write;
-  Flexus::Stat::StatInstanceCounter<int64_t> *theExtraBits_OnChip_Upgrade;
-  Flexus::Stat::StatInstanceCounter<int64_t> *theExtraBits_OnChip_Evict;
-  Flexus::Stat::StatInstanceCounter<int64_t> *theExtraBits_OnChip_Other;
-  Flexus::Stat::StatInstanceCounter<int64_t> *theExtraBits_OffChip_Read;
-  Flexus::Stat::StatInstanceCounter<int64_t> *theExtraBits_OffChip_Fetch;
-  Flexus::Stat::StatInstanceCounter<int64_t> *theExtraBits_OffChip_Write;
-  Flexus::Stat::StatInstanceCounter<int64_t> *theExtraBits_OffChip_Upgrade;
-  Flexus::Stat::StatInstanceCounter<int64_t> *theExtraBits_OffChip_Evict;
-  Flexus::Stat::StatInstanceCounter<int64_t> *theExtraBits_OffChip_Other;
-
-  DEFINE_COLLISION_COUNTERS(Non)
-  DEFINE_COLLISION_COUNTERS(Destructive)
-  DEFINE_COLLISION_COUNTERS(Constructive)
+  Flexus::Stat::StatInstanceCounter<int64_t> *theExtraBits[2][kNumRequestClasses];
+
+  // Collision statistics are accumulated here on every lookup and only
+  // pushed to the StatCounters when updateStats() is called
+  bool theStatsPending;
+  int64_t thePendingCollisions[kNumCollisionTypes][2][kNumRequestClasses];
+  std::vector<int64_t> thePendingExtraBits[2][kNumRequestClasses];
+  std::vector<int64_t> thePendingBitCounts;
+  std::vector<int64_t> thePendingBitPatterns;
 
   Flexus::Stat::StatCounter ** theBitCounters;
 
@@ -131,25 +150,31 @@ private:
     eOverlapHash,
     ePrimeModuloHash,
     eRotatedPrimeHash,
-    eFullPrimeHash
+    eFullPrimeHash,
+    eShiftHash,
+    eMatrixHash
   };
 
   std::list<std::string> theHashPolicyList;
 
-#define INITIALIZE_COLLISION_COUNTERS(type)                       \
- the ## type ## Collisions_All = new Flexus::Stat::StatCounter(aName + "-Collisions:" + #type + ":All");       \
- the ## type ## Collisions_OnChip_Read = new Flexus::Stat::StatCounter(aName + "-Collisions:" + #type + ":OnChip:Read");   \
- the ## type ## Collisions_OnChip_Fetch = new Flexus::Stat::StatCounter(aName + "-Collisions:" + #type + ":OnChip:Fetch");  \
- the ## type ## Collisions_OnChip_Write = new Flexus::Stat::StatCounter(aName + "-Collisions:" + #type + ":OnChip:Write");  \
- the ## type ## Collisions_OnChip_Upgrade = new Flexus::Stat::StatCounter(aName + "-Collisions:" + #type + ":OnChip:Upgrade"); \
- the ## type ## Collisions_OnChip_Evict = new Flexus::Stat::StatCounter(aName + "-Collisions:" + #type + ":OnChip:Evict");  \
- the ## type ## Collisions_OnChip_Other = new Flexus::Stat::StatCounter(aName + "-Collisions:" + #type + ":OnChip:Other");  \
- the ## type ## Collisions_OffChip_Read = new Flexus::Stat::StatCounter(aName + "-Collisions:" + #type + ":OffChip:Read");  \
- the ## type ## Collisions_OffChip_Fetch = new Flexus::Stat::StatCounter(aName + "-Collisions:" + #type + ":OffChip:Fetch");  \
- the ## type ## Collisions_OffChip_Write = new Flexus::Stat::StatCounter(aName + "-Collisions:" + #type + ":OffChip:Write");  \
- the ## type ## Collisions_OffChip_Upgrade = new Flexus::Stat::StatCounter(aName + "-Collisions:" + #type + ":OffChip:Upgrade"); \
- the ## type ## Collisions_OffChip_Evict = new Flexus::Stat::StatCounter(aName + "-Collisions:" + #type + ":OffChip:Evict");  \
- the ## type ## Collisions_OffChip_Other = new Flexus::Stat::StatCounter(aName + "-Collisions:" + #type + ":OffChip:Other");
+  static RequestClass requestClass(MMType req_type) {
+    switch (req_type) {
+      case MemoryMessage::ReadReq:
+        return eReadClass;
+      case MemoryMessage::FetchReq:
+        return eFetchClass;
+      case MemoryMessage::UpgradeReq:
+        return eUpgradeClass;
+      case MemoryMessage::WriteReq:
+        return eWriteClass;
+      case MemoryMessage::EvictClean:
+      case MemoryMessage::EvictWritable:
+      case MemoryMessage::EvictDirty:
+        return eEvictClass;
+      default:
+        return eOtherClass;
+    }
+  }
 
   virtual void initialize(const std::string & aName) {
 
@@ -161,14 +186,6 @@ private:
 
     DBG_Assert( theHashPolicyList.size() > 0, ( << "No hash policy given." ));
 
-    if (thePartitioned) {
-      theTotalNumBuckets = theHashPolicyList.size() * theNumBuckets;
-    } else {
-      theTotalNumBuckets = theNumBuckets;
-    }
-
-    theDirectory.resize(theNumSets, std::vector<TaglessDirectoryBucket>(theTotalNumBuckets, TaglessDirectoryBucket() ));
-
     theSetMask = theNumSets - 1;
     theSetShift = log_base2(theBlockSize);
 
@@ -177,32 +194,47 @@ private:
     theHashBits = log_base2(theNumBuckets);
     theTagBits = 34 - theHashBits;
 
-    DBG_(Dev, ( << "Created Tagless Directory with " << theNumSets << " sets and " << theTotalNumBuckets << (thePartitioned ? " partitioned " : " ") << "buckets" ));
     DBG_(Dev, ( << "SetShift = " << theSetShift << ", HashShift = " << theHashShift << ", SetMask = " << std::hex << theSetMask << ", HashMask = " << theHashMask ));
     std::list<std::string>::iterator iter = theHashPolicyList.begin();
     for (; iter != theHashPolicyList.end(); iter++) {
       createHashPolicy(*iter);
     }
 
+    // Size the directory once the hash policies have settled theNumBuckets
+    if (thePartitioned) {
+      theTotalNumBuckets = theNumHashes * theNumBuckets;
+    } else {
+      theTotalNumBuckets = theNumBuckets;
+    }
+    theDirectory.resize(theNumSets * theTotalNumBuckets);
+
+    DBG_(Dev, ( << "Created Tagless Directory with " << theNumSets << " sets and " << theTotalNumBuckets << (thePartitioned ? " partitioned " : " ") << "buckets" ));
+
     // Initialize Stats
     if (theTrackCollisions) {
-      INITIALIZE_COLLISION_COUNTERS(Non)
-      INITIALIZE_COLLISION_COUNTERS(Destructive)
-      INITIALIZE_COLLISION_COUNTERS(Constructive)
+      static const char * collision_names[kNumCollisionTypes] = { "Non", "Constructive", "Destructive" };
+      static const char * location_names[2] = { "OffChip", "OnChip" };
+      static const char * class_names[kNumRequestClasses] = { "Read", "Fetch", "Write", "Upgrade", "Evict", "Other" };
+
+      for (int32_t type = 0; type < kNumCollisionTypes; type++) {
+        std::string prefix = aName + "-Collisions:" + collision_names[type];
+        theCollisions_All[type] = new Flexus::Stat::StatCounter(prefix + ":All");
+        for (int32_t on_chip = 1; on_chip >= 0; on_chip--) {
+          for (int32_t req = 0; req < kNumRequestClasses; req++) {
+            theCollisions[type][on_chip][req] = new Flexus::Stat::StatCounter(prefix + ":" + location_names[on_chip] + ":" + class_names[req]);
+            thePendingCollisions[type][on_chip][req] = 0;
+          }
+        }
+      }
 
       theExtraBits_All = new Flexus::Stat::StatInstanceCounter<int64_t>(aName + "-ExtraBits:All");
-      theExtraBits_OnChip_Read = new Flexus::Stat::StatInstanceCounter<int64_t>(aName + "-ExtraBits:OnChip:Read");
-      theExtraBits_OnChip_Fetch = new Flexus::Stat::StatInstanceCounter<int64_t>(aName + "-ExtraBits:OnChip:Fetch");
-      theExtraBits_OnChip_Write = new Flexus::Stat::StatInstanceCounter<int64_t>(aName + "-ExtraBits:OnChip:Write");
-      theExtraBits_OnChip_Upgrade = new Flexus::Stat::StatInstanceCounter<int64_t>(aName + "-ExtraBits:OnChip:Upgrade");
-      theExtraBits_OnChip_Evict = new Flexus::Stat::StatInstanceCounter<int64_t>(aName + "-ExtraBits:OnChip:Evict");
-      theExtraBits_OnChip_Other = new Flexus::Stat::StatInstanceCounter<int64_t>(aName + "-ExtraBits:OnChip:Other");
-      theExtraBits_OffChip_Read = new Flexus::Stat::StatInstanceCounter<int64_t>(aName + "-ExtraBits:OffChip:Read");
-      theExtraBits_OffChip_Fetch = new Flexus::Stat::StatInstanceCounter<int64_t>(aName + "-ExtraBits:OffChip:Fetch");
-      theExtraBits_OffChip_Write = new Flexus::Stat::StatInstanceCounter<int64_t>(aName + "-ExtraBits:OffChip:Write");
-      theExtraBits_OffChip_Upgrade = new Flexus::Stat::StatInstanceCounter<int64_t>(aName + "-ExtraBits:OffChip:Upgrade");
-      theExtraBits_OffChip_Evict = new Flexus::Stat::StatInstanceCounter<int64_t>(aName + "-ExtraBits:OffChip:Evict");
-      theExtraBits_OffChip_Other = new Flexus::Stat::StatInstanceCounter<int64_t>(aName + "-ExtraBits:OffChip:Other");
+      for (int32_t on_chip = 1; on_chip >= 0; on_chip--) {
+        for (int32_t req = 0; req < kNumRequestClasses; req++) {
+          theExtraBits[on_chip][req] = new Flexus::Stat::StatInstanceCounter<int64_t>(aName + "-ExtraBits:" + location_names[on_chip] + ":" + class_names[req]);
+          thePendingExtraBits[on_chip][req].assign(MAX_NUM_SHARERS + 1, 0);
+        }
+      }
+      theStatsPending = false;
 
       thePerSetCollisions = new Flexus::Stat::StatInstanceCounter<int64_t>(aName + "-Collisions:PerSet");
       thePerBucketCollisions = new Flexus::Stat::StatInstanceCounter<int64_t>(aName + "-Collisions:PerBucket");
@@ -215,6 +247,7 @@ private:
         for (int32_t i = 0; i < theFreeBits; i++) {
           theBitCounters[i] = new Flexus::Stat::StatCounter(aName + "-BitUsed:" + std::to_string(i));
         }
+        thePendingBitCounts.assign(theFreeBits, 0);
       }
 
       if (theTrackBitPatterns) {
@@ -227,102 +260,16 @@ private:
                 + std::to_string(i) + ":" + std::to_string(j) );
           }
         }
+        thePendingBitPatterns.assign(theNumPatterns * theNumBuckets, 0);
       }
     }
   }
 
-#define RECORD_COLLISION_FN(type) \
- void record ## type ## Collision(MMType req_type, bool on_chip) {         \
-  (*the ## type ## Collisions_All)++;                \
-  if (on_chip) {                     \
-   switch(req_type) {                   \
-   case MemoryMessage::ReadReq: (*the ## type ## Collisions_OnChip_Read)++; break;  \
-   case MemoryMessage::FetchReq: (*the ## type ## Collisions_OnChip_Fetch)++; break; \
-   case MemoryMessage::UpgradeReq: (*the ## type ## Collisions_OnChip_Upgrade)++; break; \
-   case MemoryMessage::WriteReq: (*the ## type ## Collisions_OnChip_Write)++; break; \
-                          \
-   case MemoryMessage::EvictClean:                \
-   case MemoryMessage::EvictWritable:               \
-   case MemoryMessage::EvictDirty:                \
-    (*the ## type ## Collisions_OnChip_Evict)++;              \
-    break;                     \
-                          \
-   default:                     \
-    (*the ## type ## Collisions_OnChip_Other)++;              \
-    break;                     \
-   }                       \
-  } else {                      \
-   switch(req_type) {                   \
-   case MemoryMessage::ReadReq: (*the ## type ## Collisions_OffChip_Read)++; break; \
-   case MemoryMessage::FetchReq: (*the ## type ## Collisions_OffChip_Fetch)++; break; \
-   case MemoryMessage::UpgradeReq: (*the ## type ## Collisions_OffChip_Upgrade)++; break; \
-   case MemoryMessage::WriteReq: (*the ## type ## Collisions_OffChip_Write)++; break; \
-                          \
-   case MemoryMessage::EvictClean:                \
-   case MemoryMessage::EvictWritable:               \
-   case MemoryMessage::EvictDirty:                \
-    (*the ## type ## Collisions_OffChip_Evict)++;           \
-    break;                     \
-                          \
-   default:                     \
-    (*the ## type ## Collisions_OffChip_Other)++;           \
-    break;                     \
-   }                       \
-  }                        \
- }
-
-  RECORD_COLLISION_FN(Non)
-  RECORD_COLLISION_FN(Constructive)
-  RECORD_COLLISION_FN(Destructive)
-
-  void recordExtraBits(MMType req_type, bool on_chip, int32_t bits) {
-    if (on_chip) {
-      switch (req_type) {
-        case MemoryMessage::ReadReq:
-          (*theExtraBits_OnChip_Read) << std::make_pair(bits, 1);
-          break;
-        case MemoryMessage::FetchReq:
-          (*theExtraBits_OnChip_Fetch) << std::make_pair(bits, 1);
-          break;
-        case MemoryMessage::UpgradeReq:
-          (*theExtraBits_OnChip_Upgrade) << std::make_pair(bits, 1);
-          break;
-        case MemoryMessage::WriteReq:
-          (*theExtraBits_OnChip_Write) << std::make_pair(bits, 1);
-          break;
-        case MemoryMessage::EvictClean:
-        case MemoryMessage::EvictWritable:
-        case MemoryMessage::EvictDirty:
-          (*theExtraBits_OnChip_Evict) << std::make_pair(bits, 1);
-          break;
-        default:
-          (*theExtraBits_OnChip_Other) << std::make_pair(bits, 1);
-          break;
-      }
-    } else {
-      switch (req_type) {
-        case MemoryMessage::ReadReq:
-          (*theExtraBits_OffChip_Read) << std::make_pair(bits, 1);
-          break;
-        case MemoryMessage::FetchReq:
-          (*theExtraBits_OffChip_Fetch) << std::make_pair(bits, 1);
-          break;
-        case MemoryMessage::UpgradeReq:
-          (*theExtraBits_OffChip_Upgrade) << std::make_pair(bits, 1);
-          break;
-        case MemoryMessage::WriteReq:
-          (*theExtraBits_OffChip_Write) << std::make_pair(bits, 1);
-          break;
-        case MemoryMessage::EvictClean:
-        case MemoryMessage::EvictWritable:
-        case MemoryMessage::EvictDirty:
-          (*theExtraBits_OffChip_Evict) << std::make_pair(bits, 1);
-          break;
-        default:
-          (*theExtraBits_OffChip_Other) << std::make_pair(bits, 1);
-          break;
-      }
-    }
+  void recordCollision(CollisionType type, MMType req_type, bool on_chip, int32_t extra_bits) {
+    RequestClass req_class = requestClass(req_type);
+    thePendingCollisions[type][on_chip][req_class]++;
+    thePendingExtraBits[on_chip][req_class][extra_bits]++;
+    theStatsPending = true;
   }
 
   inline int32_t get_set(PhysicalMemoryAddress addr) {
@@ -432,28 +379,96 @@ private:
     return (ret & theHashMask);
   }
 
-  struct MatrixHash {
-  public:
-    MatrixHash(const std::list<int> &matrix, int32_t shift, int32_t mask) : theMatrix(matrix), theHashShift(shift), theHashMask(mask) {}
-    int32_t operator()(uint64_t addr) {
-      addr >>= theHashShift;
-      int32_t ret = 0;
-      std::list<int>::iterator it = theMatrix.begin();
-      for (; it != theMatrix.end(); it++, addr >>= 1) {
-        if ((addr & 1) != 0) {
-          ret ^= *it;
+  int32_t matrix_hash(const std::vector<int> & matrix, uint64_t addr) {
+    addr >>= theHashShift;
+    int32_t ret = 0;
+    for (size_t i = 0; i < matrix.size(); i++, addr >>= 1) {
+      ret ^= matrix[i] & -static_cast<int32_t>(addr & 1);
+    }
+    return (ret & theHashMask);
+  }
+
+  // The matrices used by Matrix hash functions
+  std::vector<std::vector<int> > theMatrixHashes;
+
+  static const int32_t kMaxHashes = kMaxTaglessHashes;
+
+  // One configured hash function.  theParam is the extra shift for Shift
+  // hashes and the index into theMatrixHashes for Matrix hashes.
+  struct HashFn {
+    HashPolicy thePolicy;
+    int32_t theParam;
+  };
+
+  HashFn theHashFns[kMaxHashes];
+  int32_t theNumHashes;
+
+  int32_t hash(const HashFn & fn, uint64_t addr) {
+    switch (fn.thePolicy) {
+      case eSimpleHash:
+        return simple_hash(addr);
+      case eXORHash:
+        return xor_hash(addr);
+      case eMyHash:
+        return my_hash(addr);
+      case eOverlapHash:
+        return overlap_hash(addr);
+      case ePrimeModuloHash:
+        return prime_modulo_hash(addr);
+      case eRotatedPrimeHash:
+        return rotated_prime_modulo_hash(addr);
+      case eFullPrimeHash:
+        return full_prime_modulo_hash(addr);
+      case eShiftHash:
+        return shift_hash(fn.theParam, addr);
+      case eMatrixHash:
+      default:
+        return matrix_hash(theMatrixHashes[fn.theParam], addr);
+    }
+  }
+
+  // Computes the bucket of addr under every hash function, including the
+  // offset of each hash's partition
+  void hashAll(uint64_t addr, int32_t buckets[kMaxHashes]) {
+    int32_t bucket_offset = ( thePartitioned ? theNumBuckets : 0 );
+    int32_t first_bucket = 0;
+    for (int32_t i = 0; i < theNumHashes; i++, first_bucket += bucket_offset) {
+      buckets[i] = hash(theHashFns[i], addr) + first_bucket;
+    }
+  }
+
+  // Determines which of address's buckets are also used by one of the other
+  // blocks (tags) held by the same node
+  void findBucketConflicts(PhysicalMemoryAddress address, std::list<PhysicalMemoryAddress> & tags, const int32_t my_buckets[kMaxHashes], bool conflict[kMaxHashes]) {
+    for (int32_t i = 0; i < theNumHashes; i++) {
+      conflict[i] = false;
+    }
+    int32_t buckets[kMaxHashes];
+    std::list<PhysicalMemoryAddress>::iterator iter = tags.begin();
+    for (; iter != tags.end(); iter++) {
+      if (*iter == address) {
+        continue;
+      }
+      hashAll(*iter, buckets);
+      for (int32_t i = 0; i < theNumHashes; i++) {
+        if (thePartitioned) {
+          conflict[i] |= (buckets[i] == my_buckets[i]);
+        } else {
+          // Not partitioned, have to check ALL hash functions for each block
+          for (int32_t j = 0; j < theNumHashes; j++) {
+            conflict[i] |= (buckets[j] == my_buckets[i]);
+          }
         }
       }
-      return (ret & theHashMask);
     }
-  private:
-    std::list<int> theMatrix;
-    int    theHashShift;
-    int    theHashMask;
-  };
+  }
 
-  // A List of Matrix Hash objects to use
-  std::list<MatrixHash> theMatrixHashes;
+  void addHashFn(HashPolicy policy, int32_t param) {
+    DBG_Assert( theNumHashes < kMaxHashes, ( << "TaglessDirectory supports at most " << kMaxHashes << " hash functions." ));
+    theHashFns[theNumHashes].thePolicy = policy;
+    theHashFns[theNumHashes].theParam = param;
+    theNumHashes++;
+  }
 
   static HashPolicy string2HashPolicy(const std::string & policy) {
     if (strcasecmp(policy.c_str(), "simple") == 0) {
@@ -481,35 +496,35 @@ private:
 
     if (strcasecmp(policy.c_str(), "simple") == 0) {
       DBG_Assert( (theNumBuckets & (theNumBuckets - 1)) == 0, ( << "theNumBuckets = " << theNumBuckets << " != Power of 2" ) );
-      hash_fns.push_back([this](uint64_t addr){return this->simple_hash(addr);});
+      addHashFn(eSimpleHash, 0);
     } else if (strcasecmp(policy.c_str(), "rotated_prime") == 0) {
-      hash_fns.push_back([this](uint64_t addr){return this->rotated_prime_modulo_hash(addr);});
+      addHashFn(eRotatedPrimeHash, 0);
       theNumBuckets = get_next_prime(theNumBuckets);
     } else if (strcasecmp(policy.c_str(), "full_prime") == 0) {
-      hash_fns.push_back([this](uint64_t addr){return this->full_prime_modulo_hash(addr);});
+      addHashFn(eFullPrimeHash, 0);
       theNumBuckets = get_next_prime(theNumBuckets);
     } else if (strcasecmp(policy.c_str(), "prime") == 0) {
-      hash_fns.push_back([this](uint64_t addr){return this->prime_modulo_hash(addr);});
+      addHashFn(ePrimeModuloHash, 0);
       theNumBuckets = get_next_prime(theNumBuckets);
     } else if (strcasecmp(policy.c_str(), "my_hash") == 0) {
       DBG_Assert( (theNumBuckets & (theNumBuckets - 1)) == 0, ( << "theNumBuckets = " << theNumBuckets << " != Power of 2" ) );
-      hash_fns.push_back([this](uint64_t addr){return this->my_hash(addr);});
+      addHashFn(eMyHash, 0);
     } else if (strcasecmp(policy.c_str(), "overlap") == 0) {
       DBG_Assert( (theNumBuckets & (theNumBuckets - 1)) == 0, ( << "theNumBuckets = " << theNumBuckets << " != Power of 2" ) );
-      hash_fns.push_back([this](uint64_t addr){return this->overlap_hash(addr);});
+      addHashFn(eOverlapHash, 0);
     } else if (strcasecmp(policy.c_str(), "xor") == 0) {
       DBG_Assert( (theNumBuckets & (theNumBuckets - 1)) == 0, ( << "theNumBuckets = " << theNumBuckets << " != Power of 2" ) );
-      hash_fns.push_back([this](uint64_t addr){return this->xor_hash(addr);});
+      addHashFn(eXORHash, 0);
       if (theHashXORShift <= 0) {
         theHashXORShift = 32 - log_base2(theNumBuckets);
       }
     } else if (strncasecmp(policy.c_str(), "shift", 5) == 0) {
       DBG_Assert( (theNumBuckets & (theNumBuckets - 1)) == 0, ( << "theNumBuckets = " << theNumBuckets << " != Power of 2" ) );
       int32_t shift = boost::lexical_cast<int>(policy.substr(6));
-      hash_fns.push_back([this, shift](uint64_t addr){return this->shift_hash(shift, addr);});
+      addHashFn(eShiftHash, shift);
     } else if (strncasecmp(policy.c_str(), "matrix", 6) == 0) {
       std::string matrix_type = policy.substr(7);
-      std::list<int> matrix;
+      std::vector<int> matrix;
       if (strncasecmp(matrix_type.c_str(), "random", 6) == 0) {
         uint32_t seed = boost::lexical_cast<uint32_t>(matrix_type.substr(7));
         std::srand(seed);
@@ -538,8 +553,8 @@ private:
       } else {
         DBG_Assert(false, ( << "Unknown Matrix Hash Type '" << matrix_type << "'" ));
       }
-      theMatrixHashes.push_back(MatrixHash(matrix, theHashShift, theHashMask));
-      hash_fns.push_back(theMatrixHashes.back());//boost::ref(theMatrixHashes.back()));
+      theMatrixHashes.push_back(matrix);
+      addHashFn(eMatrixHash, theMatrixHashes.size() - 1);
     } else {
       DBG_Assert(false, ( << "Unknown Hash Policy '" << policy << "'" ));
     }
@@ -556,9 +571,8 @@ protected:
     TaglessLookupResult * my_entry = dynamic_cast<TaglessLookupResult *>(dir_entry.get());
 
     DBG_Assert(my_entry != nullptr);
-    std::list<TaglessDirectoryBucket *>::iterator bucket_iter = my_entry->theBuckets.begin();
-    for (; bucket_iter != my_entry->theBuckets.end(); bucket_iter++) {
-      (*bucket_iter)->theTaglessEntry.addSharer(index);
+    for (int32_t bucket : my_entry->theBuckets) {
+      theDirectory[bucket].theTaglessEntry.addSharer(index);
     }
     my_entry->theTaglessState.addSharer(index);
     my_entry->theTrueState->addSharer(index);
@@ -568,9 +582,8 @@ protected:
     TaglessLookupResult * my_entry = dynamic_cast<TaglessLookupResult *>(dir_entry.get());
     DBG_Assert(my_entry != nullptr);
 
-    std::list<TaglessDirectoryBucket *>::iterator bucket_iter = my_entry->theBuckets.begin();
-    for (; bucket_iter != my_entry->theBuckets.end(); bucket_iter++) {
-      (*bucket_iter)->theTaglessEntry.addSharer(index);
+    for (int32_t bucket : my_entry->theBuckets) {
+      theDirectory[bucket].theTaglessEntry.addSharer(index);
     }
     my_entry->theTaglessState.addSharer(index);
     my_entry->theTrueState->addSharer(index);
@@ -600,40 +613,14 @@ protected:
       RegionScoutMessage probe(RegionScoutMessage::eSetTagProbe, PhysicalMemoryAddress(address));
       thePorts.sendRegionProbe(probe, index);
 
-      std::list<hash_fn_t>::iterator hash_iter = hash_fns.begin();
-      std::list<TaglessDirectoryBucket *>::iterator bucket_iter = my_entry->theBuckets.begin();
-      int32_t bucket_offset = ( thePartitioned ? theNumBuckets : 0 );
-      int32_t first_bucket = 0;
-      for (; hash_iter != hash_fns.end(); hash_iter++, bucket_iter++, first_bucket += bucket_offset) {
-        int32_t my_bucket = (*hash_iter)(address) + first_bucket;
-
-        std::list<PhysicalMemoryAddress>::iterator iter = probe.getTags().begin();
-        std::list<PhysicalMemoryAddress>::iterator end = probe.getTags().end();
-        for (; iter != end; iter++) {
-          if (*iter == address) {
-            continue;
-          }
-          if (thePartitioned) {
-            int32_t bucket = (*hash_iter)(*iter) + first_bucket;
-            if (bucket == my_bucket) {
-              break;
-            }
-          } else {
-            // Not partitioned, have to check ALL hash functions for each block
-            std::list<hash_fn_t>::iterator test_hash = hash_fns.begin();
-            for (; test_hash != hash_fns.end(); test_hash++) {
-              int32_t bucket = (*test_hash)(*iter);
-              if (bucket == my_bucket) {
-                break;
-              }
-            }
-            if (test_hash != hash_fns.end()) {
-              break;
-            }
-          }
-        }
-        if (iter == end) {
-          (*bucket_iter)->theTaglessEntry.removeSharer(index);
+      int32_t my_buckets[kMaxHashes];
+      bool conflict[kMaxHashes];
+      hashAll(address, my_buckets);
+      findBucketConflicts(address, probe.getTags(), my_buckets, conflict);
+
+      for (int32_t i = 0; i < theNumHashes; i++) {
+        if (!conflict[i]) {
+          theDirectory[my_entry->theBuckets[i]].theTaglessEntry.removeSharer(index);
         }
       }
     }
@@ -653,87 +640,63 @@ protected:
     my_entry->theTrueState->makeExclusive(index);
   }
 
-  TaglessLookupResult_p findOrCreateEntry(PhysicalMemoryAddress addr, int32_t index) {
-
-    TaglessLookupResult_p result(new TaglessLookupResult());
-
+  // Fills in the buckets addr maps to and the tagless state they combine to
+  void findBuckets(PhysicalMemoryAddress addr, TaglessLookupResult & result) {
     int32_t set_index = get_set(addr);
     DBG_Assert( (set_index >= 0) && (set_index < theNumSets), ( << "Invalid set: " << set_index << " for addr " << std::hex << addr ));
 
-    std::list<hash_fn_t>::iterator hash_iter = hash_fns.begin();
-    int32_t bucket_offset = ( thePartitioned ? theNumBuckets : 0 );
-    int32_t first_bucket = 0;
-    for (; hash_iter != hash_fns.end(); hash_iter++, first_bucket += bucket_offset) {
-      int32_t bucket_index = (*hash_iter)(addr) + first_bucket;
+    int32_t set_base = set_index * theTotalNumBuckets;
+    int32_t buckets[kMaxHashes];
+    hashAll(addr, buckets);
+    for (int32_t i = 0; i < theNumHashes; i++) {
+      DBG_Assert( (buckets[i] >= 0) && (buckets[i] < theTotalNumBuckets), ( << "Invalid bucket: " << buckets[i] << " for addr " << std::hex << addr ));
+      result.theBuckets.push_back(set_base + buckets[i]);
+    }
 
-      DBG_Assert( (bucket_index >= first_bucket) && (bucket_index < theTotalNumBuckets), ( << "Invalid bucket: " << bucket_index << " for addr " << std::hex << addr ));
+    DBG_Assert(result.theBuckets.size() > 0);
 
-      TaglessDirectoryBucket * bucket = &(theDirectory[set_index][bucket_index]);
-      result->theBuckets.push_back(bucket);
+    result.theTaglessState = theDirectory[result.theBuckets[0]].theTaglessEntry;
+    for (int32_t i = 1; i < result.theBuckets.size(); i++) {
+      result.theTaglessState &= theDirectory[result.theBuckets[i]].theTaglessEntry;
     }
+  }
 
-    DBG_Assert(result->theBuckets.size() > 0);
+  TaglessLookupResult_p findOrCreateEntry(PhysicalMemoryAddress addr, int32_t index) {
+
+    TaglessLookupResult_p result(new TaglessLookupResult());
+    findBuckets(addr, *result);
 
     // Do we have a Precise entry for this block?
-    inf_directory_t::iterator iter = result->theBuckets.front()->thePreciseDirectory.find(addr);
-    if (iter == result->theBuckets.front()->thePreciseDirectory.end()) {
+    inf_directory_t & precise = theDirectory[result->theBuckets[0]].thePreciseDirectory;
+    inf_directory_t::iterator iter = precise.find(addr);
+    if (iter == precise.end()) {
       // Need to create new entry
       BlockDirectoryEntry_p block(new BlockDirectoryEntry(addr));
-      std::list<TaglessDirectoryBucket *>::iterator bucket_iter = result->theBuckets.begin();
-      for (; bucket_iter != result->theBuckets.end(); bucket_iter++) {
-        (*bucket_iter)->thePreciseDirectory.insert(std::make_pair(addr, block));
+      for (int32_t bucket : result->theBuckets) {
+        theDirectory[bucket].thePreciseDirectory.insert(std::make_pair(addr, block));
       }
       result->theTrueState = block;
     } else {
       result->theTrueState = iter->second;
     }
 
-    result->theTaglessState = result->theBuckets.front()->theTaglessEntry;
-    std::list<TaglessDirectoryBucket *>::iterator bucket_iter = result->theBuckets.begin();
-    bucket_iter++;
-    for (; bucket_iter != result->theBuckets.end(); bucket_iter++) {
-      result->theTaglessState &= (*bucket_iter)->theTaglessEntry;
-    }
-
     return result;
   }
 
   TaglessLookupResult_p findEntry(PhysicalMemoryAddress addr, int32_t index) {
 
     TaglessLookupResult_p result(new TaglessLookupResult());
-
-    int32_t set_index = get_set(addr);
-    DBG_Assert( (set_index >= 0) && (set_index < theNumSets), ( << "Invalid set: " << set_index << " for addr " << std::hex << addr ));
-
-    std::list<hash_fn_t>::iterator hash_iter = hash_fns.begin();
-    int32_t bucket_offset = ( thePartitioned ? theNumBuckets : 0 );
-    int32_t first_bucket = 0;
-    for (; hash_iter != hash_fns.end(); hash_iter++, first_bucket += bucket_offset) {
-      int32_t bucket_index = (*hash_iter)(addr) + first_bucket;
-
-      DBG_Assert( (bucket_index >= first_bucket) && (bucket_index < theTotalNumBuckets), ( << "Invalid bucket: " << bucket_index << " for addr " << std::hex << addr ));
-
-      TaglessDirectoryBucket * bucket = &(theDirectory[set_index][bucket_index]);
-      result->theBuckets.push_back(bucket);
-    }
-
-    DBG_Assert(result->theBuckets.size() > 0);
+    findBuckets(addr, *result);
 
     // Do we have a Precise entry for this block?
-    inf_directory_t::iterator iter = result->theBuckets.front()->thePreciseDirectory.find(addr);
-    if (iter == result->theBuckets.front()->thePreciseDirectory.end()) {
+    inf_directory_t & precise = theDirectory[result->theBuckets[0]].thePreciseDirectory;
+    inf_directory_t::iterator iter = precise.find(addr);
+    if (iter == precise.end()) {
       // Don't bother adding TrueState
     } else {
       result->theTrueState = iter->second;
     }
 
-    result->theTaglessState = result->theBuckets.front()->theTaglessEntry;
-    std::list<TaglessDirectoryBucket *>::iterator bucket_iter = result->theBuckets.begin();
-    bucket_iter++;
-    for (; bucket_iter != result->theBuckets.end(); bucket_iter++) {
-      result->theTaglessState &= (*bucket_iter)->theTaglessEntry;
-    }
-
     return result;
   }
 
@@ -755,9 +718,8 @@ protected:
 
     // If there are no sharers, remove precise dir entries
     if (my_entry->theTrueState->state() == ZeroSharers) {
-      std::list<TaglessDirectoryBucket *>::iterator bucket_iter = my_entry->theBuckets.begin();
-      for (; bucket_iter != my_entry->theBuckets.end(); bucket_iter++) {
-        (*bucket_iter)->thePreciseDirectory.erase(address);
+      for (int32_t bucket : my_entry->theBuckets) {
+        theDirectory[bucket].thePreciseDirectory.erase(address);
       }
     }
 
@@ -766,42 +728,15 @@ protected:
     RegionScoutMessage probe(RegionScoutMessage::eSetTagProbe, PhysicalMemoryAddress(address));
     thePorts.sendRegionProbe(probe, index);
 
-    std::list<hash_fn_t>::iterator hash_iter = hash_fns.begin();
-    std::list<TaglessDirectoryBucket *>::iterator bucket_iter = my_entry->theBuckets.begin();
-    int32_t bucket_offset = ( thePartitioned ? theNumBuckets : 0 );
-    int32_t first_bucket = 0;
-
     // If not partitioned, we have to make sure none of the hash functions map to the same bucket
-    for (; hash_iter != hash_fns.end(); hash_iter++, bucket_iter++, first_bucket += bucket_offset) {
-      int32_t my_bucket = (*hash_iter)(address) + first_bucket;
-
-      std::list<PhysicalMemoryAddress>::iterator iter = probe.getTags().begin();
-      std::list<PhysicalMemoryAddress>::iterator end = probe.getTags().end();
-      for (; iter != end; iter++) {
-        if (*iter == address) {
-          continue;
-        }
-        if (thePartitioned) {
-          int32_t bucket = (*hash_iter)(*iter) + first_bucket;
-          if (bucket == my_bucket) {
-            break;
-          }
-        } else {
-          // Not partitioned, have to check ALL hash functions for each block
-          std::list<hash_fn_t>::iterator test_hash = hash_fns.begin();
-          for (; test_hash != hash_fns.end(); test_hash++) {
-            int32_t bucket = (*test_hash)(*iter);
-            if (bucket == my_bucket) {
-              break;
-            }
-          }
-          if (test_hash != hash_fns.end()) {
-            break;
-          }
-        }
-      }
-      if (iter == end) {
-        (*bucket_iter)->theTaglessEntry.removeSharer(index);
+    int32_t my_buckets[kMaxHashes];
+    bool conflict[kMaxHashes];
+    hashAll(address, my_buckets);
+    findBucketConflicts(address, probe.getTags(), my_buckets, conflict);
+
+    for (int32_t i = 0; i < theNumHashes; i++) {
+      if (!conflict[i]) {
+        theDirectory[my_entry->theBuckets[i]].theTaglessEntry.removeSharer(index);
       }
     }
   }
@@ -822,27 +757,25 @@ public:
 
       bool on_chip = ((block->theTrueState->state() == ManySharers) || ((block->theTrueState->state() == OneSharer) && (!block->theTrueState->sharers().isSharer(index))));
 
-      (*theExtraBits_All) << std::make_pair(num_extra_bits, 1);
-      recordExtraBits(req_type, on_chip, num_extra_bits);
-
       // Determine if this was a collision
-      std::list<TaglessDirectoryBucket *>::iterator bucket_iter = block->theBuckets.begin();
-      for (; bucket_iter != block->theBuckets.end(); bucket_iter++) {
-        if ((*bucket_iter)->thePreciseDirectory.size() == 1) {
+      bool collision = true;
+      for (int32_t bucket : block->theBuckets) {
+        if (theDirectory[bucket].thePreciseDirectory.size() == 1) {
+          collision = false;
           break;
         }
       }
 
-      if (bucket_iter != block->theBuckets.end()) {
-        recordNonCollision(req_type, on_chip);
+      if (!collision) {
+        recordCollision(eNonCollision, req_type, on_chip, num_extra_bits);
         DBG_Assert(num_extra_bits == 0, ( << "No Collision found, BUT num_extra_bits = " << num_extra_bits << ", tagless state = " << block->theTaglessState.sharers() << ", true state = " << block->theTrueState->sharers() ));
       } else {
         // was this a destructive or constructive collision?
         // Do we have the right state?
         if (num_extra_bits == 0) {
-          recordConstructiveCollision(req_type, on_chip);
+          recordCollision(eConstructiveCollision, req_type, on_chip, num_extra_bits);
         } else {
-          recordDestructiveCollision(req_type, on_chip);
+          recordCollision(eDestructiveCollision, req_type, on_chip, num_extra_bits);
         }
       }
 
@@ -850,7 +783,7 @@ public:
         uint64_t mask = (1 << theHashShift);
         for (int32_t i = 0; i < theFreeBits; i++, mask <<= 1) {
           if ((address & mask) != 0) {
-            (*theBitCounters[i])++;
+            thePendingBitCounts[i]++;
           }
         }
       }
@@ -858,7 +791,7 @@ public:
       if (theTrackBitPatterns) {
         uint64_t val = address >> theHashShift;
         for (int32_t i = 0; i < theNumPatterns; i++, val >>= 1) {
-          (*theBitPatternCounters[i][val & theHashMask])++;
+          thePendingBitPatterns[i * theNumBuckets + (val & theHashMask)]++;
         }
       }
     }
@@ -878,6 +811,68 @@ public:
     bool valid = true;
     return std::tie(block->theTaglessState.sharers(), block->theTaglessState.state(), block, valid);
   }
+
+  // Push the collision statistics gathered since the last call to the StatCounters
+  virtual void updateStats() {
+    if (!theTrackCollisions || !theStatsPending) {
+      return;
+    }
+    theStatsPending = false;
+
+    for (int32_t type = 0; type < kNumCollisionTypes; type++) {
+      int64_t all = 0;
+      for (int32_t on_chip = 0; on_chip < 2; on_chip++) {
+        for (int32_t req = 0; req < kNumRequestClasses; req++) {
+          int64_t & count = thePendingCollisions[type][on_chip][req];
+          if (count != 0) {
+            (*theCollisions[type][on_chip][req]) += count;
+            all += count;
+            count = 0;
+          }
+        }
+      }
+      if (all != 0) {
+        (*theCollisions_All[type]) += all;
+      }
+    }
+
+    std::vector<int64_t> all_extra_bits(MAX_NUM_SHARERS + 1, 0);
+    for (int32_t on_chip = 0; on_chip < 2; on_chip++) {
+      for (int32_t req = 0; req < kNumRequestClasses; req++) {
+        std::vector<int64_t> & counts = thePendingExtraBits[on_chip][req];
+        for (int32_t bits = 0; bits <= MAX_NUM_SHARERS; bits++) {
+          if (counts[bits] != 0) {
+            (*theExtraBits[on_chip][req]) << std::make_pair(static_cast<int64_t>(bits), static_cast<int>(counts[bits]));
+            all_extra_bits[bits] += counts[bits];
+            counts[bits] = 0;
+          }
+        }
+      }
+    }
+    for (int32_t bits = 0; bits <= MAX_NUM_SHARERS; bits++) {
+      if (all_extra_bits[bits] != 0) {
+        (*theExtraBits_All) << std::make_pair(static_cast<int64_t>(bits), static_cast<int>(all_extra_bits[bits]));
+      }
+    }
+
+    for (size_t i = 0; i < thePendingBitCounts.size(); i++) {
+      if (thePendingBitCounts[i] != 0) {
+        (*theBitCounters[i]) += thePendingBitCounts[i];
+        thePendingBitCounts[i] = 0;
+      }
+    }
+
+    for (size_t i = 0; i < thePendingBitPatterns.size(); i++) {
+      if (thePendingBitPatterns[i] != 0) {
+        (*theBitPatternCounters[i / theNumBuckets][i % theNumBuckets]) += thePendingBitPatterns[i];
+        thePendingBitPatterns[i] = 0;
+      }
+    }
+  }
+
+  virtual void finalize() {
+    updateStats();
+  }
   void saveState( std::ostream & s, const std::string & aDirName ) {
     boost::archive::binary_oarchive oa(s);
 
@@ -888,7 +883,7 @@ public:
 
     for (int32_t set = 0; set < theNumSets; set++) {
       for (int32_t bucket = 0; bucket < theNumBuckets; bucket++) {
-        StdDirEntrySerializer serializer(theDirectory[set][bucket].theTaglessEntry.getSerializer());
+        StdDirEntrySerializer serializer(theDirectory[set * theTotalNumBuckets + bucket].theTaglessEntry.getSerializer());
         oa << serializer;
       }
     }
@@ -908,7 +903,37 @@ public:
       for (int32_t bucket = 0; bucket < theNumBuckets; bucket++) {
         StdDirEntrySerializer serializer;
         ia >> serializer;
-        theDirectory[set][bucket].theTaglessEntry = serializer;
+        theDirectory[set * theTotalNumBuckets + bucket].theTaglessEntry = serializer;
+      }
+    }
+    return true;
+  }
+
+  bool saveImage( std::string const & aFileName ) {
+    std::vector<StdDirEntrySerializer> entries;
+    entries.reserve(theNumSets * theNumBuckets);
+    for (int32_t set = 0; set < theNumSets; set++) {
+      for (int32_t bucket = 0; bucket < theNumBuckets; bucket++) {
+        entries.push_back(theDirectory[set * theTotalNumBuckets + bucket].theTaglessEntry.getSerializer());
+      }
+    }
+
+    nCacheImage::ImageWriter image(aFileName);
+    image.section(theNumSets, theNumBuckets, entries);
+    DBG_Assert( image.good(), ( << "Failed to write directory image " << aFileName ));
+    return true;
+  }
+
+  bool loadImage( nCacheImage::ImageReader & anImage ) {
+    uint64_t count = 0;
+    StdDirEntrySerializer const * entries = anImage.section<StdDirEntrySerializer>(theNumSets, theNumBuckets, count);
+    if (entries == nullptr || count != (uint64_t)theNumSets * theNumBuckets) {
+      return false;
+    }
+
+    for (int32_t set = 0; set < theNumSets; set++) {
+      for (int32_t bucket = 0; bucket < theNumBuckets; bucket++, entries++) {
+        theDirectory[set * theTotalNumBuckets + bucket].theTaglessEntry = *entries;
       }
     }
     return true;
@@ -62,17 +62,17 @@ public:
   class TaglessLookupResult : public AbstractLookupResult<_State> {
   private:
     MemoryAddress  theAddress;
-    std::set<int>  theBucketList;
+    int32_t  theBucketList[nGlobalHasher::GlobalHasher::kMaxHashes];
+    int32_t  theNumBuckets;
     std::vector<_State> &theSet;
     _State    theAggregateState;
 
-    TaglessLookupResult(MemoryAddress addr, const std::set<int>& buckets, std::vector<_State> &set, int32_t num_sharers)
-      : theAddress(addr), theBucketList(buckets), theSet(set), theAggregateState(num_sharers) {
-      std::set<int>::iterator bucket = theBucketList.begin();
-      theAggregateState = theSet[*bucket];
-      bucket++;
-      for (; bucket != theBucketList.end(); bucket++) {
-        theAggregateState &= theSet[*bucket];
+    TaglessLookupResult(MemoryAddress addr, std::vector<_State> &set, int32_t num_sharers)
+      : theAddress(addr), theSet(set), theAggregateState(num_sharers) {
+      theNumBuckets = nGlobalHasher::GlobalHasher::theHasher().hashAddr(addr, theBucketList);
+      theAggregateState = theSet[theBucketList[0]];
+      for (int32_t i = 1; i < theNumBuckets; i++) {
+        theAggregateState &= theSet[theBucketList[i]];
       }
     }
 
@@ -92,9 +92,8 @@ public:
 
     virtual void addSharer( int32_t sharer) {
       theAggregateState.addSharer(sharer);
-      std::set<int>::iterator bucket = theBucketList.begin();
-      for (; bucket != theBucketList.end(); bucket++) {
-        theSet[*bucket].addSharer(sharer);
+      for (int32_t i = 0; i < theNumBuckets; i++) {
+        theSet[theBucketList[i]].addSharer(sharer);
       }
 
     }
@@ -288,9 +287,8 @@ public:
 
   LookupResult_p nativeLookup(MemoryAddress address) {
     int32_t set_index = get_set(address);
-    std::set<int> bucket_list(nGlobalHasher::GlobalHasher::theHasher().hashAddr(address));
 
-    return LookupResult_p(new LookupResult(address, bucket_list, theDirectory[set_index], theNumSharers));
+    return LookupResult_p(new LookupResult(address, theDirectory[set_index], theNumSharers));
   }
 
   virtual bool sameSet(MemoryAddress a, MemoryAddress b) {
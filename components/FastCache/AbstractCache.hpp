@@ -38,6 +38,7 @@
 #define FLEXUS_FASTCACHE_ABSTRACT_CACHE_HPP_INCLUDED
 
 #include <components/FastCache/LookupResult.hpp>
+#include <components/CommonQEMU/CacheImage.hpp>
 
 #include <functional>
 #include <boost/dynamic_bitset.hpp>
@@ -104,9 +105,23 @@ public:
 
   virtual void getSetTags(uint64_t region, std::list<PhysicalMemoryAddress> &tags) = 0;
 
+  // Visits every valid block, least recently used first, so a new array
+  // filled in this order keeps the most recently used blocks.
+  virtual void forEachBlock( std::function<void( uint64_t tagset, CoherenceState_t state )> aVisitor ) = 0;
+
   virtual void saveState( std::ostream & s ) = 0;
 
   virtual bool loadState( std::istream & s ) = 0;
+
+  // Raw memory-mappable images.  Caches that cannot write one return false
+  // and are saved with saveState instead.
+  virtual bool saveImage( std::string const & aFileName ) {
+    return false;
+  }
+
+  virtual bool loadImage( nCacheImage::ImageReader & anImage ) {
+    return false;
+  }
 };
 
 }  // namespace nFastRTCache
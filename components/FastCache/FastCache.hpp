@@ -72,6 +72,9 @@ COMPONENT_PARAMETERS(
 
   PARAMETER( TextFlexpoints, bool, "Store flexpoints as text files (compatible with old FastCache component)", "text_flexpoints", false )
   PARAMETER( GZipFlexpoints, bool, "Compress flexpoints with gzip", "gzip_flexpoints", true )
+  PARAMETER( FlexpointCodec, std::string, "Codec for compressed flexpoints (gzip | fast); loading detects it", "flexpoint_codec", "gzip" )
+  PARAMETER( FlexpointThreads, uint32_t, "Worker threads for the fast flexpoint codec (0 = up to 4)", "flexpoint_threads", 0 )
+  PARAMETER( ImageFlexpoints, bool, "Save flexpoints as raw memory-mappable images (.img); loading prefers them", "image_flexpoints", false )
 
   PARAMETER( DowngradeLRU, bool, "Move block to LRU position when a Downgrade is recieved for a block in Modified or Exclusive state", "downgrade_lru", false )
   PARAMETER( SnoopLRU, bool, "Move block to LRU position when a Snoop (ReturnReq) is recieved for a block in Modified or Exclusive state", "snoop_lru", false )
@@ -50,10 +50,13 @@
 #include <components/FastCache/StdCache.hpp>
 
 #include <components/CommonQEMU/TraceTracker.hpp>
+#include <components/CommonQEMU/FlexpointStream.hpp>
+#include <components/CommonQEMU/CacheImage.hpp>
 
 #include <core/performance/profile.hpp>
 
 #include <fstream>
+#include <set>
 #include <string>
 
 #include <boost/iostreams/filtering_stream.hpp>
@@ -90,6 +93,9 @@ class FLEXUS_COMPONENT(FastCache) {
 
   int32_t theIndex;
 
+  //Bound at initialize(); null unless trace_tracker_on is set
+  nTraceTracker::TraceTracker * theTracker;
+
   LookupResult_p lookup;
   LookupResult_p snp_lookup;
 
@@ -97,7 +103,8 @@ public:
   FLEXUS_COMPONENT_CONSTRUCTOR(FastCache)
     : base( FLEXUS_PASS_CONSTRUCTOR_ARGS )
     , theEvictMessage(MemoryMessage::EvictDirty)
-    , theInvalidateMessage(MemoryMessage::Invalidate) {
+    , theInvalidateMessage(MemoryMessage::Invalidate)
+    , theTracker(0) {
   }
 
   //InstructionOutputPort
@@ -106,54 +113,52 @@ public:
     return true;
   }
 
+  //Each instance reads only its own flexpoint files
+  bool loadsIndependently() const {
+    return true;
+  }
+
   void saveState(std::string const & aDirName) {
+    if (cfg.ImageFlexpoints && theCache->saveImage(aDirName + "/" + statName() + ".img")) {
+      return;
+    }
+
     std::string fname( aDirName );
     fname += "/" + statName();
     if (cfg.GZipFlexpoints) {
       fname += ".gz";
     }
 
-    std::ios_base::openmode omode = std::ios::out;
-    if (!cfg.TextFlexpoints) {
-      omode |= std::ios::binary;
-    }
-
-    std::ofstream ofs(fname.c_str(), omode);
-
-    boost::iostreams::filtering_stream<boost::iostreams::output> out;
+    nFlexpoint::eFlexpointCodec codec = nFlexpoint::kRawFlexpoint;
     if (cfg.GZipFlexpoints) {
-      out.push(boost::iostreams::gzip_compressor(boost::iostreams::gzip_params(9)));
+      codec = nFlexpoint::parseFlexpointCodec(cfg.FlexpointCodec);
     }
-    out.push(ofs);
-
-    theCache->saveState ( out );
+    nFlexpoint::FlexpointOutput out(fname, codec, cfg.FlexpointThreads, !cfg.TextFlexpoints);
+    theCache->saveState ( out.stream() );
   }
 
   void loadState(std::string const & aDirName) {
+    nCacheImage::ImageReader image(aDirName + "/" + statName() + ".img");
+    if (image.good()) {
+      if ( ! theCache->loadImage( image ) ) {
+        DBG_ ( Dev, ( << "Error loading cache image for " << statName() <<
+                      ".  Make sure your checkpoints match your current cache configuration." ) );
+        DBG_Assert ( false );
+      }
+      return;
+    }
+
     std::string fname( aDirName);
     fname += "/" + statName();
     if (cfg.GZipFlexpoints) {
       fname += ".gz";
     }
 
-    std::ios_base::openmode omode = std::ios::in;
-    if (!cfg.TextFlexpoints) {
-      omode |= std::ios::binary;
-    }
-
-    std::ifstream ifs(fname.c_str(), omode);
-    if (! ifs.good()) {
+    nFlexpoint::FlexpointInput in(fname, cfg.FlexpointThreads, !cfg.TextFlexpoints);
+    if (! in.good()) {
       DBG_( Dev, ( << " saved checkpoint state " << fname << " not found.  Resetting to empty cache. " )  );
     } else {
-      //ifs >> std::skipws;
-
-      boost::iostreams::filtering_stream<boost::iostreams::input> in;
-      if (cfg.GZipFlexpoints) {
-        in.push(boost::iostreams::gzip_decompressor());
-      }
-      in.push(ifs);
-
-      if ( ! theCache->loadState( in ) ) {
+      if ( ! theCache->loadState( in.stream() ) ) {
         DBG_ ( Dev, ( << "Error loading checkpoint state from file: " << fname <<
                       ".  Make sure your checkpoints match your current cache configuration." ) );
         DBG_Assert ( false );
@@ -161,25 +166,16 @@ public:
     }
   }
 
-  void initialize(void) {
-    static volatile bool widthPrintout = true;
-
-    if (widthPrintout) {
-      DBG_( Crit, ( << "Running with MT width " << cfg.MTWidth ) );
-      widthPrintout = false;
-    }
-
-    theProtocol = GenerateCoherenceProtocol(cfg.Protocol, cfg.UsingTraces,
-                                            [this](MemoryMessage& msg){ return this->forwardMessage(msg); },
-                                            [this](MemoryMessage& msg){ return this->continueSnoop(msg);}, 
-                                            [this](uint64_t addr, bool icache, bool dcache){ return this->sendInvalidate(addr, icache, dcache); },
-                                            cfg.DowngradeLRU,
-                                            cfg.SnoopLRU);
-    theStats = new CacheStats(statName());
-    theIndex = flexusIndex();
-
-    theEvictMessage.coreIdx() = theIndex;
+  CoherenceProtocol * createProtocol() {
+    return GenerateCoherenceProtocol(cfg.Protocol, cfg.UsingTraces,
+                                     [this](MemoryMessage& msg){ return this->forwardMessage(msg); },
+                                     [this](MemoryMessage& msg){ return this->continueSnoop(msg);}, 
+                                     [this](uint64_t addr, bool icache, bool dcache){ return this->sendInvalidate(addr, icache, dcache); },
+                                     cfg.DowngradeLRU,
+                                     cfg.SnoopLRU);
+  }
 
+  AbstractCache * createCache() {
     //Confirm that BlockSize is a power of 2
     DBG_Assert( (cfg.BlockSize & (cfg.BlockSize - 1)) == 0);
     DBG_Assert( cfg.BlockSize  >= 4);
@@ -196,39 +192,91 @@ public:
     theBlockMask = ~(cfg.BlockSize - 1);
 
     if (cfg.StdArray) {
-      theCache = new StdCache(statName(),
-                              cfg.BlockSize,
-                              num_sets,
-                              cfg.Associativity,
-                              [this](uint64_t aTagset, CoherenceState_t aLineState){ return this->evict(aTagset, aLineState); },
-                              [this](uint64_t addr, bool icache, bool dcache){ return this->sendInvalidate(addr, icache, dcache); },
-                              theIndex,
-                              cfg.CacheLevel,
-                              cfg.RTReplPolicy,
-                              cfg.TextFlexpoints
-                             );
+      return new StdCache(statName(),
+                          cfg.BlockSize,
+                          num_sets,
+                          cfg.Associativity,
+                          [this](uint64_t aTagset, CoherenceState_t aLineState){ return this->evict(aTagset, aLineState); },
+                          [this](uint64_t addr, bool icache, bool dcache){ return this->sendInvalidate(addr, icache, dcache); },
+                          theIndex,
+                          cfg.CacheLevel,
+                          cfg.RTReplPolicy,
+                          cfg.TextFlexpoints
+                         );
     } else {
-      theCache = new RTCache( cfg.BlockSize,
-                              num_sets,
-                              cfg.Associativity,
-                              [this](uint64_t aTagset, CoherenceState_t aLineState){ return this->evict(aTagset, aLineState); },
-                              [this](uint64_t aTagset, int32_t owner){ return this->evictRegion(aTagset, owner); },
-                              [this](uint64_t addr, bool icache, bool dcache){ return this->sendInvalidate(addr, icache, dcache); },
-                              theIndex,
-                              cfg.CacheLevel,
-                              cfg.RegionSize,
-                              cfg.RTAssoc,
-                              cfg.RTSize,
-                              cfg.ERBSize,
-                              cfg.SkewBlockSet,
-                              cfg.RTReplPolicy
-                            );
+      return new RTCache( cfg.BlockSize,
+                          num_sets,
+                          cfg.Associativity,
+                          [this](uint64_t aTagset, CoherenceState_t aLineState){ return this->evict(aTagset, aLineState); },
+                          [this](uint64_t aTagset, int32_t owner){ return this->evictRegion(aTagset, owner); },
+                          [this](uint64_t addr, bool icache, bool dcache){ return this->sendInvalidate(addr, icache, dcache); },
+                          theIndex,
+                          cfg.CacheLevel,
+                          cfg.RegionSize,
+                          cfg.RTAssoc,
+                          cfg.RTSize,
+                          cfg.ERBSize,
+                          cfg.SkewBlockSet,
+                          cfg.RTReplPolicy
+                        );
     }
+  }
+
+  void initialize(void) {
+    static volatile bool widthPrintout = true;
+
+    if (widthPrintout) {
+      DBG_( Crit, ( << "Running with MT width " << cfg.MTWidth ) );
+      widthPrintout = false;
+    }
+
+    theProtocol = createProtocol();
+    theStats = new CacheStats(statName());
+    theIndex = flexusIndex();
+    theTracker = nTraceTracker::bindTraceTracker(cfg.TraceTracker);
+
+    theEvictMessage.coreIdx() = theIndex;
+
+    theCache = createCache();
 
     Flexus::Stat::getStatManager()->addFinalizer([this](){ return this->finalize(); });//ll::bind( &nFastCache::FastCacheComponent::finalize, this ));
 
   }
 
+  bool isReconfigurable(std::string const & aSwitch) const {
+    static const std::set<std::string> kSwitches = {
+      //Read while running
+      "clean_evict", "notify_reads", "notify_writes",
+      "gzip_flexpoints", "flexpoint_codec", "flexpoint_threads", "image_flexpoints",
+      //Re-applied by reconfigure()
+      "protocol", "using_traces", "downgrade_lru", "snoop_lru", "trace_tracker_on",
+      "size", "assoc", "std_array", "rt_repl", "rsize", "rt_assoc", "rt_size", "erb_size",
+      "skew_block_set", "text_flexpoints"
+    };
+    return kSwitches.count(aSwitch) > 0;
+  }
+
+  //Rebuilds the protocol and the array from cfg.  The warmed blocks move to
+  //the new array from LRU to MRU; if it is smaller, the overflow is evicted
+  //through the usual path, so the next level hears about it.
+  void reconfigure() {
+    delete theProtocol;
+    theProtocol = createProtocol();
+    theTracker = nTraceTracker::bindTraceTracker(cfg.TraceTracker);
+
+    lookup = nullptr;
+    snp_lookup = nullptr;
+    AbstractCache * warmed = theCache;
+    theCache = createCache();
+    warmed->forEachBlock( [this](uint64_t aTagset, CoherenceState_t aState) {
+      LookupResult_p result = theCache->lookup(aTagset);
+      if (result->getState() == kInvalid) {
+        result->allocate(aState);
+      }
+    });
+    delete warmed;
+  }
+
   void finalize(void) {
     theStats->update();
   }
@@ -259,8 +307,14 @@ public:
              index_t         anIndex,
              MemoryMessage & aMessage) {
     FLEXUS_PROFILE();
-    MemoryMessage orig_message(aMessage);
-    orig_message.coreIdx() = aMessage.coreIdx();
+    // The protocol rewrites aMessage into the reply, so keep the request
+    // fields the trace hook reports, and only when a tracker is bound.
+    VirtualMemoryAddress req_pc(0);
+    bool req_priv = false;
+    if (theTracker) {
+      req_pc = aMessage.pc();
+      req_priv = aMessage.isPriv();
+    }
 
     //Create a set and tag from the message's address
     uint64_t tagset = aMessage.address() & theBlockMask;
@@ -277,6 +331,7 @@ public:
     DBG_( Iface, Addr(aMessage.address()) ( << flexusIndex() << ": Request[" << anIndex << "]: " << aMessage << " Initial State: " << std::hex << lookup->getState() << std::dec ));
 
     // Determine Actions based on state and request
+    bool miss = (lookup->getState() == kInvalid);
     tie(fn_ptr, stat_ptr) = theProtocol->getCoherenceAction(lookup->getState(), access_type);
 
     // Perform Actions this includes setting reply type
@@ -285,6 +340,12 @@ public:
     // Increment stat counter
     (theStats->*stat_ptr)++;
 
+    if (access_type < CoherenceProtocol::kEvictClean || access_type > CoherenceProtocol::kEvictDirty) {
+      bool write = (access_type == CoherenceProtocol::kWriteAccess || access_type == CoherenceProtocol::kStoreAccess
+                    || access_type == CoherenceProtocol::kUpgrade || access_type == CoherenceProtocol::kNAWAccess);
+      TRACE_TRACKER_HOOK(theTracker, access(theIndex, cfg.CacheLevel, tagset, req_pc, false, write, miss, req_priv, 0));
+    }
+
     DBG_( Iface, Addr(aMessage.address()) ( << "Done, reply: " << aMessage ));
     DBG_( Iface, Addr(aMessage.address()) ( << "Request Left Lookup tagset: " << std::hex << lookup->address() << " in state " << state2String(lookup->getState()) << std::dec ));
     if (snp_lookup != nullptr) {
@@ -297,6 +358,7 @@ public:
     theEvictMessage.address() = PhysicalMemoryAddress(aTagset);
 
     theEvictMessage.type() = theProtocol->evict(aTagset, aLineState);
+    TRACE_TRACKER_HOOK(theTracker, eviction(theIndex, cfg.CacheLevel, aTagset, false));
 
     if (theEvictMessage.type() == MemoryMessage::EvictDirty || cfg.CleanEvictions) {
       DBG_( Iface, Addr(aTagset) ( << "Evict: " << theEvictMessage ));
@@ -349,9 +411,15 @@ public:
     // Determine Actions based on state and snoop type
     std::tie(fn_ptr, stat_ptr) = theProtocol->getSnoopAction(snp_lookup->getState(), aMessage.type());
 
+    bool invalidated = (aMessage.type() == MemoryMessage::Invalidate && snp_lookup->getState() != kInvalid);
+
     // Perform Actions
     (*fn_ptr)(snp_lookup, aMessage);
 
+    if (invalidated) {
+      TRACE_TRACKER_HOOK(theTracker, invalidation(theIndex, cfg.CacheLevel, tagset));
+    }
+
     // Increment counter
     (theStats->*stat_ptr)++;
 
@@ -40,10 +40,11 @@
 #include <components/FastCache/CoherenceStates.hpp>
 
 #include <core/boost_extensions/intrusive_ptr.hpp>
+#include <core/fast_alloc.hpp>
 
 namespace nFastCache {
 
-class LookupResult : public boost::counted_base {
+class LookupResult : public boost::counted_base, public FastAlloc {
 public:
   LookupResult() {}
   virtual ~LookupResult() {}
@@ -390,6 +390,17 @@ public:
     }
   }
 
+  virtual void forEachBlock( std::function<void( uint64_t tagset, CoherenceState_t state )> aVisitor ) {
+    for (int32_t set = 0; set < theNumSets; set++) {
+      block_set_t::index<by_order>::type & order = theBlocks[set].get<by_order>();
+      for (auto block = order.rbegin(); block != order.rend(); ++block) {
+        if (isValid(block->state)) {
+          aVisitor(block->tag, block->state);
+        }
+      }
+    }
+  }
+
   virtual void saveState( std::ostream & s ) {
     static const int32_t kSave_ValidBit = 1;
     static const int32_t kSave_DirtyBit = 2;
@@ -607,6 +618,84 @@ public:
     }
     return true;
   }
+
+  virtual bool saveImage( std::string const & aFileName ) {
+    // One record per way, each set from MRU to LRU, as in saveState
+    std::vector<BlockSerializer> blocks(theNumSets * theAssoc);
+    BlockSerializer * bs = blocks.data();
+    for (int32_t set = 0; set < theNumSets; set++) {
+      order_iterator block = theBlocks[set].get<by_order>().begin();
+      order_iterator end = theBlocks[set].get<by_order>().end();
+      int32_t way = 0;
+      for (; block != end; block++, way++, bs++) {
+        bs->tag = block->tag;
+        bs->way = block->way;
+        bs->state = stateToImage(block->state);
+      }
+      for (; way < theAssoc; way++, bs++) {
+        bs->tag = 0;
+        bs->way = way;
+        bs->state = (uint8_t)'I';
+      }
+    }
+
+    nCacheImage::ImageWriter image(aFileName);
+    image.section(theNumSets, theAssoc, blocks);
+    DBG_Assert( image.good(), ( << theName << ": failed to write cache image " << aFileName ));
+    return true;
+  }
+
+  virtual bool loadImage( nCacheImage::ImageReader & anImage ) {
+    uint64_t count = 0;
+    BlockSerializer const * bs = anImage.section<BlockSerializer>(theNumSets, theAssoc, count);
+    if (bs == nullptr || count != (uint64_t)theNumSets * theAssoc) {
+      return false;
+    }
+
+    for (int32_t set = 0; set < theNumSets; set++) {
+      for (int32_t way = 0; way < theAssoc; way++, bs++) {
+        theBlocks[set].get<by_order>().push_back(BlockEntry(bs->tag, stateFromImage(bs->state), way));
+      }
+    }
+    return true;
+  }
+
+private:
+  static uint8_t stateToImage(CoherenceState_t aState) {
+    switch (aState) {
+      case kModified:
+        return (uint8_t)'M';
+      case kOwned:
+        return (uint8_t)'O';
+      case kExclusive:
+        return (uint8_t)'E';
+      case kShared:
+        return (uint8_t)'S';
+      case kInvalid:
+        return (uint8_t)'I';
+      default:
+        DBG_Assert(false, ( << "Don't know how to save state " << aState ));
+        return (uint8_t)'I';
+    }
+  }
+
+  static CoherenceState_t stateFromImage(uint8_t aState) {
+    switch (aState) {
+      case (uint8_t)'M':
+        return kModified;
+      case (uint8_t)'O':
+        return kOwned;
+      case (uint8_t)'E':
+        return kExclusive;
+      case (uint8_t)'S':
+        return kShared;
+      case (uint8_t)'I':
+        return kInvalid;
+      default:
+        DBG_Assert(false, ( << "Unknown Block State: " << (uint8_t)aState));
+        return kInvalid;
+    }
+  }
 };
 
 }  // namespace nFastRTCache
@@ -71,6 +71,8 @@ COMPONENT_PARAMETERS(
   PARAMETER( StreamDescs, long, "Number of stream descriptors", "str-descs", 0 )
   PARAMETER( DelayedCommits, bool, "Enable delayed commit support", "dc", false )
   PARAMETER( CptFilter, long, "Size of filter table (entries, 0 = infinite)", "cpt-filt", 0 )
+  PARAMETER( TableCapacity, long, "Entries per tracking table (0 = infinite)", "table-cap", 0 )
+  PARAMETER( StatFamilies, std::string, "Stat families to register (all | comma list of usage,repet,active,order,buffetch,stream,time,prefetch)", "stat-families", "all" )
 );
 
 COMPONENT_INTERFACE(
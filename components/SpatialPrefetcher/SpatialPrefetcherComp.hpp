@@ -34,6 +34,7 @@
 // CONTRACT, TORT OR OTHERWISE).
 //
 // DO-NOT-REMOVE end-copyright-block   
+#include <bitset>
 #include <memory>
 #include <fstream>
 #include <sstream>
@@ -121,7 +122,17 @@ bool operator < (const SpatialPattern & a, const SpatialPattern & b) {
   return false;
 }
 
-typedef std::unordered_map<GroupAddress, SpatialPattern, IntHash> SpatialGroupUsage;
+struct PatternHash {
+  std::size_t operator()(const SpatialPattern & pattern) const {
+    std::size_t hash = pattern.size();
+    for (std::size_t ii = pattern.find_first(); ii != SpatialPattern::npos; ii = pattern.find_next(ii)) {
+      hash = hash * 31 + ii + 1;
+    }
+    return hash;
+  }
+};
+
+typedef flexus_bounded_map<GroupAddress, SpatialPattern> SpatialGroupUsage;
 typedef SpatialGroupUsage::iterator GroupUsageIter;
 
 void savePattern(std::ostream & ofs, SpatialPattern pattern) {
@@ -343,7 +354,103 @@ typedef flexus_boost_seq_map<RepetIndex, SpatialHistory> GroupRepetHistory;
 typedef GroupRepetHistory::iterator RepetHistoryIter;
 typedef flexus_boost_set_assoc<RepetIndex, SpatialHistory> GroupRepetAssocHistory;
 
-typedef flexus_boost_seq_map<uint8_t, uint8_t> OrderingMap; // <BlockNo,SeqNo>
+// Order in which the blocks of one spatial group were accessed.  Blocks are
+// numbered within the group and each appears at most once, so the ordering
+// lives in two arrays sized to the largest group instead of a node-based map:
+// theSequence lists block numbers in access order, and theSeqNo maps a block
+// back to its position, valid where thePresent is set.  Iterators yield
+// <BlockNo,SeqNo> pairs in sequence order; find() and findSeq() both position
+// one at the given block.
+class BlockOrdering {
+public:
+  static const uint32_t kMaxBlocks = 128;
+
+  class iterator {
+    BlockOrdering const * theOrder;
+    uint32_t theSeq;
+    std::pair<uint8_t, uint8_t> theValue;
+    void load() {
+      if (theSeq < theOrder->theSize) {
+        theValue = std::make_pair(theOrder->theSequence[theSeq], static_cast<uint8_t>(theSeq));
+      }
+    }
+  public:
+    iterator(BlockOrdering const * anOrder, uint32_t aSeq)
+      : theOrder(anOrder)
+      , theSeq(aSeq) {
+      load();
+    }
+    std::pair<uint8_t, uint8_t> const * operator->() const {
+      return &theValue;
+    }
+    std::pair<uint8_t, uint8_t> const & operator*() const {
+      return theValue;
+    }
+    iterator & operator++() {
+      ++theSeq;
+      load();
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator prev(*this);
+      ++(*this);
+      return prev;
+    }
+    bool operator==(iterator const & other) const {
+      return theSeq == other.theSeq;
+    }
+    bool operator!=(iterator const & other) const {
+      return theSeq != other.theSeq;
+    }
+  };
+  typedef iterator seq_iter;
+
+private:
+  std::bitset<kMaxBlocks> thePresent;
+  uint8_t theSequence[kMaxBlocks];
+  uint8_t theSeqNo[kMaxBlocks];
+  uint32_t theSize;
+
+public:
+  BlockOrdering()
+    : theSize(0)
+  {}
+
+  std::size_t size() const {
+    return theSize;
+  }
+
+  // Sequence numbers are always assigned in order, so the second member of
+  // aBlockSeq must be the current size
+  void push_back(std::pair<uint32_t, uint32_t> const & aBlockSeq) {
+    DBG_Assert(aBlockSeq.first < kMaxBlocks, ( << "Block " << aBlockSeq.first << " is beyond the largest spatial group" ) );
+    DBG_Assert(!thePresent.test(aBlockSeq.first) && aBlockSeq.second == theSize);
+    thePresent.set(aBlockSeq.first);
+    theSeqNo[aBlockSeq.first] = theSize;
+    theSequence[theSize++] = aBlockSeq.first;
+  }
+
+  iterator find(uint32_t aBlock) const {
+    if (aBlock < kMaxBlocks && thePresent.test(aBlock)) {
+      return iterator(this, theSeqNo[aBlock]);
+    }
+    return end();
+  }
+  iterator findSeq(uint32_t aBlock) const {
+    return find(aBlock);
+  }
+  iterator end() const {
+    return iterator(this, theSize);
+  }
+  iterator beginSeq() const {
+    return iterator(this, 0);
+  }
+  iterator endSeq() const {
+    return end();
+  }
+};
+
+typedef BlockOrdering OrderingMap; // <BlockNo,SeqNo>
 typedef OrderingMap::iterator OrderingIter;
 typedef OrderingMap::seq_iter OrderingSeqIter;
 struct GroupOrderingEntry {
@@ -362,7 +469,7 @@ struct GroupOrderingEntry {
     theNextSeqNo++;
   }
 };
-typedef std::unordered_map<GroupAddress, GroupOrderingEntry, IntHash> GroupOrderingBuild;
+typedef flexus_bounded_map<GroupAddress, GroupOrderingEntry> GroupOrderingBuild;
 typedef GroupOrderingBuild::iterator OrderingBuildIter;
 typedef std::unordered_map<RepetIndex, OrderingMap, IntHash> GroupOrderingHistory;
 typedef GroupOrderingHistory::iterator OrderingHistoryIter;
@@ -446,7 +553,7 @@ struct DoneStreamEntry {
     return theHits;
   }
 };
-typedef std::unordered_map<GroupAddress, DoneStreamEntry, IntHash> DoneStreamTable;
+typedef flexus_bounded_map<GroupAddress, DoneStreamEntry> DoneStreamTable;
 typedef DoneStreamTable::iterator DoneStreamIter;
 
 struct GroupTimeEntry {
@@ -463,7 +570,7 @@ struct GroupTimeEntry {
     , lastEnd(curr)
   {}
 };
-typedef std::unordered_map<GroupAddress, GroupTimeEntry, IntHash> SpatialGroupTime;
+typedef flexus_bounded_map<GroupAddress, GroupTimeEntry> SpatialGroupTime;
 typedef SpatialGroupTime::iterator GroupTimeIter;
 
 struct ActiveGroupEntry {
@@ -476,7 +583,7 @@ struct ActiveGroupEntry {
     , outstanding(initial)
   {}
 };
-typedef std::unordered_map<GroupAddress, ActiveGroupEntry, IntHash> SpatialGroupActive;
+typedef flexus_bounded_map<GroupAddress, ActiveGroupEntry> SpatialGroupActive;
 typedef SpatialGroupActive::iterator ActiveGroupIter;
 
 enum CacheBlockState {
@@ -486,10 +593,72 @@ enum CacheBlockState {
   ePresent
 };
 const char * CacheStateStr[] = {"Prefetching", "Filling", "Prefetched", "Present"};
-typedef std::unordered_map<BlockAddress, CacheBlockState, IntHash> CacheTable;
+typedef flexus_bounded_map<BlockAddress, CacheBlockState> CacheTable;
 typedef CacheTable::iterator CacheIter;
 typedef std::pair<CacheIter, bool> CacheInsert;
 
+class GatedStatBase {
+public:
+  virtual ~GatedStatBase() {}
+  virtual void enable() = 0;
+};
+
+// A named group of statistics that is switched on as a whole for a run.
+class StatFamily {
+  std::string theName;
+  std::vector<GatedStatBase *> theStats;
+public:
+  StatFamily(std::string const & aName)
+    : theName(aName)
+  {}
+  std::string const & name() const {
+    return theName;
+  }
+  void add(GatedStatBase * aStat) {
+    theStats.push_back(aStat);
+  }
+  void enable() {
+    for (GatedStatBase * stat : theStats) {
+      stat->enable();
+    }
+  }
+};
+
+// A statistic that is created, and so registered with the StatManager, only
+// when its family is enabled.  Updates to a disabled stat cost one branch.
+template <class T_stat>
+class GatedStat : public GatedStatBase {
+  std::string theName;
+  std::unique_ptr<T_stat> theStat;
+public:
+  GatedStat(StatFamily & aFamily, std::string const & aName)
+    : theName(aName) {
+    aFamily.add(this);
+  }
+  void enable() {
+    if (!theStat) {
+      theStat.reset(new T_stat(theName));
+    }
+  }
+  GatedStat & operator ++() {
+    if (theStat) ++(*theStat);
+    return *this;
+  }
+  GatedStat & operator ++(int) {
+    if (theStat) ++(*theStat);
+    return *this;
+  }
+  GatedStat & operator +=(int64_t anUpdate) {
+    if (theStat) *theStat += anUpdate;
+    return *this;
+  }
+  template <class T_update>
+  GatedStat & operator <<(T_update const & anUpdate) {
+    if (theStat) *theStat << anUpdate;
+    return *this;
+  }
+};
+
 class SpatialPrefetcher {
 
 public:
@@ -502,129 +671,138 @@ public:
     , theCptSparseCount(0)
     , theCurrDense(false)
     , theStitchReady(false)
-    , statUsageAccess(statName + "-UsageAccess")
-    , statUsageFill(statName + "-UsageFill")
-    , statUsageOffChip(statName + "-UsageOffChip")
-    , statRepetYes(statName + "-RepetYes")
-    , statRepetCountYes(statName + "-RepetCountYes")
-    , statRepetNo(statName + "-RepetNo")
-    , statRepetCountNo(statName + "-RepetCountNo")
-    , statRepetHit(statName + "-RepetHit")
-    , statRepetTraining(statName + "-RepetTraining")
-    , statRepetMispred(statName + "-RepetMispred")
-    , statRepetMiss(statName + "-RepetMisses")
-    , statRepetFillsYes(statName + "-RepetFills")
-    , statRepetFillsNo(statName + "-RepetFillNo")
-    , statRepetFillHit(statName + "-RepetFillHit")
-    , statRepetFillTraining(statName + "-RepetFillTraining")
-    , statRepetFillMispred(statName + "-RepetFillMispred")
-    , statRepetCovGen(statName + "-RepetCovGen")
-    , statRepetOffChipYes(statName + "-RepetOffChipYes")
-    , statRepetOffChipNo(statName + "-RepetOffChipNo")
-    , statRepetOffChipHit(statName + "-RepetOffChipHit")
-    , statRepetOffChipTraining(statName + "-RepetOffChipTraining")
-    , statRepetOffChipMispred(statName + "-RepetOffChipMispred")
-    , statRepetAccessFill(statName + "-RepetAccessFill")
-    , statRepetOnlyAccess(statName + "-RepetOnlyAccess")
-    , statRepetOnlyFill(statName + "-RepetOnlyFill")
-    , statRepetUsageAccess(statName + "-RepetzAccessFill")
-    , statRepetUsageFill(statName + "-RepetzUsageFill")
-    , statRepetUsageOffChip(statName + "-RepetzUsageOffChip")
-    , statRepetUsageCov(statName + "-RepetzUsageCov")
-    , statRepetSparseNew(statName + "-RepetSparseNew")
-    , statRepetSparseRemove(statName + "-RepetSparseRemove")
-    , statRepetEndGenNoIndex(statName + "-RepetEndGenNoIndex")
-    , statRepetEvictCptNoIndex(statName + "-RepetEvictCptNoIndex")
-    , statRepetLateIndex(statName + "-RepetLateIndex")
-    , statRepetNextGenNoIndex(statName + "-RepetNextGenNoIndex")
-    , statRepetChangeIndex(statName + "-RepetChangeIndex")
-    , statRepetTriggerIndex(statName + "-RepetTriggerIndex")
-    , statRepetEndGenNoIndexAccesses(statName + "-RepetEndGenNoIndexAccesses")
-    , statRepetEndGenNoIndexMisses(statName + "-RepetEndGenNoIndexMisses")
-    , statRepetEvictCptNoIndexAccesses(statName + "-RepetEvictCptNoIndexAccesses")
-    , statRepetEvictCptNoIndexMisses(statName + "-RepetEvictCptNoIndexMisses")
-    , statRepetLateIndexAccesses(statName + "-RepetLateIndexAccesses")
-    , statRepetLateIndexMisses(statName + "-RepetLateIndexMisses")
-    , statRepetNextGenNoIndexAccesses(statName + "-RepetNextGenNoIndexAccesses")
-    , statRepetNextGenNoIndexMisses(statName + "-RepetNextGenNoIndexMisses")
-    , statRepetPattern(statName + "-RepetPattern")
-    , statRepetPatternDensity(statName + "-RepetPatternDensity")
-    , statRepetActualFillHits(statName + "-RepetActualFillHits")
-    , statRepetActualHitGens(statName + "-RepetActualHitGens")
-    , statParallelGroups(statName + "-ParallelGroups")
-    , statOrderDist(statName + "-OrderDist")
-    , statOrderBaseHitsDense(statName + "-OrderBaseHitsDense")
-    , statOrderBaseHitsSparse(statName + "-OrderBaseHitsSparse")
-    , statOrderBaseLenDense(statName + "-OrderBaseLenDense")
-    , statOrderBaseLenSparse(statName + "-OrderBaseLenSparse")
-    , statOrderDeltasDense(statName + "-OrderDeltasDense")
-    , statOrderDeltasSparse(statName + "-OrderDeltasSparse")
-    , statOrderRightJumpsDense(statName + "-OrderRightJumpsDense")
-    , statOrderRightJumpsSparse(statName + "-OrderRightJumpsSparse")
-    , statOrderLeftJumpsDense(statName + "-OrderLeftJumpsDense")
-    , statOrderLeftJumpsSparse(statName + "-OrderLeftJumpsSparse")
-    , statOrderSameDirJumpsDense(statName + "-OrderSameDirJumpsDense")
-    , statOrderSameDirJumpsSparse(statName + "-OrderSameDirJumpsSparse")
-    , statOrderDiffDirJumpsDense(statName + "-OrderDiffDirJumpsDense")
-    , statOrderDiffDirJumpsSparse(statName + "-OrderDiffDirJumpsSparse")
-    , statOrderDenseSeqOrdYesYes(statName + "-OrderDenseSeqOrdYesYes")
-    , statOrderDenseSeqOrdYesNo(statName + "-OrderDenseSeqOrdYesNo")
-    , statOrderDenseSeqOrdNoYes(statName + "-OrderDenseSeqOrdNoYes")
-    , statOrderDenseSeqOrdNoNo(statName + "-OrderDenseSeqOrdNoNo")
-    , statOrderSparseSeqOrdYesYes(statName + "-OrderSparseSeqOrdYesYes")
-    , statOrderSparseSeqOrdYesNo(statName + "-OrderSparseSeqOrdYesNo")
-    , statOrderSparseSeqOrdNoYes(statName + "-OrderSparseSeqOrdNoYes")
-    , statOrderSparseSeqOrdNoNo(statName + "-OrderSparseSeqOrdNoNo")
-    , statBufFetchMissRead(statName + "-BufFetchReadMisses")
-    , statBufFetchMissWrite(statName + "-BufFetchWriteMisses")
-    , statBufFetchPrefetch(statName + "-BufFetchPrefetches")
-    , statBufFetchDupFetch(statName + "-BufFetchDupFetches")
-    , statBufFetchDupStitch(statName + "-BufFetchDupStitch")
-    , statBufFetchGoodRead(statName + "-BufFetchGoodReadFetches")
-    , statBufFetchGoodWrite(statName + "-BufFetchGoodWriteFetches")
-    , statBufFetchGoodReadOS(statName + "-BufFetchGoodReadOS")
-    , statBufFetchGoodWriteOS(statName + "-BufFetchGoodWriteOS")
-    , statBufFetchAccessRead(statName + "-BufFetchGoodReadAccesses")
-    , statBufFetchAccessWrite(statName + "-BufFetchGoodWriteAccesses")
-    , statBufFetchInval(statName + "-BufFetchInvalFetches")
-    , statBufFetchDiscard(statName + "-BufFetchDiscardFetches")
-    , statBufFetchTriggers(statName + "-BufFetchTriggers")
-    , statBufFetchGens(statName + "-BufFetchGensWithPrefetch")
-    , statBufFetchGenSize(statName + "-BufFetchGenSize")
-    , statBufFetchDist(statName + "-BufFetchDistanceToUse")
-    , statBufFetchDenseDist(statName + "-BufFetchDenseDistance")
-    , statBufFetchSparseDist(statName + "-BufFetchSparseDistance")
-    , statStreamNewStream(statName + "-StreamNewStream")
-    , statStreamShortStream(statName + "-StreamShortStream")
-    , statStreamReplaceStream(statName + "-StreamReplaceStream")
-    , statStreamEndStream(statName + "-StreamEndStream")
-    , statStreamOrphanHit(statName + "-StreamOrphanHit")
-    , statStreamLenDense(statName + "-StreamLenDense")
-    , statStreamLenSparse(statName + "-StreamLenSparse")
-    , statStreamLenPossibleDense(statName + "-StreamLenPossibleDense")
-    , statStreamLenPossibleSparse(statName + "-StreamLenPossibleSparse")
-    , statTimeInterAccess(statName + "-TimeInterAccess")
-    , statTimeInterDeadAccess(statName + "-TimeInterDeadAccess")
-    , statTimeInterEvict(statName + "-TimeInterEvict")
-    , statTimeInterLiveEvict(statName + "-TimeInterLiveEvict")
-    , statTimeGroupLive(statName + "-TimeGroupLive")
-    , statTimeGroupDead(statName + "-TimeGroupDead")
-    , statTimeInterBegin(statName + "-TimeInterBegin")
-    , statTimeInterEnd(statName + "-TimeInterEnd")
-    , statPrefetchYes(statName + "-PrefetchYes")
-    , statPrefetchNo(statName + "-PrefetchNo")
-    , statPrefetchCount(statName + "-PrefetchCount")
-    , statFills(statName + "-Fills")
-    , statPrefetches(statName + "-Prefetches")
-    , statCorrect(statName + "-GoodPrefetches")
-    , statPartial(statName + "-PartialPrefetches")
-    , statLate(statName + "-LatePrefetches")
-    , statDup(statName + "-DuplicatePrefetches")
-    , statMispredictEvicts(statName + "-EvictPrefetches")
-    , statMispredictInvals(statName + "-InvalPrefetches")
-    , statEvictions(statName + "-Evictions")
-    , statInvalidations(statName + "-Invalidations")
-    , statInserts(statName + "-Insertions")
+    , theUsageFamily("usage")
+    , theRepetFamily("repet")
+    , theActiveFamily("active")
+    , theOrderFamily("order")
+    , theBufFetchFamily("buffetch")
+    , theStreamFamily("stream")
+    , theTimeFamily("time")
+    , thePrefetchFamily("prefetch")
+    , statUsageAccess(theUsageFamily, statName + "-UsageAccess")
+    , statUsageFill(theUsageFamily, statName + "-UsageFill")
+    , statUsageOffChip(theUsageFamily, statName + "-UsageOffChip")
+    , statRepetYes(theRepetFamily, statName + "-RepetYes")
+    , statRepetCountYes(theRepetFamily, statName + "-RepetCountYes")
+    , statRepetNo(theRepetFamily, statName + "-RepetNo")
+    , statRepetCountNo(theRepetFamily, statName + "-RepetCountNo")
+    , statRepetHit(theRepetFamily, statName + "-RepetHit")
+    , statRepetTraining(theRepetFamily, statName + "-RepetTraining")
+    , statRepetMispred(theRepetFamily, statName + "-RepetMispred")
+    , statRepetMiss(theRepetFamily, statName + "-RepetMisses")
+    , statRepetFillsYes(theRepetFamily, statName + "-RepetFills")
+    , statRepetFillsNo(theRepetFamily, statName + "-RepetFillNo")
+    , statRepetFillHit(theRepetFamily, statName + "-RepetFillHit")
+    , statRepetFillTraining(theRepetFamily, statName + "-RepetFillTraining")
+    , statRepetFillMispred(theRepetFamily, statName + "-RepetFillMispred")
+    , statRepetCovGen(theRepetFamily, statName + "-RepetCovGen")
+    , statRepetOffChipYes(theRepetFamily, statName + "-RepetOffChipYes")
+    , statRepetOffChipNo(theRepetFamily, statName + "-RepetOffChipNo")
+    , statRepetOffChipHit(theRepetFamily, statName + "-RepetOffChipHit")
+    , statRepetOffChipTraining(theRepetFamily, statName + "-RepetOffChipTraining")
+    , statRepetOffChipMispred(theRepetFamily, statName + "-RepetOffChipMispred")
+    , statRepetAccessFill(theRepetFamily, statName + "-RepetAccessFill")
+    , statRepetOnlyAccess(theRepetFamily, statName + "-RepetOnlyAccess")
+    , statRepetOnlyFill(theRepetFamily, statName + "-RepetOnlyFill")
+    , statRepetUsageAccess(theRepetFamily, statName + "-RepetzAccessFill")
+    , statRepetUsageFill(theRepetFamily, statName + "-RepetzUsageFill")
+    , statRepetUsageOffChip(theRepetFamily, statName + "-RepetzUsageOffChip")
+    , statRepetUsageCov(theRepetFamily, statName + "-RepetzUsageCov")
+    , statRepetSparseNew(theRepetFamily, statName + "-RepetSparseNew")
+    , statRepetSparseRemove(theRepetFamily, statName + "-RepetSparseRemove")
+    , statRepetEndGenNoIndex(theRepetFamily, statName + "-RepetEndGenNoIndex")
+    , statRepetEvictCptNoIndex(theRepetFamily, statName + "-RepetEvictCptNoIndex")
+    , statRepetLateIndex(theRepetFamily, statName + "-RepetLateIndex")
+    , statRepetNextGenNoIndex(theRepetFamily, statName + "-RepetNextGenNoIndex")
+    , statRepetChangeIndex(theRepetFamily, statName + "-RepetChangeIndex")
+    , statRepetTriggerIndex(theRepetFamily, statName + "-RepetTriggerIndex")
+    , statRepetEndGenNoIndexAccesses(theRepetFamily, statName + "-RepetEndGenNoIndexAccesses")
+    , statRepetEndGenNoIndexMisses(theRepetFamily, statName + "-RepetEndGenNoIndexMisses")
+    , statRepetEvictCptNoIndexAccesses(theRepetFamily, statName + "-RepetEvictCptNoIndexAccesses")
+    , statRepetEvictCptNoIndexMisses(theRepetFamily, statName + "-RepetEvictCptNoIndexMisses")
+    , statRepetLateIndexAccesses(theRepetFamily, statName + "-RepetLateIndexAccesses")
+    , statRepetLateIndexMisses(theRepetFamily, statName + "-RepetLateIndexMisses")
+    , statRepetNextGenNoIndexAccesses(theRepetFamily, statName + "-RepetNextGenNoIndexAccesses")
+    , statRepetNextGenNoIndexMisses(theRepetFamily, statName + "-RepetNextGenNoIndexMisses")
+    , statRepetPattern(theRepetFamily, statName + "-RepetPattern")
+    , statRepetPatternDensity(theRepetFamily, statName + "-RepetPatternDensity")
+    , statRepetActualFillHits(theRepetFamily, statName + "-RepetActualFillHits")
+    , statRepetActualHitGens(theRepetFamily, statName + "-RepetActualHitGens")
+    , statParallelGroups(theActiveFamily, statName + "-ParallelGroups")
+    , statOrderDist(theOrderFamily, statName + "-OrderDist")
+    , statOrderBaseHitsDense(theOrderFamily, statName + "-OrderBaseHitsDense")
+    , statOrderBaseHitsSparse(theOrderFamily, statName + "-OrderBaseHitsSparse")
+    , statOrderBaseLenDense(theOrderFamily, statName + "-OrderBaseLenDense")
+    , statOrderBaseLenSparse(theOrderFamily, statName + "-OrderBaseLenSparse")
+    , statOrderDeltasDense(theOrderFamily, statName + "-OrderDeltasDense")
+    , statOrderDeltasSparse(theOrderFamily, statName + "-OrderDeltasSparse")
+    , statOrderRightJumpsDense(theOrderFamily, statName + "-OrderRightJumpsDense")
+    , statOrderRightJumpsSparse(theOrderFamily, statName + "-OrderRightJumpsSparse")
+    , statOrderLeftJumpsDense(theOrderFamily, statName + "-OrderLeftJumpsDense")
+    , statOrderLeftJumpsSparse(theOrderFamily, statName + "-OrderLeftJumpsSparse")
+    , statOrderSameDirJumpsDense(theOrderFamily, statName + "-OrderSameDirJumpsDense")
+    , statOrderSameDirJumpsSparse(theOrderFamily, statName + "-OrderSameDirJumpsSparse")
+    , statOrderDiffDirJumpsDense(theOrderFamily, statName + "-OrderDiffDirJumpsDense")
+    , statOrderDiffDirJumpsSparse(theOrderFamily, statName + "-OrderDiffDirJumpsSparse")
+    , statOrderDenseSeqOrdYesYes(theOrderFamily, statName + "-OrderDenseSeqOrdYesYes")
+    , statOrderDenseSeqOrdYesNo(theOrderFamily, statName + "-OrderDenseSeqOrdYesNo")
+    , statOrderDenseSeqOrdNoYes(theOrderFamily, statName + "-OrderDenseSeqOrdNoYes")
+    , statOrderDenseSeqOrdNoNo(theOrderFamily, statName + "-OrderDenseSeqOrdNoNo")
+    , statOrderSparseSeqOrdYesYes(theOrderFamily, statName + "-OrderSparseSeqOrdYesYes")
+    , statOrderSparseSeqOrdYesNo(theOrderFamily, statName + "-OrderSparseSeqOrdYesNo")
+    , statOrderSparseSeqOrdNoYes(theOrderFamily, statName + "-OrderSparseSeqOrdNoYes")
+    , statOrderSparseSeqOrdNoNo(theOrderFamily, statName + "-OrderSparseSeqOrdNoNo")
+    , statBufFetchMissRead(theBufFetchFamily, statName + "-BufFetchReadMisses")
+    , statBufFetchMissWrite(theBufFetchFamily, statName + "-BufFetchWriteMisses")
+    , statBufFetchPrefetch(theBufFetchFamily, statName + "-BufFetchPrefetches")
+    , statBufFetchDupFetch(theBufFetchFamily, statName + "-BufFetchDupFetches")
+    , statBufFetchDupStitch(theBufFetchFamily, statName + "-BufFetchDupStitch")
+    , statBufFetchGoodRead(theBufFetchFamily, statName + "-BufFetchGoodReadFetches")
+    , statBufFetchGoodWrite(theBufFetchFamily, statName + "-BufFetchGoodWriteFetches")
+    , statBufFetchGoodReadOS(theBufFetchFamily, statName + "-BufFetchGoodReadOS")
+    , statBufFetchGoodWriteOS(theBufFetchFamily, statName + "-BufFetchGoodWriteOS")
+    , statBufFetchAccessRead(theBufFetchFamily, statName + "-BufFetchGoodReadAccesses")
+    , statBufFetchAccessWrite(theBufFetchFamily, statName + "-BufFetchGoodWriteAccesses")
+    , statBufFetchInval(theBufFetchFamily, statName + "-BufFetchInvalFetches")
+    , statBufFetchDiscard(theBufFetchFamily, statName + "-BufFetchDiscardFetches")
+    , statBufFetchTriggers(theBufFetchFamily, statName + "-BufFetchTriggers")
+    , statBufFetchGens(theBufFetchFamily, statName + "-BufFetchGensWithPrefetch")
+    , statBufFetchGenSize(theBufFetchFamily, statName + "-BufFetchGenSize")
+    , statBufFetchDist(theBufFetchFamily, statName + "-BufFetchDistanceToUse")
+    , statBufFetchDenseDist(theBufFetchFamily, statName + "-BufFetchDenseDistance")
+    , statBufFetchSparseDist(theBufFetchFamily, statName + "-BufFetchSparseDistance")
+    , statStreamNewStream(theStreamFamily, statName + "-StreamNewStream")
+    , statStreamShortStream(theStreamFamily, statName + "-StreamShortStream")
+    , statStreamReplaceStream(theStreamFamily, statName + "-StreamReplaceStream")
+    , statStreamEndStream(theStreamFamily, statName + "-StreamEndStream")
+    , statStreamOrphanHit(theStreamFamily, statName + "-StreamOrphanHit")
+    , statStreamLenDense(theStreamFamily, statName + "-StreamLenDense")
+    , statStreamLenSparse(theStreamFamily, statName + "-StreamLenSparse")
+    , statStreamLenPossibleDense(theStreamFamily, statName + "-StreamLenPossibleDense")
+    , statStreamLenPossibleSparse(theStreamFamily, statName + "-StreamLenPossibleSparse")
+    , statTimeInterAccess(theTimeFamily, statName + "-TimeInterAccess")
+    , statTimeInterDeadAccess(theTimeFamily, statName + "-TimeInterDeadAccess")
+    , statTimeInterEvict(theTimeFamily, statName + "-TimeInterEvict")
+    , statTimeInterLiveEvict(theTimeFamily, statName + "-TimeInterLiveEvict")
+    , statTimeGroupLive(theTimeFamily, statName + "-TimeGroupLive")
+    , statTimeGroupDead(theTimeFamily, statName + "-TimeGroupDead")
+    , statTimeInterBegin(theTimeFamily, statName + "-TimeInterBegin")
+    , statTimeInterEnd(theTimeFamily, statName + "-TimeInterEnd")
+    , statPrefetchYes(thePrefetchFamily, statName + "-PrefetchYes")
+    , statPrefetchNo(thePrefetchFamily, statName + "-PrefetchNo")
+    , statPrefetchCount(thePrefetchFamily, statName + "-PrefetchCount")
+    , statFills(thePrefetchFamily, statName + "-Fills")
+    , statPrefetches(thePrefetchFamily, statName + "-Prefetches")
+    , statCorrect(thePrefetchFamily, statName + "-GoodPrefetches")
+    , statPartial(thePrefetchFamily, statName + "-PartialPrefetches")
+    , statLate(thePrefetchFamily, statName + "-LatePrefetches")
+    , statDup(thePrefetchFamily, statName + "-DuplicatePrefetches")
+    , statMispredictEvicts(thePrefetchFamily, statName + "-EvictPrefetches")
+    , statMispredictInvals(thePrefetchFamily, statName + "-InvalPrefetches")
+    , statEvictions(thePrefetchFamily, statName + "-Evictions")
+    , statInvalidations(thePrefetchFamily, statName + "-Invalidations")
+    , statInserts(thePrefetchFamily, statName + "-Insertions")
+    , statTableEvictions(thePrefetchFamily, statName + "-TableEvictions")
   {}
 
   void init(bool enableUsageStats, bool enableRepetStats, bool enableBufFetch,
@@ -634,10 +812,12 @@ public:
             bool sparseOpt, int32_t phtSize, int32_t phtAssoc, int32_t pcBits,
             int32_t cptType, int32_t cptSize, int32_t cptAssoc, bool cptSparse,
             bool fetchDist, int32_t streamWindow, bool streamDense, bool sendStreams,
-            int32_t bufSize, int32_t streamDescs, bool delayedCommits, int32_t cptFilterSize) {
+            int32_t bufSize, int32_t streamDescs, bool delayedCommits, int32_t cptFilterSize,
+            int32_t tableCapacity, std::string const & statFamilies) {
     DBG_(Dev, ( << theName << ": Initializing SGP - spatial group: " << sgpBlocks << " " << blockSize << "B blocks" ) );
     theBlockSize = blockSize;
     theSgpBlocks = sgpBlocks;
+    DBG_Assert( !enableOrdering || sgpBlocks <= static_cast<int32_t>(BlockOrdering::kMaxBlocks), ( << "Group size of " << sgpBlocks << " not supported for ordering." ) );
     theRepetType = repetType;
     theRepetFills = repetFills;
     theSparseOpt = sparseOpt;
@@ -656,6 +836,8 @@ public:
     theBufSize = bufSize;
     theStreamDescs = streamDescs;
     theDelayedCommits = delayedCommits;
+    theTableCapacity = tableCapacity;
+    enableStatFamilies(statFamilies);
     theEnableUsage = enableUsageStats;
     theEnableRepet = enableRepetStats;
     theEnableBufFetch = enableBufFetch;
@@ -695,6 +877,18 @@ public:
 
     thePCmask = (1ULL << thePcBits) - 1;
 
+    // the ordering build table shadows the CPT one-to-one, so it is sized
+    // with the CPT and never evicts on its own
+    if (theCptType == 1 && theCptSize > 0) {
+      theOrderingBuild.reserve(theCptSize);
+    }
+    theDoneStreams.setCapacity(theTableCapacity);
+    theGroupTimes.setCapacity(theTableCapacity);
+    theActiveGroups.setCapacity(theTableCapacity);
+    theActiveGroups.setEvictionCallback( [this](GroupAddress const & aGroup, ActiveGroupEntry & anEntry) {
+      this->evictActiveGroup(aGroup, anEntry);
+    });
+
     DBG_(Iface, ( << "blockOffsetMask:" << std::hex << theBlockOffsetMask << std::dec
                   << " blockBits:" << theBlockBits << " sgpBits:" << theSgpBits
                   << " wordBits:" << theWordBits << " byteBits:" << theByteBits ) );
@@ -704,6 +898,12 @@ public:
       //theMaxSgpBits = mylog2(cacheSize / blockSize);
       theMaxSgpBits = 6;
       theGroupUsages.resize(theMaxSgpBits + 1);
+      for (uint32_t bits = 0; bits <= theMaxSgpBits; bits++) {
+        theGroupUsages[bits].setCapacity(theTableCapacity);
+        theGroupUsages[bits].setEvictionCallback( [this, bits](GroupAddress const &, SpatialPattern & aPattern) {
+          this->finalizeGroupUsage(aPattern, bits);
+        });
+      }
 
       unsigned ii;
       for (ii = 0; ii <= theMaxSgpBits; ii++) {
@@ -816,6 +1016,12 @@ public:
     theRegionFile.close();
     */
 
+    uint64_t tableEvictions = theDoneStreams.evictions() + theGroupTimes.evictions() + theActiveGroups.evictions();
+    for (uint32_t bits = 0; bits < theGroupUsages.size(); bits++) {
+      tableEvictions += theGroupUsages[bits].evictions();
+    }
+    statTableEvictions += tableEvictions;
+
     if (theEnableActive) {
       ActiveGenIter begins = theActiveGenBegins.begin();
       ActiveGenIter ends = theActiveGenEnds.begin();
@@ -973,7 +1179,7 @@ private:
   GroupRepetHistory theRepetHistory;
   GroupRepetAssocHistory theRepetAssocHistory;
 
-  typedef flexus_boost_seq_map<SpatialPattern, int> RepetPatternTable;
+  typedef flexus_boost_seq_map<SpatialPattern, int, PatternHash> RepetPatternTable;
   typedef RepetPatternTable::iterator RepetPatternIter;
   RepetPatternTable theRepetPatterns;
 
@@ -1037,6 +1243,7 @@ private:
   uint32_t theBufSize;
   uint32_t theStreamDescs;
   bool theDelayedCommits;
+  uint32_t theTableCapacity;
 
   int64_t theCptSparseCount;
   bool theCurrDense;
@@ -1062,144 +1269,155 @@ private:
   bool theEnableStreaming;
   bool theEnableStitch;
 
-  Stat::StatInstanceCounter<int64_t> statUsageAccess;
-  Stat::StatInstanceCounter<int64_t> statUsageFill;
-  Stat::StatInstanceCounter<int64_t> statUsageOffChip;
-
-  Stat::StatCounter statRepetYes;
-  Stat::StatCounter statRepetCountYes;
-  Stat::StatCounter statRepetNo;
-  Stat::StatCounter statRepetCountNo;
-
-  Stat::StatCounter statRepetHit;
-  Stat::StatCounter statRepetTraining;
-  Stat::StatCounter statRepetMispred;
-
-  Stat::StatCounter statRepetMiss;
-  Stat::StatCounter statRepetFillsYes;
-  Stat::StatCounter statRepetFillsNo;
-  Stat::StatCounter statRepetFillHit;
-  Stat::StatCounter statRepetFillTraining;
-  Stat::StatCounter statRepetFillMispred;
-  Stat::StatCounter statRepetCovGen;
-
-  Stat::StatCounter statRepetOffChipYes;
-  Stat::StatCounter statRepetOffChipNo;
-  Stat::StatCounter statRepetOffChipHit;
-  Stat::StatCounter statRepetOffChipTraining;
-  Stat::StatCounter statRepetOffChipMispred;
-
-  Stat::StatCounter statRepetAccessFill;
-  Stat::StatCounter statRepetOnlyAccess;
-  Stat::StatCounter statRepetOnlyFill;
-
-  Stat::StatInstanceCounter<int64_t> statRepetUsageAccess;
-  Stat::StatInstanceCounter<int64_t> statRepetUsageFill;
-  Stat::StatInstanceCounter<int64_t> statRepetUsageOffChip;
-  Stat::StatInstanceCounter<int64_t> statRepetUsageCov;
-
-  Stat::StatCounter statRepetSparseNew;
-  Stat::StatCounter statRepetSparseRemove;
-
-  Stat::StatCounter statRepetEndGenNoIndex;
-  Stat::StatCounter statRepetEvictCptNoIndex;
-  Stat::StatCounter statRepetLateIndex;
-  Stat::StatCounter statRepetNextGenNoIndex;
-  Stat::StatCounter statRepetChangeIndex;
-  Stat::StatCounter statRepetTriggerIndex;
-  Stat::StatInstanceCounter<int64_t> statRepetEndGenNoIndexAccesses;
-  Stat::StatInstanceCounter<int64_t> statRepetEndGenNoIndexMisses;
-  Stat::StatInstanceCounter<int64_t> statRepetEvictCptNoIndexAccesses;
-  Stat::StatInstanceCounter<int64_t> statRepetEvictCptNoIndexMisses;
-  Stat::StatInstanceCounter<int64_t> statRepetLateIndexAccesses;
-  Stat::StatInstanceCounter<int64_t> statRepetLateIndexMisses;
-  Stat::StatInstanceCounter<int64_t> statRepetNextGenNoIndexAccesses;
-  Stat::StatInstanceCounter<int64_t> statRepetNextGenNoIndexMisses;
-
-  Stat::StatInstanceCounter<int64_t> statRepetPattern;
-  Stat::StatInstanceCounter<int64_t> statRepetPatternDensity;
-  Stat::StatInstanceCounter<int64_t> statRepetActualFillHits;
-  Stat::StatCounter statRepetActualHitGens;
-  Stat::StatInstanceCounter<int64_t> statParallelGroups;
-  Stat::StatInstanceCounter<int64_t> statOrderDist;
-
-  Stat::StatCounter statOrderBaseHitsDense;
-  Stat::StatCounter statOrderBaseHitsSparse;
-  Stat::StatInstanceCounter<int64_t> statOrderBaseLenDense;
-  Stat::StatInstanceCounter<int64_t> statOrderBaseLenSparse;
-  Stat::StatInstanceCounter<int64_t> statOrderDeltasDense;
-  Stat::StatInstanceCounter<int64_t> statOrderDeltasSparse;
-  Stat::StatInstanceCounter<int64_t> statOrderRightJumpsDense;
-  Stat::StatInstanceCounter<int64_t> statOrderRightJumpsSparse;
-  Stat::StatInstanceCounter<int64_t> statOrderLeftJumpsDense;
-  Stat::StatInstanceCounter<int64_t> statOrderLeftJumpsSparse;
-  Stat::StatInstanceCounter<int64_t> statOrderSameDirJumpsDense;
-  Stat::StatInstanceCounter<int64_t> statOrderSameDirJumpsSparse;
-  Stat::StatInstanceCounter<int64_t> statOrderDiffDirJumpsDense;
-  Stat::StatInstanceCounter<int64_t> statOrderDiffDirJumpsSparse;
-  Stat::StatCounter statOrderDenseSeqOrdYesYes;
-  Stat::StatCounter statOrderDenseSeqOrdYesNo;
-  Stat::StatCounter statOrderDenseSeqOrdNoYes;
-  Stat::StatCounter statOrderDenseSeqOrdNoNo;
-  Stat::StatCounter statOrderSparseSeqOrdYesYes;
-  Stat::StatCounter statOrderSparseSeqOrdYesNo;
-  Stat::StatCounter statOrderSparseSeqOrdNoYes;
-  Stat::StatCounter statOrderSparseSeqOrdNoNo;
-
-  Stat::StatCounter statBufFetchMissRead;
-  Stat::StatCounter statBufFetchMissWrite;
-  Stat::StatCounter statBufFetchPrefetch;
-  Stat::StatCounter statBufFetchDupFetch;
-  Stat::StatCounter statBufFetchDupStitch;
-  Stat::StatCounter statBufFetchGoodRead;
-  Stat::StatCounter statBufFetchGoodWrite;
-  Stat::StatCounter statBufFetchGoodReadOS;
-  Stat::StatCounter statBufFetchGoodWriteOS;
-  Stat::StatCounter statBufFetchAccessRead;
-  Stat::StatCounter statBufFetchAccessWrite;
-  Stat::StatCounter statBufFetchInval;
-  Stat::StatCounter statBufFetchDiscard;
-  Stat::StatCounter statBufFetchTriggers;
-  Stat::StatCounter statBufFetchGens;
-  Stat::StatInstanceCounter<int64_t> statBufFetchGenSize;
-  Stat::StatLog2Histogram statBufFetchDist;
-  Stat::StatLog2Histogram statBufFetchDenseDist;
-  Stat::StatLog2Histogram statBufFetchSparseDist;
-
-  Stat::StatCounter statStreamNewStream;
-  Stat::StatCounter statStreamShortStream;
-  Stat::StatCounter statStreamReplaceStream;
-  Stat::StatCounter statStreamEndStream;
-  Stat::StatCounter statStreamOrphanHit;
-  Stat::StatInstanceCounter<int64_t> statStreamLenDense;
-  Stat::StatInstanceCounter<int64_t> statStreamLenSparse;
-  Stat::StatInstanceCounter<int64_t> statStreamLenPossibleDense;
-  Stat::StatInstanceCounter<int64_t> statStreamLenPossibleSparse;
-
-  Stat::StatLog2Histogram statTimeInterAccess;
-  Stat::StatLog2Histogram statTimeInterDeadAccess;
-  Stat::StatLog2Histogram statTimeInterEvict;
-  Stat::StatLog2Histogram statTimeInterLiveEvict;
-  Stat::StatLog2Histogram statTimeGroupLive;
-  Stat::StatLog2Histogram statTimeGroupDead;
-  Stat::StatLog2Histogram statTimeInterBegin;
-  Stat::StatLog2Histogram statTimeInterEnd;
-
-  Stat::StatCounter statPrefetchYes;
-  Stat::StatCounter statPrefetchNo;
-  Stat::StatCounter statPrefetchCount;
-
-  Stat::StatCounter statFills;
-  Stat::StatCounter statPrefetches;
-  Stat::StatCounter statCorrect;
-  Stat::StatCounter statPartial;
-  Stat::StatCounter statLate;
-  Stat::StatCounter statDup;
-  Stat::StatCounter statMispredictEvicts;
-  Stat::StatCounter statMispredictInvals;
-  Stat::StatCounter statEvictions;
-  Stat::StatCounter statInvalidations;
-  Stat::StatCounter statInserts;
+  // statistic families; a stat is registered only if its family is enabled
+  StatFamily theUsageFamily;
+  StatFamily theRepetFamily;
+  StatFamily theActiveFamily;
+  StatFamily theOrderFamily;
+  StatFamily theBufFetchFamily;
+  StatFamily theStreamFamily;
+  StatFamily theTimeFamily;
+  StatFamily thePrefetchFamily;
+
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statUsageAccess;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statUsageFill;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statUsageOffChip;
+
+  GatedStat<Stat::StatCounter> statRepetYes;
+  GatedStat<Stat::StatCounter> statRepetCountYes;
+  GatedStat<Stat::StatCounter> statRepetNo;
+  GatedStat<Stat::StatCounter> statRepetCountNo;
+
+  GatedStat<Stat::StatCounter> statRepetHit;
+  GatedStat<Stat::StatCounter> statRepetTraining;
+  GatedStat<Stat::StatCounter> statRepetMispred;
+
+  GatedStat<Stat::StatCounter> statRepetMiss;
+  GatedStat<Stat::StatCounter> statRepetFillsYes;
+  GatedStat<Stat::StatCounter> statRepetFillsNo;
+  GatedStat<Stat::StatCounter> statRepetFillHit;
+  GatedStat<Stat::StatCounter> statRepetFillTraining;
+  GatedStat<Stat::StatCounter> statRepetFillMispred;
+  GatedStat<Stat::StatCounter> statRepetCovGen;
+
+  GatedStat<Stat::StatCounter> statRepetOffChipYes;
+  GatedStat<Stat::StatCounter> statRepetOffChipNo;
+  GatedStat<Stat::StatCounter> statRepetOffChipHit;
+  GatedStat<Stat::StatCounter> statRepetOffChipTraining;
+  GatedStat<Stat::StatCounter> statRepetOffChipMispred;
+
+  GatedStat<Stat::StatCounter> statRepetAccessFill;
+  GatedStat<Stat::StatCounter> statRepetOnlyAccess;
+  GatedStat<Stat::StatCounter> statRepetOnlyFill;
+
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statRepetUsageAccess;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statRepetUsageFill;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statRepetUsageOffChip;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statRepetUsageCov;
+
+  GatedStat<Stat::StatCounter> statRepetSparseNew;
+  GatedStat<Stat::StatCounter> statRepetSparseRemove;
+
+  GatedStat<Stat::StatCounter> statRepetEndGenNoIndex;
+  GatedStat<Stat::StatCounter> statRepetEvictCptNoIndex;
+  GatedStat<Stat::StatCounter> statRepetLateIndex;
+  GatedStat<Stat::StatCounter> statRepetNextGenNoIndex;
+  GatedStat<Stat::StatCounter> statRepetChangeIndex;
+  GatedStat<Stat::StatCounter> statRepetTriggerIndex;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statRepetEndGenNoIndexAccesses;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statRepetEndGenNoIndexMisses;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statRepetEvictCptNoIndexAccesses;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statRepetEvictCptNoIndexMisses;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statRepetLateIndexAccesses;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statRepetLateIndexMisses;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statRepetNextGenNoIndexAccesses;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statRepetNextGenNoIndexMisses;
+
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statRepetPattern;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statRepetPatternDensity;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statRepetActualFillHits;
+  GatedStat<Stat::StatCounter> statRepetActualHitGens;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statParallelGroups;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statOrderDist;
+
+  GatedStat<Stat::StatCounter> statOrderBaseHitsDense;
+  GatedStat<Stat::StatCounter> statOrderBaseHitsSparse;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statOrderBaseLenDense;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statOrderBaseLenSparse;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statOrderDeltasDense;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statOrderDeltasSparse;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statOrderRightJumpsDense;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statOrderRightJumpsSparse;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statOrderLeftJumpsDense;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statOrderLeftJumpsSparse;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statOrderSameDirJumpsDense;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statOrderSameDirJumpsSparse;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statOrderDiffDirJumpsDense;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statOrderDiffDirJumpsSparse;
+  GatedStat<Stat::StatCounter> statOrderDenseSeqOrdYesYes;
+  GatedStat<Stat::StatCounter> statOrderDenseSeqOrdYesNo;
+  GatedStat<Stat::StatCounter> statOrderDenseSeqOrdNoYes;
+  GatedStat<Stat::StatCounter> statOrderDenseSeqOrdNoNo;
+  GatedStat<Stat::StatCounter> statOrderSparseSeqOrdYesYes;
+  GatedStat<Stat::StatCounter> statOrderSparseSeqOrdYesNo;
+  GatedStat<Stat::StatCounter> statOrderSparseSeqOrdNoYes;
+  GatedStat<Stat::StatCounter> statOrderSparseSeqOrdNoNo;
+
+  GatedStat<Stat::StatCounter> statBufFetchMissRead;
+  GatedStat<Stat::StatCounter> statBufFetchMissWrite;
+  GatedStat<Stat::StatCounter> statBufFetchPrefetch;
+  GatedStat<Stat::StatCounter> statBufFetchDupFetch;
+  GatedStat<Stat::StatCounter> statBufFetchDupStitch;
+  GatedStat<Stat::StatCounter> statBufFetchGoodRead;
+  GatedStat<Stat::StatCounter> statBufFetchGoodWrite;
+  GatedStat<Stat::StatCounter> statBufFetchGoodReadOS;
+  GatedStat<Stat::StatCounter> statBufFetchGoodWriteOS;
+  GatedStat<Stat::StatCounter> statBufFetchAccessRead;
+  GatedStat<Stat::StatCounter> statBufFetchAccessWrite;
+  GatedStat<Stat::StatCounter> statBufFetchInval;
+  GatedStat<Stat::StatCounter> statBufFetchDiscard;
+  GatedStat<Stat::StatCounter> statBufFetchTriggers;
+  GatedStat<Stat::StatCounter> statBufFetchGens;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statBufFetchGenSize;
+  GatedStat<Stat::StatLog2Histogram> statBufFetchDist;
+  GatedStat<Stat::StatLog2Histogram> statBufFetchDenseDist;
+  GatedStat<Stat::StatLog2Histogram> statBufFetchSparseDist;
+
+  GatedStat<Stat::StatCounter> statStreamNewStream;
+  GatedStat<Stat::StatCounter> statStreamShortStream;
+  GatedStat<Stat::StatCounter> statStreamReplaceStream;
+  GatedStat<Stat::StatCounter> statStreamEndStream;
+  GatedStat<Stat::StatCounter> statStreamOrphanHit;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statStreamLenDense;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statStreamLenSparse;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statStreamLenPossibleDense;
+  GatedStat<Stat::StatInstanceCounter<int64_t>> statStreamLenPossibleSparse;
+
+  GatedStat<Stat::StatLog2Histogram> statTimeInterAccess;
+  GatedStat<Stat::StatLog2Histogram> statTimeInterDeadAccess;
+  GatedStat<Stat::StatLog2Histogram> statTimeInterEvict;
+  GatedStat<Stat::StatLog2Histogram> statTimeInterLiveEvict;
+  GatedStat<Stat::StatLog2Histogram> statTimeGroupLive;
+  GatedStat<Stat::StatLog2Histogram> statTimeGroupDead;
+  GatedStat<Stat::StatLog2Histogram> statTimeInterBegin;
+  GatedStat<Stat::StatLog2Histogram> statTimeInterEnd;
+
+  GatedStat<Stat::StatCounter> statPrefetchYes;
+  GatedStat<Stat::StatCounter> statPrefetchNo;
+  GatedStat<Stat::StatCounter> statPrefetchCount;
+
+  GatedStat<Stat::StatCounter> statFills;
+  GatedStat<Stat::StatCounter> statPrefetches;
+  GatedStat<Stat::StatCounter> statCorrect;
+  GatedStat<Stat::StatCounter> statPartial;
+  GatedStat<Stat::StatCounter> statLate;
+  GatedStat<Stat::StatCounter> statDup;
+  GatedStat<Stat::StatCounter> statMispredictEvicts;
+  GatedStat<Stat::StatCounter> statMispredictInvals;
+  GatedStat<Stat::StatCounter> statEvictions;
+  GatedStat<Stat::StatCounter> statInvalidations;
+  GatedStat<Stat::StatCounter> statInserts;
+  GatedStat<Stat::StatCounter> statTableEvictions;
 
 public:
   void access(MemoryAddress addr, MemoryAddress pc, bool prefetch, bool write, bool miss, bool priv) {
@@ -1338,6 +1556,24 @@ public:
   }
 
 private:
+  void enableStatFamilies(std::string const & aFamilies) {
+    StatFamily * families[] = { &theUsageFamily, &theRepetFamily, &theActiveFamily, &theOrderFamily,
+                                &theBufFetchFamily, &theStreamFamily, &theTimeFamily, &thePrefetchFamily
+                              };
+    std::istringstream list(aFamilies);
+    std::string name;
+    while (std::getline(list, name, ',')) {
+      bool found = false;
+      for (StatFamily * family : families) {
+        if (name == "all" || name == family->name()) {
+          family->enable();
+          found = true;
+        }
+      }
+      DBG_Assert(found, ( << theName << ": unknown stat family: " << name ) );
+    }
+  }
+
   void doGroupUsage(MemoryAddress addr, bool evict) {
     uint32_t bits;
     for (bits = theMinSgpBits; bits <= theMaxSgpBits; bits++) {
@@ -1355,6 +1591,7 @@ private:
           }
         } else {
           iter->second |= makeGroupPattern(addr, bits);
+          theGroupUsages[bits].touch(iter);
         }
       } else {
         // create a new spatial group if necessary
@@ -2726,6 +2963,19 @@ private:
     }
   }
 
+  // an active group pushed out of the bounded table ends its generation
+  // early; its outstanding prefetches leave the buffer with it
+  void evictActiveGroup(GroupAddress group, ActiveGroupEntry & entry) {
+    MemoryAddress addr = group;
+    for (uint32_t ii = 0; ii < theSgpBlocks; ii++) {
+      if (entry.outstanding.test(ii)) {
+        doBufFetchErase2(addr, false);
+      }
+      addr += theBlockSize;
+    }
+    finalizeActiveGroup(entry);
+  }
+
   void finalizeActiveGroup(ActiveGroupEntry & entry) {
     theActiveGenBegins[entry.start]++;
     theActiveGenEnds[entry.recent]++;
@@ -3208,6 +3458,7 @@ private:
     uint64_t curr = theFlexus->cycleCount();
     GroupTimeIter iter = theGroupTimes.find(group);
     if (iter != theGroupTimes.end()) {
+      theGroupTimes.touch(iter);
       if (!evict) {
         // this is an access
         if (iter->second.live) {
@@ -3239,11 +3490,12 @@ private:
           iter->second.lastEnd = curr;
         }
       }
-    } else {
-      // first occurence of this group
-      DBG_Assert(!evict);
-      DBG_Assert(beginend);
+    } else if (!evict) {
+      // first occurence of this group, or its entry aged out of the table
+      DBG_Assert(beginend || theGroupTimes.evictions() > 0);
       theGroupTimes.insert( std::make_pair(group, GroupTimeEntry(curr)) );
+    } else {
+      DBG_Assert(theGroupTimes.evictions() > 0);
     }
   }
 
@@ -78,7 +78,8 @@ public:
                                cfg.SparseOpt, cfg.PhtSize, cfg.PhtAssoc, cfg.PcBits,
                                cfg.CptType, cfg.CptSize, cfg.CptAssoc, cfg.CptSparse,
                                cfg.FetchDist, cfg.SgpBlocks /*window*/, cfg.StreamDense, true /*sendStreams*/,
-                               cfg.BufSize, cfg.StreamDescs, cfg.DelayedCommits, cfg.CptFilter);
+                               cfg.BufSize, cfg.StreamDescs, cfg.DelayedCommits, cfg.CptFilter,
+                               cfg.TableCapacity, cfg.StatFamilies);
     }
     if (!cfg.PrefetchEnable) {
       theTraceTracker.initOffChipTracking(flexusIndex());
@@ -38,9 +38,8 @@
 #include <fstream>
 #include <sstream>
 
-#include "seq_map.hpp"
-
-using namespace boost::multi_index;
+#include <deque>
+#include <vector>
 
 #define DBG_SetDefaultOps AddCat(SpatialPrefetch)
 #include DBG_Control()
@@ -52,7 +51,7 @@ typedef uint32_t MemoryAddress;
 struct ghb_it_ent_t {
   MemoryAddress tag;
   int32_t ptr;
-  ghb_it_ent_t(): tag(0), ptr(0) { }
+  ghb_it_ent_t(): tag(0), ptr(-1) { }
 };
 struct ghb_ent_t {
   MemoryAddress addr;
@@ -60,11 +59,16 @@ struct ghb_ent_t {
   ghb_ent_t(): addr(0), prev(-1) { }
 };
 
+// Global History Buffer (Nesbit & Smith) with PC-localized delta
+// correlation.  The history is a fixed circular buffer of ghb_size entries;
+// each entry links to the previous miss from the same PC by its global
+// sequence number (modulo ghb_max_idx), so a link that has been overwritten
+// by the ring is recognized and the walk stops.  The index table is a flat,
+// direct-mapped array of ghb_size PC tags.
 class GHBPrefetcher {
-  //LRUarray<ghb_it_ent_t,ghb_it_log_nsets,1> ghb_it;
-  flexus_boost_set_assoc<MemoryAddress, ghb_it_ent_t> theIndexTable;
-  typedef flexus_boost_set_assoc<MemoryAddress, ghb_it_ent_t>::iterator IndexTableIter;
-  ghb_ent_t * ghb;
+  std::vector<ghb_it_ent_t> theIndexTable;
+  std::vector<ghb_ent_t> ghb;
+  std::vector<int32_t> ghb_deltas;
   int32_t ghb_head;
 
   int64_t ghb_req_id;
@@ -78,21 +82,28 @@ class GHBPrefetcher {
   uint32_t ghb_size;
   uint32_t ghb_max_idx;
   uint32_t ghb_depth;
+  uint32_t theIndexMask;
 
 public:
   GHBPrefetcher(std::string statName, int32_t aNode)
-    : theName(statName)
+    : ghb_head(0)
+    , ghb_req_id(0)
+    , theName(statName)
     , theNodeId(aNode)
     , ghb_depth(4)
   {}
 
   void init(int32_t blockSize, int32_t ghbSize) {
+    DBG_Assert( ghbSize > 1 && (ghbSize & (ghbSize - 1)) == 0, ( << theName << ": GHB size must be a power of two" ) );
     theBlockSize = blockSize;
     theBlockOffsetMask = theBlockSize - 1;
     ghb_size = ghbSize;
     ghb_max_idx = ghb_size << 4;
-    theIndexTable.init(ghb_size, 1, 0);
-    ghb = new ghb_ent_t[ghb_size];
+    theIndexMask = ghb_size - 1;
+    theIndexTable.assign(ghb_size, ghb_it_ent_t());
+    ghb.assign(ghb_size, ghb_ent_t());
+    ghb_deltas.assign(ghb_size, 0);
+    ghb_head = 0;
   }
 
   void ghb_prefetch(int64_t req_id, const MemoryAddress addr) {
@@ -111,31 +122,30 @@ public:
   }
 
   void access(const MemoryAddress PC, const MemoryAddress addr) {
+    ghb_it_ent_t & it_ent = theIndexTable[PC & theIndexMask];
     int32_t ptr = -1;
-    IndexTableIter it_iter = theIndexTable.find(PC);
-    if (it_iter != theIndexTable.end()) {
-      ptr = it_iter->second.ptr;
+    if (it_ent.tag == PC) {
+      ptr = it_ent.ptr;
     } else {
-      if (theIndexTable.size() >= 1) {
-        theIndexTable.pop_front();
-      }
-      it_iter = theIndexTable.insert( std::make_pair(PC, ghb_it_ent_t()) ).first;
-      it_iter->second.tag = PC;
+      it_ent.tag = PC;
     }
-    it_iter->second.ptr = ghb_head;
-    ghb_ent_t * head_ent = &ghb[ghb_head%ghb_size];
+    it_ent.ptr = ghb_head;
+    ghb_ent_t & head_ent = ghb[ghb_head % ghb_size];
     MemoryAddress baddr = makeBlockAddress(addr);
-    head_ent->addr = baddr;
-    head_ent->prev = ptr;
+    head_ent.addr = baddr;
+    head_ent.prev = ptr;
     ghb_head = (ghb_head + 1) % ghb_max_idx;
 
-    int32_t ghb_deltas[ghb_size-1];
+    // collect this PC's deltas, newest first, until the chain ends or
+    // reaches an entry the ring has already overwritten
     int32_t dc = 0;
-    for (ptr = it_iter->second.ptr; unsigned(dc) < (ghb_size - 1); ptr = ghb[ptr%ghb_size].prev) {
-      int32_t prev_ptr = ghb[ptr%ghb_size].prev;
+    for (ptr = it_ent.ptr; unsigned(dc) < (ghb_size - 1); ptr = ghb[ptr % ghb_size].prev) {
+      int32_t prev_ptr = ghb[ptr % ghb_size].prev;
+      if (prev_ptr < 0) break;
       if (((ghb_head - 1 - prev_ptr + ghb_max_idx) % ghb_max_idx) > ghb_size) break;
-      ghb_deltas[dc++] = ghb[ptr%ghb_size].addr - ghb[prev_ptr%ghb_size].addr;
+      ghb_deltas[dc++] = ghb[ptr % ghb_size].addr - ghb[prev_ptr % ghb_size].addr;
     }
+    if (dc < 3) return;
 
     int32_t d0, d1;
     d0 = ghb_deltas[0];
@@ -37,19 +37,18 @@
 #ifndef SEQ_MAP__
 #define SEQ_MAP__
 
+#include <cstdint>
 #include <deque>
+#include <functional>
 #include <map>
+#include <vector>
 
-#include <boost/multi_index_container.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index/sequenced_index.hpp>
-#include <boost/multi_index/composite_key.hpp>
-#include <boost/multi_index/member.hpp>
-
-using namespace boost::multi_index;
-
-struct by_LRU {};
-struct by_index {};
+// Both containers below keep their entries in one flat slot pool.  An entry
+// never moves once it has been placed in a slot, so iterators (which name a
+// slot, not a node) stay valid across inserts and erases of other entries,
+// and a freed slot is reused by the next insert.  Recency is kept as 32-bit
+// prev/next slot links, so moving an entry to the MRU position is a relink
+// rather than a node relocation.
 
 template <class T_key, class T_val>
 struct MapEntry_T {
@@ -62,132 +61,508 @@ struct MapEntry_T {
 };
 
 template <class T_key, class T_val>
-class flexus_boost_seq_map {
+class flexus_seq_slots {
+public:
   typedef MapEntry_T<T_key, T_val> MapEntry;
 
-  typedef multi_index_container
-  < MapEntry
-  , indexed_by
-  < sequenced< tag<by_LRU> >
-  , ordered_unique
-  < tag<by_index>
-  , member<MapEntry, T_key, &MapEntry::first>
-  >
-  >
-  > MapTable;
-  typedef typename MapTable::template index<by_LRU>::type::iterator LruIter;
-  typedef typename MapTable::template index<by_index>::type::iterator IndexIter;
+  static const int32_t kNil = -1;
+
+  // one recency list; head is LRU, tail is MRU
+  struct SeqList {
+    int32_t theHead;
+    int32_t theTail;
+    uint32_t theCount;
+    SeqList()
+      : theHead(kNil)
+      , theTail(kNil)
+      , theCount(0)
+    {}
+  };
+
+private:
+  std::deque<MapEntry> theEntries;
+  std::vector<int32_t> thePrev;
+  std::vector<int32_t> theNext;
+  std::vector<uint8_t> theLive;
+  int32_t theFree;  // free slots are chained through theNext
 
-  MapTable theMap;
+public:
+  flexus_seq_slots()
+    : theFree(kNil)
+  {}
+
+  const MapEntry & entry(int32_t slot) const {
+    return theEntries[slot];
+  }
+
+  int32_t nextSeq(int32_t slot) const {
+    return theNext[slot];
+  }
+
+  int32_t nextLive(int32_t slot) const {
+    for (++slot; slot < static_cast<int32_t>(theLive.size()); ++slot) {
+      if (theLive[slot]) {
+        return slot;
+      }
+    }
+    return kNil;
+  }
+
+  int32_t allocate(const std::pair<T_key, T_val> & apair) {
+    int32_t slot = theFree;
+    if (slot != kNil) {
+      theFree = theNext[slot];
+      theEntries[slot] = MapEntry(apair);
+    } else {
+      slot = static_cast<int32_t>(theEntries.size());
+      theEntries.push_back(MapEntry(apair));
+      thePrev.push_back(kNil);
+      theNext.push_back(kNil);
+      theLive.push_back(0);
+    }
+    theLive[slot] = 1;
+    return slot;
+  }
+
+  void release(int32_t slot) {
+    theLive[slot] = 0;
+    theNext[slot] = theFree;
+    theFree = slot;
+  }
+
+  void link_back(SeqList & list, int32_t slot) {
+    thePrev[slot] = list.theTail;
+    theNext[slot] = kNil;
+    if (list.theTail != kNil) {
+      theNext[list.theTail] = slot;
+    } else {
+      list.theHead = slot;
+    }
+    list.theTail = slot;
+    list.theCount++;
+  }
+
+  void unlink(SeqList & list, int32_t slot) {
+    int32_t prev = thePrev[slot];
+    int32_t next = theNext[slot];
+    if (prev != kNil) {
+      theNext[prev] = next;
+    } else {
+      list.theHead = next;
+    }
+    if (next != kNil) {
+      thePrev[next] = prev;
+    } else {
+      list.theTail = prev;
+    }
+    list.theCount--;
+  }
+
+  void move_back(SeqList & list, int32_t slot) {
+    if (list.theTail != slot) {
+      unlink(list, slot);
+      link_back(list, slot);
+    }
+  }
+};
+
+template <class T_key, class T_val>
+const int32_t flexus_seq_slots<T_key, T_val>::kNil;
+
+// Walks a slot pool either in slot order (kSeq == false) or along the
+// recency links (kSeq == true).  End is the nil slot.
+template <class T_slots, bool kSeq>
+class flexus_seq_map_iterator {
+  const T_slots * theSlots;
+  int32_t theSlot;
 
 public:
-  typedef IndexIter iterator;
-  typedef LruIter seq_iter;
-  typedef typename MapTable::size_type size_type;
+  typedef typename T_slots::MapEntry value_type;
+
+  flexus_seq_map_iterator()
+    : theSlots(0)
+    , theSlot(T_slots::kNil)
+  {}
+  flexus_seq_map_iterator(const T_slots * slots, int32_t slot)
+    : theSlots(slots)
+    , theSlot(slot)
+  {}
+
+  int32_t slot() const {
+    return theSlot;
+  }
+
+  const value_type & operator*() const {
+    return theSlots->entry(theSlot);
+  }
+  const value_type * operator->() const {
+    return &theSlots->entry(theSlot);
+  }
+
+  flexus_seq_map_iterator & operator++() {
+    theSlot = (kSeq ? theSlots->nextSeq(theSlot) : theSlots->nextLive(theSlot));
+    return *this;
+  }
+  flexus_seq_map_iterator operator++(int) {
+    flexus_seq_map_iterator prev(*this);
+    ++(*this);
+    return prev;
+  }
+
+  bool operator==(const flexus_seq_map_iterator & other) const {
+    return theSlot == other.theSlot;
+  }
+  bool operator!=(const flexus_seq_map_iterator & other) const {
+    return theSlot != other.theSlot;
+  }
+};
+
+template <class T_key, class T_val, class T_hash = std::hash<T_key> >
+class flexus_boost_seq_map {
+  typedef flexus_seq_slots<T_key, T_val> Slots;
+  typedef typename Slots::SeqList SeqList;
+  static const int32_t kNil = Slots::kNil;
+  static const uint32_t kMinIndexBits = 3;
+
+  // Open-addressed key index.  theTag is the upper half of the mixed hash;
+  // its top bits are also the home bucket, so the table can be rebuilt and
+  // entries shifted on erase without rehashing keys.
+  struct IndexEntry {
+    int32_t theSlot;
+    uint32_t theTag;
+  };
+
+  Slots theSlots;
+  SeqList theSeq;
+  std::vector<IndexEntry> theIndex;
+  uint32_t theIndexBits;
+  T_hash theHash;
+
+  uint32_t makeTag(const T_key & key) const {
+    return static_cast<uint32_t>((static_cast<uint64_t>(theHash(key)) * 0x9E3779B97F4A7C15ULL) >> 32);
+  }
+  uint32_t home(uint32_t tag) const {
+    return tag >> (32 - theIndexBits);
+  }
+
+  int32_t findPos(const T_key & key) const {
+    if (theIndex.empty()) {
+      return kNil;
+    }
+    uint32_t tag = makeTag(key);
+    uint32_t mask = theIndex.size() - 1;
+    for (uint32_t pos = home(tag); ; pos = (pos + 1) & mask) {
+      const IndexEntry & ie = theIndex[pos];
+      if (ie.theSlot == kNil) {
+        return kNil;
+      }
+      if (ie.theTag == tag && theSlots.entry(ie.theSlot).first == key) {
+        return pos;
+      }
+    }
+  }
+
+  void place(uint32_t tag, int32_t slot) {
+    uint32_t mask = theIndex.size() - 1;
+    uint32_t pos = home(tag);
+    while (theIndex[pos].theSlot != kNil) {
+      pos = (pos + 1) & mask;
+    }
+    theIndex[pos].theSlot = slot;
+    theIndex[pos].theTag = tag;
+  }
+
+  void resizeIndex(uint32_t bits) {
+    std::vector<IndexEntry> old;
+    old.swap(theIndex);
+    IndexEntry empty = { kNil, 0 };
+    theIndex.assign(1U << bits, empty);
+    theIndexBits = bits;
+    for (uint32_t ii = 0; ii < old.size(); ii++) {
+      if (old[ii].theSlot != kNil) {
+        place(old[ii].theTag, old[ii].theSlot);
+      }
+    }
+  }
+
+  // backward-shift deletion keeps probe sequences free of tombstones
+  void removePos(uint32_t pos) {
+    uint32_t mask = theIndex.size() - 1;
+    uint32_t hole = pos;
+    for (uint32_t next = (hole + 1) & mask; theIndex[next].theSlot != kNil; next = (next + 1) & mask) {
+      if (((next - home(theIndex[next].theTag)) & mask) >= ((next - hole) & mask)) {
+        theIndex[hole] = theIndex[next];
+        hole = next;
+      }
+    }
+    theIndex[hole].theSlot = kNil;
+  }
+
+  void eraseSlot(int32_t slot) {
+    const T_key & key = theSlots.entry(slot).first;
+    removePos(findPos(key));
+    theSlots.unlink(theSeq, slot);
+    theSlots.release(slot);
+  }
+
+public:
+  typedef flexus_seq_map_iterator<Slots, false> iterator;
+  typedef flexus_seq_map_iterator<Slots, true> seq_iter;
+  typedef std::size_t size_type;
+
+  flexus_boost_seq_map()
+    : theIndexBits(0)
+  {}
+
+  // size the key index for n entries up front; the map still grows past n
+  void reserve(size_type n) {
+    uint32_t bits = kMinIndexBits;
+    while ((1ULL << bits) < 2 * n) {
+      bits++;
+    }
+    if (bits > theIndexBits) {
+      resizeIndex(bits);
+    }
+  }
 
-  iterator begin() {
-    return (theMap.template get<by_index>()).begin();
+  iterator begin() const {
+    return iterator(&theSlots, theSlots.nextLive(kNil));
   }
-  iterator end() {
-    return (theMap.template get<by_index>()).end();
+  iterator end() const {
+    return iterator(&theSlots, kNil);
   }
 
-  seq_iter beginSeq() {
-    return (theMap.template get<by_LRU>()).begin();
+  seq_iter beginSeq() const {
+    return seq_iter(&theSlots, theSeq.theHead);
   }
-  seq_iter endSeq() {
-    return (theMap.template get<by_LRU>()).end();
+  seq_iter endSeq() const {
+    return seq_iter(&theSlots, kNil);
   }
 
   size_type size() const {
-    return theMap.size();
+    return theSeq.theCount;
   }
 
   const T_val & front() const {
-    return (theMap.template get<by_LRU>()).front().second;
+    return theSlots.entry(theSeq.theHead).second;
   }
 
   const T_key & front_key() const {
-    return (theMap.template get<by_LRU>()).front().first;
+    return theSlots.entry(theSeq.theHead).first;
   }
 
   std::pair<iterator, bool> insert( const std::pair<T_key, T_val> & apair ) {
-    std::pair<LruIter, bool> inspair = (theMap.template get<by_LRU>()).push_back(apair);
-    IndexIter iter = theMap.template project<by_index>(inspair.first);
-    return std::make_pair(iter, inspair.second);
+    int32_t pos = findPos(apair.first);
+    if (pos != kNil) {
+      return std::make_pair(iterator(&theSlots, theIndex[pos].theSlot), false);
+    }
+    if (2 * (theSeq.theCount + 1) > theIndex.size()) {
+      resizeIndex(theIndex.empty() ? kMinIndexBits : theIndexBits + 1);
+    }
+    int32_t slot = theSlots.allocate(apair);
+    theSlots.link_back(theSeq, slot);
+    place(makeTag(apair.first), slot);
+    return std::make_pair(iterator(&theSlots, slot), true);
   }
 
   iterator find(const T_key & key) const {
-    return (theMap.template get<by_index>()).find(key);
+    int32_t pos = findPos(key);
+    return iterator(&theSlots, (pos == kNil ? kNil : theIndex[pos].theSlot));
   }
 
   seq_iter findSeq(const T_key & key) const {
-    return theMap.template project<by_LRU>( (theMap.template get<by_index>()).find(key) );
+    return seq_iter(&theSlots, find(key).slot());
   }
 
   void erase(iterator iter) {
-    (theMap.template get<by_index>()).erase(iter);
+    eraseSlot(iter.slot());
   }
 
   void eraseSeq(seq_iter iter) {
-    (theMap.template get<by_LRU>()).erase(iter);
+    eraseSlot(iter.slot());
   }
 
   void push_back( const std::pair<T_key, T_val> & apair ) {
-    (theMap.template get<by_LRU>()).push_back(apair);
+    insert(apair);
   }
 
   void pop_front() {
-    (theMap.template get<by_LRU>()).pop_front();
+    eraseSlot(theSeq.theHead);
   }
 
   void move_back(iterator const & iter) {
-    theMap.relocate( (theMap.template get<by_LRU>()).end(), theMap.template project<by_LRU>(iter) );
+    theSlots.move_back(theSeq, iter.slot());
   }
 
   unsigned dist_back(iterator const & iter) const {
-    LruIter pos = theMap.template project<by_LRU>(iter);
     unsigned dist = 0;
-    while (pos != (theMap.template get<by_LRU>()).end()) {
+    for (int32_t slot = iter.slot(); slot != kNil; slot = theSlots.nextSeq(slot)) {
       dist++;
-      pos++;
     }
     return dist;
   }
 };
 
+template <class T_key, class T_val, class T_hash>
+const int32_t flexus_boost_seq_map<T_key, T_val, T_hash>::kNil;
+template <class T_key, class T_val, class T_hash>
+const uint32_t flexus_boost_seq_map<T_key, T_val, T_hash>::kMinIndexBits;
+
+// Unordered map with an optional entry limit, for the bookkeeping tables
+// that would otherwise grow with the footprint of the workload.  Once the
+// limit is reached, inserting a new key evicts the entry that was least
+// recently inserted or touched.  Owners that keep state alongside an
+// entry set an eviction callback, which receives each victim after it has
+// left the map.
+template <class T_key, class T_val, class T_hash = std::hash<T_key> >
+class flexus_bounded_map {
+  typedef flexus_boost_seq_map<T_key, T_val, T_hash> MapTable;
+
+  MapTable theMap;
+  std::size_t theCapacity;  // 0 = unbounded
+  uint64_t theEvictions;
+  std::function<void (T_key const &, T_val &)> theEvictionCallback;
+
+public:
+  typedef typename MapTable::iterator iterator;
+  typedef typename MapTable::size_type size_type;
+  typedef std::function<void (T_key const &, T_val &)> eviction_callback;
+
+  flexus_bounded_map()
+    : theCapacity(0)
+    , theEvictions(0)
+  {}
+
+  void setCapacity(size_type capacity) {
+    theCapacity = capacity;
+    if (capacity > 0) {
+      theMap.reserve(capacity);
+    }
+  }
+
+  void reserve(size_type n) {
+    theMap.reserve(n);
+  }
+
+  size_type capacity() const {
+    return theCapacity;
+  }
+
+  void setEvictionCallback(eviction_callback aCallback) {
+    theEvictionCallback = aCallback;
+  }
+
+  uint64_t evictions() const {
+    return theEvictions;
+  }
+
+  iterator begin() const {
+    return theMap.begin();
+  }
+  iterator end() const {
+    return theMap.end();
+  }
+
+  size_type size() const {
+    return theMap.size();
+  }
+
+  iterator find(const T_key & key) const {
+    return theMap.find(key);
+  }
+
+  std::pair<iterator, bool> insert( const std::pair<T_key, T_val> & apair ) {
+    if (theCapacity > 0 && theMap.size() >= theCapacity && theMap.find(apair.first) == theMap.end()) {
+      std::pair<T_key, T_val> victim(theMap.front_key(), theMap.front());
+      theMap.pop_front();
+      theEvictions++;
+      if (theEvictionCallback) {
+        theEvictionCallback(victim.first, victim.second);
+      }
+    }
+    return theMap.insert(apair);
+  }
+
+  void erase(iterator iter) {
+    theMap.erase(iter);
+  }
+
+  // mark an entry as recently used so it ages out last
+  void touch(iterator const & iter) {
+    theMap.move_back(iter);
+  }
+};
+
 #define FLEXUS_BOOST_SET_ASSOC_STATS 0
 
+// Set-associative variant: each set owns assoc ways whose tags sit packed
+// next to each other, so a lookup scans one short contiguous run instead of
+// walking a tree.  A set never holds more than assoc entries; inserting into
+// a full set replaces its LRU way.
 template <class T_key, class T_val>
 class flexus_boost_set_assoc {
-  typedef flexus_boost_seq_map<T_key, T_val> MapTable;
-  typedef std::vector<MapTable> SetAssocTable;
-
-  SetAssocTable theTable;
-  T_key theCurrIndex;
+  typedef flexus_seq_slots<T_key, T_val> Slots;
+  typedef typename Slots::SeqList SeqList;
+  static const int32_t kNil = Slots::kNil;
+
+  Slots theSlots;
+  std::vector<T_key> theTags;     // sets * assoc, way-major within a set
+  std::vector<int32_t> theWays;   // slot holding each way, kNil if invalid
+  std::vector<SeqList> theSetSeq; // per-set recency
+  uint32_t theCurrIndex;
 #ifdef FLEXUS_BOOST_SET_ASSOC_STATS
   std::vector<int> theSetCounts;
 #endif
 
   T_key theIndexMask;
-  T_key theUsefulBottomMask;
   uint32_t theSets;
   uint32_t theAssoc;
-  uint32_t theUselessNextBits;
 
-  T_key makeIndex(const T_key key) {
-    return (key & theIndexMask);
+  uint32_t makeIndex(const T_key key) const {
+    return static_cast<uint32_t>(key & theIndexMask);
+  }
+
+  int32_t findWay(uint32_t set, const T_key & key) const {
+    uint32_t base = set * theAssoc;
+    for (uint32_t way = 0; way < theAssoc; way++) {
+      if (theWays[base + way] != kNil && theTags[base + way] == key) {
+        return base + way;
+      }
+    }
+    return kNil;
+  }
+
+  void eraseSlot(int32_t slot) {
+    uint32_t set = makeIndex(theSlots.entry(slot).first);
+    uint32_t base = set * theAssoc;
+    for (uint32_t way = 0; way < theAssoc; way++) {
+      if (theWays[base + way] == slot) {
+        theWays[base + way] = kNil;
+        break;
+      }
+    }
+    theSlots.unlink(theSetSeq[set], slot);
+    theSlots.release(slot);
   }
 
 public:
-  typedef typename MapTable::iterator iterator;
-  typedef typename MapTable::seq_iter seq_iter;
-  typedef typename MapTable::size_type size_type;
+  typedef flexus_seq_map_iterator<Slots, false> iterator;
+  typedef flexus_seq_map_iterator<Slots, true> seq_iter;
+  typedef std::size_t size_type;
+
+  flexus_boost_set_assoc()
+    : theCurrIndex(0)
+    , theIndexMask(0)
+    , theSets(0)
+    , theAssoc(0)
+  {}
 
   void init(uint32_t size, uint32_t assoc, uint32_t usefulBottomBits) {
     theSets = size / assoc;
     theAssoc = assoc;
-    theTable.resize(theSets);
+    theTags.assign(theSets * theAssoc, T_key());
+    theWays.assign(theSets * theAssoc, kNil);
+    theSetSeq.assign(theSets, SeqList());
     theCurrIndex = 0;
     theIndexMask = theSets - 1;
 #ifdef FLEXUS_BOOST_SET_ASSOC_STATS
@@ -203,38 +578,24 @@ public:
     return theAssoc;
   }
 
-  iterator end() {
-    return theTable[theCurrIndex].end();
+  iterator end() const {
+    return iterator(&theSlots, kNil);
   }
 
-  iterator index_begin() {
-    theCurrIndex = 0;
-    iterator iter = theTable[theCurrIndex].begin();
-    index_adv(iter);
-    return iter;
+  // index order walks the slot pool, which covers every set
+  iterator index_begin() const {
+    return iterator(&theSlots, theSlots.nextLive(kNil));
   }
-  void index_next(iterator & iter) {
+  void index_next(iterator & iter) const {
     ++iter;
-    index_adv(iter);
-  }
-  void index_adv(iterator & iter) {
-    while (iter == theTable[theCurrIndex].end()) {
-      // check if there is another set
-      if ( (theCurrIndex + 1) == makeIndex(theCurrIndex + 1) ) {
-        theCurrIndex++;
-        iter = theTable[theCurrIndex].begin();
-      } else {
-        break;
-      }
-    }
   }
-  iterator index_end() {
-    return theTable[theCurrIndex].end();
+  iterator index_end() const {
+    return end();
   }
 
   seq_iter seq_begin() {
     theCurrIndex = 0;
-    seq_iter iter = theTable[theCurrIndex].beginSeq();
+    seq_iter iter = seq_iter(&theSlots, (theSets > 0 ? theSetSeq[0].theHead : kNil));
     seq_adv(iter);
     return iter;
   }
@@ -243,30 +604,25 @@ public:
     seq_adv(iter);
   }
   void seq_adv(seq_iter & iter) {
-    while (iter == theTable[theCurrIndex].endSeq()) {
-      // check if there is another set
-      if ( (theCurrIndex + 1) == makeIndex(theCurrIndex + 1) ) {
-        theCurrIndex++;
-        iter = theTable[theCurrIndex].beginSeq();
-      } else {
-        break;
-      }
+    while (iter == seq_end() && (theCurrIndex + 1) < theSets) {
+      theCurrIndex++;
+      iter = seq_iter(&theSlots, theSetSeq[theCurrIndex].theHead);
     }
   }
-  seq_iter seq_end() {
-    return theTable[theCurrIndex].endSeq();
+  seq_iter seq_end() const {
+    return seq_iter(&theSlots, kNil);
   }
 
   size_type size() const {
-    return theTable[theCurrIndex].size();
+    return theSetSeq[theCurrIndex].theCount;
   }
 
   const T_val & front() const {
-    return theTable[theCurrIndex].front();
+    return theSlots.entry(theSetSeq[theCurrIndex].theHead).second;
   }
 
   const T_key & front_key() const {
-    return theTable[theCurrIndex].front_key();
+    return theSlots.entry(theSetSeq[theCurrIndex].theHead).first;
   }
 
   std::pair<iterator, bool> insert( const std::pair<T_key, T_val> & apair ) {
@@ -274,32 +630,43 @@ public:
 #ifdef FLEXUS_BOOST_SET_ASSOC_STATS
     theSetCounts[theCurrIndex]++;
 #endif
-    return theTable[theCurrIndex].insert(apair);
+    int32_t way = findWay(theCurrIndex, apair.first);
+    if (way != kNil) {
+      return std::make_pair(iterator(&theSlots, theWays[way]), false);
+    }
+    SeqList & seq = theSetSeq[theCurrIndex];
+    if (seq.theCount >= theAssoc) {
+      eraseSlot(seq.theHead);
+    }
+    uint32_t base = theCurrIndex * theAssoc;
+    for (way = base; theWays[way] != kNil; way++) { }
+    int32_t slot = theSlots.allocate(apair);
+    theSlots.link_back(seq, slot);
+    theTags[way] = apair.first;
+    theWays[way] = slot;
+    return std::make_pair(iterator(&theSlots, slot), true);
   }
 
   iterator find(const T_key & key) {
     theCurrIndex = makeIndex(key);
-    return theTable[theCurrIndex].find(key);
+    int32_t way = findWay(theCurrIndex, key);
+    return iterator(&theSlots, (way == kNil ? kNil : theWays[way]));
   }
 
   void erase(iterator iter) {
-    theTable[theCurrIndex].erase(iter);
+    eraseSlot(iter.slot());
   }
 
   void push_back( const std::pair<T_key, T_val> & apair ) {
-    theCurrIndex = makeIndex(apair.first);
-#ifdef FLEXUS_BOOST_SET_ASSOC_STATS
-    theSetCounts[theCurrIndex]++;
-#endif
-    theTable[theCurrIndex].push_back(apair);
+    insert(apair);
   }
 
   void pop_front() {
-    theTable[theCurrIndex].pop_front();
+    eraseSlot(theSetSeq[theCurrIndex].theHead);
   }
 
   void move_back(iterator const & iter) {
-    theTable[theCurrIndex].move_back(iter);
+    theSlots.move_back(theSetSeq[makeIndex(iter->first)], iter.slot());
   }
 
 #ifdef FLEXUS_BOOST_SET_ASSOC_STATS
@@ -309,4 +676,7 @@ public:
 #endif
 };
 
+template <class T_key, class T_val>
+const int32_t flexus_boost_set_assoc<T_key, T_val>::kNil;
+
 #endif
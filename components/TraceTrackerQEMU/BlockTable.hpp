@@ -0,0 +1,165 @@
+// DO-NOT-REMOVE begin-copyright-block 
+//QFlex consists of several software components that are governed by various
+//licensing terms, in addition to software that was developed internally.
+//Anyone interested in using QFlex needs to fully understand and abide by the
+//licenses governing all the software components.
+//
+//### Software developed externally (not by the QFlex group)
+//
+//    * [NS-3](https://www.gnu.org/copyleft/gpl.html)
+//    * [QEMU](http://wiki.qemu.org/License) 
+//    * [SimFlex] (http://parsa.epfl.ch/simflex/)
+//
+//Software developed internally (by the QFlex group)
+//**QFlex License**
+//
+//QFlex
+//Copyright (c) 2016, Parallel Systems Architecture Lab, EPFL
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//    * Neither the name of the Parallel Systems Architecture Laboratory, EPFL,
+//      nor the names of its contributors may be used to endorse or promote
+//      products derived from this software without specific prior written
+//      permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE PARALLEL SYSTEMS ARCHITECTURE LABORATORY,
+//EPFL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+//GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+//LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+//THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// DO-NOT-REMOVE end-copyright-block   
+#ifndef _BLOCK_TABLE_HPP_
+#define _BLOCK_TABLE_HPP_
+
+#include <vector>
+#include <boost/optional.hpp>
+
+#include <components/CommonQEMU/TraceTracker.hpp>
+
+namespace nTraceTracker {
+
+// Open-addressed table of per-block records keyed by the full 64-bit block
+// address.  Records live inline in the slot array; linear probing with
+// backward-shift deletion keeps probe runs short without tombstones.
+// Pointers returned by find() and insert() are invalidated by the next
+// insert() or erase().
+template <class T>
+class BlockTable {
+  static const address_t kEmpty = ~0ULL;
+
+  struct Slot {
+    address_t theBlock;
+    boost::optional<T> theRecord;
+    Slot()
+      : theBlock(kEmpty)
+    {}
+  };
+
+  std::vector<Slot> theSlots;
+  uint32_t theBits;
+  uint32_t theSize;
+
+  uint32_t home(address_t aBlock) const {
+    return static_cast<uint32_t>((aBlock * 0x9E3779B97F4A7C15ULL) >> (64 - theBits));
+  }
+
+  int64_t slotOf(address_t aBlock) const {
+    uint32_t mask = theSlots.size() - 1;
+    for (uint32_t i = home(aBlock); ; i = (i + 1) & mask) {
+      if (theSlots[i].theBlock == aBlock) {
+        return i;
+      }
+      if (theSlots[i].theBlock == kEmpty) {
+        return -1;
+      }
+    }
+  }
+
+  uint32_t freeSlot(address_t aBlock) const {
+    uint32_t mask = theSlots.size() - 1;
+    uint32_t i = home(aBlock);
+    while (theSlots[i].theBlock != kEmpty) {
+      i = (i + 1) & mask;
+    }
+    return i;
+  }
+
+  void grow() {
+    std::vector<Slot> old(theSlots.size() * 2);
+    old.swap(theSlots);
+    ++theBits;
+    for (Slot & slot : old) {
+      if (slot.theBlock != kEmpty) {
+        Slot & dest = theSlots[freeSlot(slot.theBlock)];
+        dest.theBlock = slot.theBlock;
+        dest.theRecord = std::move(slot.theRecord);
+      }
+    }
+  }
+
+public:
+  BlockTable()
+    : theSlots(1024)
+    , theBits(10)
+    , theSize(0)
+  {}
+
+  uint32_t size() const {
+    return theSize;
+  }
+
+  T * find(address_t aBlock) {
+    int64_t slot = slotOf(aBlock);
+    return (slot < 0) ? 0 : &*theSlots[slot].theRecord;
+  }
+
+  T & insert(address_t aBlock, T const & aRecord) {
+    DBG_Assert(aBlock != kEmpty);
+    DBG_Assert(slotOf(aBlock) < 0, ( << "block 0x" << std::hex << aBlock << " already tracked" ) );
+    if (2 * (theSize + 1) > theSlots.size()) {
+      grow();
+    }
+    Slot & slot = theSlots[freeSlot(aBlock)];
+    slot.theBlock = aBlock;
+    slot.theRecord = aRecord;
+    ++theSize;
+    return *slot.theRecord;
+  }
+
+  bool erase(address_t aBlock) {
+    int64_t slot = slotOf(aBlock);
+    if (slot < 0) {
+      return false;
+    }
+    uint32_t mask = theSlots.size() - 1;
+    uint32_t hole = slot;
+    for (uint32_t i = (hole + 1) & mask; theSlots[i].theBlock != kEmpty; i = (i + 1) & mask) {
+      if (((i - home(theSlots[i].theBlock)) & mask) >= ((i - hole) & mask)) {
+        theSlots[hole].theBlock = theSlots[i].theBlock;
+        theSlots[hole].theRecord = std::move(theSlots[i].theRecord);
+        hole = i;
+      }
+    }
+    theSlots[hole].theBlock = kEmpty;
+    theSlots[hole].theRecord = boost::none;
+    --theSize;
+    return true;
+  }
+};
+
+} // namespace nTraceTracker
+
+#endif
@@ -44,7 +44,7 @@
 #ifndef _OFFCHIP_TRACKER_HPP_
 #define _OFFCHIP_TRACKER_HPP_
 
-#include <unordered_map>
+#include <components/TraceTrackerQEMU/BlockTable.hpp>
 #include <boost/dynamic_bitset.hpp>
 
 using namespace Flexus;
@@ -346,8 +346,7 @@ private:
   }
 };
 
-typedef std::unordered_map<address_t, PrefetchEntry> PrefetchMap;
-typedef PrefetchMap::iterator PrefetchMapIter;
+typedef BlockTable<PrefetchEntry> PrefetchMap;
 
 struct PrefetchTracker {
   std::string theName;
@@ -359,16 +358,16 @@ struct PrefetchTracker {
     , theStats(theName)
   {}
   void fill(address_t block, SharedTypes::tFillLevel cache, bool isWrite) {
-    PrefetchMapIter iter = theCurrentPrefetches.find(block);
-    if (iter != theCurrentPrefetches.end()) {
+    PrefetchEntry * entry = theCurrentPrefetches.find(block);
+    if (entry) {
       switch (cache) {
         case SharedTypes::eL1:
-          iter->second.fillL1(false);
+          entry->fillL1(false);
           break;
         case SharedTypes::eL2:
           // this should only happen on a missWritableReply after a write hit
           // to a prefetched block
-          iter->second.fillL2(false);
+          entry->fillL2(false);
           break;
         default:
           DBG_Assert(false, ( << "cache = " << cache ) );
@@ -380,10 +379,10 @@ struct PrefetchTracker {
           // the fill will have already been marked as wrong-path, so ignore the fill here
           break;
         case SharedTypes::eL2:
-          theCurrentPrefetches.insert( std::make_pair(block, PrefetchEntry(false, false, isWrite, &theStats)) );
+          theCurrentPrefetches.insert(block, PrefetchEntry(false, false, isWrite, &theStats));
           break;
         case SharedTypes::ePrefetchBuffer:
-          theCurrentPrefetches.insert( std::make_pair(block, PrefetchEntry(true, true, false, &theStats)) );
+          theCurrentPrefetches.insert(block, PrefetchEntry(true, true, false, &theStats));
           break;
         default:
           DBG_Assert(false, ( << "cache = " << cache ) );
@@ -391,11 +390,11 @@ struct PrefetchTracker {
     }
   }
   void prefetchFill(address_t block, SharedTypes::tFillLevel cache) {
-    PrefetchMapIter iter = theCurrentPrefetches.find(block);
-    if (iter != theCurrentPrefetches.end()) {
+    PrefetchEntry * entry = theCurrentPrefetches.find(block);
+    if (entry) {
       switch (cache) {
         case SharedTypes::eL1:
-          iter->second.fillL1(true);
+          entry->fillL1(true);
           break;
         default:
           DBG_Assert(false, ( << "cache = " << cache ) );
@@ -407,7 +406,7 @@ struct PrefetchTracker {
           // the fill will have already been marked as wrong-path, so ignore the fill here
           break;
         case SharedTypes::eL2:
-          theCurrentPrefetches.insert( std::make_pair(block, PrefetchEntry(true, false, false, &theStats)) );
+          theCurrentPrefetches.insert(block, PrefetchEntry(true, false, false, &theStats));
           break;
         default:
           DBG_Assert(false, ( << "cache = " << cache ) );
@@ -415,25 +414,25 @@ struct PrefetchTracker {
     }
   }
   void insert(address_t block, SharedTypes::tFillLevel cache) {
-    PrefetchMapIter iter = theCurrentPrefetches.find(block);
-    if (iter != theCurrentPrefetches.end()) {
+    PrefetchEntry * entry = theCurrentPrefetches.find(block);
+    if (entry) {
       DBG_Assert(cache == SharedTypes::eL2);
-      iter->second.insertL2();
+      entry->insertL2();
     }
   }
   void evict(address_t block, SharedTypes::tFillLevel cache) {
-    PrefetchMapIter iter = theCurrentPrefetches.find(block);
-    if (iter != theCurrentPrefetches.end()) {
+    PrefetchEntry * entry = theCurrentPrefetches.find(block);
+    if (entry) {
       bool remove = false;
       switch (cache) {
         case SharedTypes::eL1:
-          remove = iter->second.evictL1();
+          remove = entry->evictL1();
           break;
         case SharedTypes::eL2:
-          remove = iter->second.evictL2();
+          remove = entry->evictL2();
           break;
         case SharedTypes::ePrefetchBuffer:
-          remove = iter->second.evictPB();
+          remove = entry->evictPB();
           break;
         case SharedTypes::eCore:
           // ignore "core" duplicate L1 cache simulation
@@ -442,23 +441,23 @@ struct PrefetchTracker {
           DBG_Assert(false, ( << "cache = " << cache ) );
       }
       if (remove) {
-        theCurrentPrefetches.erase(iter);
+        theCurrentPrefetches.erase(block);
       }
     }
   }
   void inval(address_t block, SharedTypes::tFillLevel cache) {
-    PrefetchMapIter iter = theCurrentPrefetches.find(block);
-    if (iter != theCurrentPrefetches.end()) {
+    PrefetchEntry * entry = theCurrentPrefetches.find(block);
+    if (entry) {
       bool remove = false;
       switch (cache) {
         case SharedTypes::eL1:
-          remove = iter->second.invalL1();
+          remove = entry->invalL1();
           break;
         case SharedTypes::eL2:
-          remove = iter->second.invalL2();
+          remove = entry->invalL2();
           break;
         case SharedTypes::ePrefetchBuffer:
-          remove = iter->second.invalPB();
+          remove = entry->invalPB();
           break;
         case SharedTypes::eCore:
           // ignore "core" duplicate L1 cache simulation
@@ -467,36 +466,36 @@ struct PrefetchTracker {
           DBG_Assert(false, ( << "cache = " << cache ) );
       }
       if (remove) {
-        theCurrentPrefetches.erase(iter);
+        theCurrentPrefetches.erase(block);
       }
     }
   }
   bool store(address_t block) {
     bool offchip = false;
-    PrefetchMapIter iter = theCurrentPrefetches.find(block);
-    if (iter != theCurrentPrefetches.end()) {
-      offchip = iter->second.nonSpecAccess(true);
+    PrefetchEntry * entry = theCurrentPrefetches.find(block);
+    if (entry) {
+      offchip = entry->nonSpecAccess(true);
     }
     return offchip;
   }
   bool commit(address_t block) {
     bool offchip = false;
-    PrefetchMapIter iter = theCurrentPrefetches.find(block);
-    if (iter != theCurrentPrefetches.end()) {
-      offchip = iter->second.nonSpecAccess(false);
+    PrefetchEntry * entry = theCurrentPrefetches.find(block);
+    if (entry) {
+      offchip = entry->nonSpecAccess(false);
     }
     return offchip;
   }
   void hit(address_t block, bool isWrite) {
-    PrefetchMapIter iter = theCurrentPrefetches.find(block);
-    if (iter != theCurrentPrefetches.end()) {
-      iter->second.prefetchHit(isWrite);
+    PrefetchEntry * entry = theCurrentPrefetches.find(block);
+    if (entry) {
+      entry->prefetchHit(isWrite);
     }
   }
   void redundant(address_t block) {
-    PrefetchMapIter iter = theCurrentPrefetches.find(block);
-    if (iter != theCurrentPrefetches.end()) {
-      iter->second.redundant();
+    PrefetchEntry * entry = theCurrentPrefetches.find(block);
+    if (entry) {
+      entry->redundant();
     }
   }
 };
@@ -763,8 +762,7 @@ struct SgpTrackEntry {
   }
 };
 
-typedef std::unordered_map<address_t, SgpTrackEntry> SgpTrackMap;
-typedef SgpTrackMap::iterator SgpTrackIter;
+typedef BlockTable<SgpTrackEntry> SgpTrackMap;
 
 class SgpTracker {
   std::string theName;
@@ -778,43 +776,43 @@ public:
   SgpTracker(std::string aName, int32_t blockSize, int32_t sgpBlocks)
     : theName(aName)
     , theSgpBlocks(sgpBlocks)
-    , theGroupMask(~(blockSize * sgpBlocks - 1))
+    , theGroupMask(~(static_cast<address_t>(blockSize) * sgpBlocks - 1))
     , theOffsetShift((int)log2(blockSize))
     , theStats(aName)
   {}
   void offchipMiss(address_t block, bool isWrite) {
     address_t group = makeGroup(block);
     int32_t offset = makeOffset(block);
-    SgpTrackIter iter = theGroups.find(group);
-    if (iter != theGroups.end()) {
-      iter->second.offchipMiss(offset);
+    SgpTrackEntry * entry = theGroups.find(group);
+    if (entry) {
+      entry->offchipMiss(offset);
     } else {
-      theGroups.insert( std::make_pair(group, SgpTrackEntry(theSgpBlocks, offset, false)) );
+      theGroups.insert(group, SgpTrackEntry(theSgpBlocks, offset, false));
     }
   }
   void sgpPredict(address_t group, void * aPredictSet) {
     SGvector * vec = (SGvector *)aPredictSet;
-    SgpTrackIter iter = theGroups.find(group);
-    if (iter != theGroups.end()) {
-      iter->second.sgpPredict(*vec);
+    SgpTrackEntry * entry = theGroups.find(group);
+    if (entry) {
+      entry->sgpPredict(*vec);
     } else {
-      theGroups.insert( std::make_pair(group, SgpTrackEntry(theSgpBlocks, *vec)) );
+      theGroups.insert(group, SgpTrackEntry(theSgpBlocks, *vec));
     }
   }
   void sgpHit(address_t block, bool isWrite) {
     address_t group = makeGroup(block);
     int32_t offset = makeOffset(block);
-    SgpTrackIter iter = theGroups.find(group);
-    if (iter != theGroups.end()) {
-      iter->second.sgpHit(offset);
+    SgpTrackEntry * entry = theGroups.find(group);
+    if (entry) {
+      entry->sgpHit(offset);
     } else {
-      theGroups.insert( std::make_pair(group, SgpTrackEntry(theSgpBlocks, offset, true)) );
+      theGroups.insert(group, SgpTrackEntry(theSgpBlocks, offset, true));
     }
   }
   void parallelList(address_t block, std::set<uint64_t> & list) {
     address_t group = makeGroup(block);
-    SgpTrackIter iter = theGroups.find(group);
-    if (iter != theGroups.end()) {
+    SgpTrackEntry * entry = theGroups.find(group);
+    if (entry) {
       SGvector parallel(theSgpBlocks);
       std::set<uint64_t>::iterator setIter = list.begin();
       for (; setIter != list.end(); ++setIter) {
@@ -829,7 +827,7 @@ public:
       //disp = true;
       //DBG_(Dev, ( << "Parallel list for group 0x" << std::hex << group ) );
       //}
-      iter->second.addParallel(offset, parallel, disp);
+      entry->addParallel(offset, parallel, disp);
     }
   }
   void endGen(address_t block) {
@@ -839,10 +837,10 @@ public:
     //disp = true;
     //DBG_(Dev, ( << "End Gen for group 0x" << std::hex << group ) );
     //}
-    SgpTrackIter iter = theGroups.find(group);
-    if (iter != theGroups.end()) {
-      iter->second.endGen(theStats, disp);
-      theGroups.erase(iter);
+    SgpTrackEntry * entry = theGroups.find(group);
+    if (entry) {
+      entry->endGen(theStats, disp);
+      theGroups.erase(group);
     }
   }
 private:
@@ -852,14 +850,6 @@ private:
   int32_t makeOffset(address_t addr) {
     return ((addr & ~theGroupMask) >> theOffsetShift);
   }
-  /*
-  address_t makeGroup(uint64_t addr) {
-    return (addr & (uint64_t)theGroupMask);
-  }
-  int32_t makeOffset(address_t addr) {
-    return ((addr & ~(uint64_t)theGroupMask) >> theOffsetShift);
-  }
-  */
 };
 
 } // namespace nTraceTracker
@@ -59,7 +59,7 @@ extern "C" {
 }
 }
 
-#include <unordered_map>
+#include <components/TraceTrackerQEMU/BlockTable.hpp>
 
 using namespace Flexus;
 using namespace Core;
@@ -229,13 +229,6 @@ public:
   }
 };
 
-struct IntHash {
-  std::size_t operator()(uint32_t key) const {
-    key = key >> 6;
-    return key;
-  }
-};
-
 class SharingTracker {
   int32_t theNumNodes;
   int32_t theNumChunks;
@@ -243,7 +236,7 @@ class SharingTracker {
   Qemu::API::conf_object_t * theCPU;
   uint64_t * theCurrValue;
 
-  typedef std::unordered_map<address_t, SharingInfo, IntHash> SharingMap;
+  typedef BlockTable<SharingInfo> SharingMap;
   std::vector<SharingMap> theInvalidTags;
 
   Stat::StatCounter statFalseSharing;
@@ -292,12 +285,12 @@ public:
     if (block == 0xd170080/*FS*/ || block == 0x1da87240/*SS*/)
       DBG_(MyLevel, ( << "[" << aNode << "] accessLoad 0x" << std::hex << block << "," << offset));
 
-    SharingMap::iterator iter = theInvalidTags[aNode].find(block);
-    if (iter != theInvalidTags[aNode].end()) {
-      if (iter->second.firstAccessAfterInval()) {
-        iter->second.setValueDiff( calcValueDiff(block, iter->second.getValueAtInval()) );
+    SharingInfo * info = theInvalidTags[aNode].find(block);
+    if (info) {
+      if (info->firstAccessAfterInval()) {
+        info->setValueDiff( calcValueDiff(block, info->getValueAtInval()) );
       }
-      iter->second.accessed(offset, size);
+      info->accessed(offset, size);
     }
   }
 
@@ -307,14 +300,14 @@ public:
 
     int32_t ii;
     for (ii = 0; ii < theNumNodes; ii++) {
-      SharingMap::iterator iter = theInvalidTags[ii].find(block);
-      if (iter != theInvalidTags[ii].end()) {
+      SharingInfo * info = theInvalidTags[ii].find(block);
+      if (info) {
         if (ii == aNode) {
-          if (iter->second.firstAccessAfterInval()) {
-            iter->second.setValueDiff( calcValueDiff(block, iter->second.getValueAtInval()) );
+          if (info->firstAccessAfterInval()) {
+            info->setValueDiff( calcValueDiff(block, info->getValueAtInval()) );
           }
         }
-        iter->second.updated(offset, size, (ii != aNode));
+        info->updated(offset, size, (ii != aNode));
       }
     }
   }
@@ -331,11 +324,11 @@ public:
     if (block == 0xd170080/*FS*/ || block == 0x1da87240/*SS*/)
       DBG_(MyLevel, ( << "[" << aNode << ":" << aCacheLevel << "] fill 0x" << std::hex << block));
 
-    SharingMap::iterator iter = theInvalidTags[aNode].find(block);
-    if (iter != theInvalidTags[aNode].end()) {
-      iter->second.dataIn(aCacheLevel);
+    SharingInfo * info = theInvalidTags[aNode].find(block);
+    if (info) {
+      info->dataIn(aCacheLevel);
       if (aCacheLevel == 2) {
-        iter->second.setFilledAfterInval();
+        info->setFilledAfterInval();
       }
     }
   }
@@ -344,10 +337,10 @@ public:
     if (block == 0xd170080/*FS*/ || block == 0x1da87240/*SS*/)
       DBG_(MyLevel, ( << "[" << aNode << ":" << aCacheLevel << "] insert 0x" << std::hex << block));
 
-    SharingMap::iterator iter = theInvalidTags[aNode].find(block);
-    if (iter != theInvalidTags[aNode].end()) {
-      iter->second.dataIn(aCacheLevel);
-      DBG_Assert(iter->second.filledAfterInval());
+    SharingInfo * info = theInvalidTags[aNode].find(block);
+    if (info) {
+      info->dataIn(aCacheLevel);
+      DBG_Assert(info->filledAfterInval());
     }
   }
 
@@ -355,15 +348,16 @@ public:
     if (block == 0xd170080/*FS*/ || block == 0x1da87240/*SS*/)
       DBG_(MyLevel, ( << "[" << aNode << ":" << aCacheLevel << "] evict 0x" << std::hex << block ));
 
-    SharingMap::iterator iter = theInvalidTags[aNode].find(block);
-    if (iter != theInvalidTags[aNode].end()) {
-      iter->second.dataOut(aCacheLevel);
-      if (!iter->second.pendingInv()) {
-        if (!iter->second.dataPresent()) {
+    SharingInfo * info = theInvalidTags[aNode].find(block);
+    if (info) {
+      info->dataOut(aCacheLevel);
+      if (!info->pendingInv()) {
+        if (!info->dataPresent()) {
           if (drop || aCacheLevel == 2) {
-            doStats(iter->second, block);
-            DBG_Assert(!iter->second.pendingInvTag(), ( << "[" << aNode << "]: 0x" << std::hex << block ) );
-            theInvalidTags[aNode].erase(freeSharing(iter));
+            doStats(*info, block);
+            DBG_Assert(!info->pendingInvTag(), ( << "[" << aNode << "]: 0x" << std::hex << block ) );
+            freeSharing(*info);
+            theInvalidTags[aNode].erase(block);
           }
         }
       }
@@ -374,12 +368,12 @@ public:
     if (block == 0xd170080/*FS*/ || block == 0x1da87240/*SS*/)
       DBG_(MyLevel, ( << "[" << aNode << ":" << aCacheLevel << "] invalidate 0x" << std::hex << block ));
 
-    SharingMap::iterator iter = theInvalidTags[aNode].find(block);
-    if (iter != theInvalidTags[aNode].end()) {
-      iter->second.dataOut(aCacheLevel);
+    SharingInfo * info = theInvalidTags[aNode].find(block);
+    if (info) {
+      info->dataOut(aCacheLevel);
       if (aCacheLevel == 2) {
-        DBG_Assert(!iter->second.pendingInv());
-        iter->second.setPendingInv();
+        DBG_Assert(!info->pendingInv());
+        info->setPendingInv();
       }
     }
   }
@@ -388,17 +382,18 @@ public:
     if (block == 0xd170080/*FS*/ || block == 0x1da87240/*SS*/)
       DBG_(MyLevel, ( << "[" << aNode << "] invalidAck 0x" << std::hex << block ));
 
-    SharingMap::iterator iter = theInvalidTags[aNode].find(block);
-    if (iter != theInvalidTags[aNode].end()) {
-      DBG_Assert(iter->second.pendingInv(), ( << "[" << aNode << "]: 0x" << std::hex << block ) );
-      DBG_Assert(!iter->second.dataPresent(),  ( << "[" << aNode << "]: 0x" << std::hex << block ) );
-      if (iter->second.filledAfterInval()) {
-        doStats(iter->second, block);
+    SharingInfo * info = theInvalidTags[aNode].find(block);
+    if (info) {
+      DBG_Assert(info->pendingInv(), ( << "[" << aNode << "]: 0x" << std::hex << block ) );
+      DBG_Assert(!info->dataPresent(),  ( << "[" << aNode << "]: 0x" << std::hex << block ) );
+      if (info->filledAfterInval()) {
+        doStats(*info, block);
       }
-      if (iter->second.pendingInvTag()) {
-        iter->second.reset( readBlockValue(block) );
+      if (info->pendingInvTag()) {
+        info->reset( readBlockValue(block) );
       } else {
-        theInvalidTags[aNode].erase(freeSharing(iter));
+        freeSharing(*info);
+        theInvalidTags[aNode].erase(block);
       }
     }
   }
@@ -407,11 +402,11 @@ public:
     if (block == 0xd170080/*FS*/ || block == 0x1da87240/*SS*/)
       DBG_(MyLevel, ( << "[" << aNode << "] tagCreate 0x" << std::hex << block ));
 
-    SharingMap::iterator iter = theInvalidTags[aNode].find(block);
-    if (iter != theInvalidTags[aNode].end()) {
-      iter->second.setPendingInvTag();
+    SharingInfo * info = theInvalidTags[aNode].find(block);
+    if (info) {
+      info->setPendingInvTag();
     } else {
-      theInvalidTags[aNode].insert( std::make_pair(block, SharingInfo()) );
+      theInvalidTags[aNode].insert(block, SharingInfo());
     }
   }
 
@@ -424,17 +419,18 @@ public:
     if (block == 0xd170080/*FS*/ || block == 0x1da87240/*SS*/)
       DBG_(MyLevel, ( << "[" << aNode << "] tagReplace 0x" << std::hex << block ));
 
-    SharingMap::iterator iter = theInvalidTags[aNode].find(block);
-    if (iter != theInvalidTags[aNode].end()) {
-      if (!iter->second.pendingInv()) {
-        if (iter->second.dataPresent()) {
-          DBG_Assert(iter->second.filledAfterInval(), ( << "[" << aNode << "]: 0x" << std::hex << block ) );
+    SharingInfo * info = theInvalidTags[aNode].find(block);
+    if (info) {
+      if (!info->pendingInv()) {
+        if (info->dataPresent()) {
+          DBG_Assert(info->filledAfterInval(), ( << "[" << aNode << "]: 0x" << std::hex << block ) );
           statInvTagReplaceData++;
         } else {
-          DBG_Assert(!iter->second.filledAfterInval(), ( << "[" << aNode << "]: 0x" << std::hex << block ) );
-          DBG_Assert(iter->second.noAccesses(), ( << "[" << aNode << "]: 0x" << std::hex << block ) );
+          DBG_Assert(!info->filledAfterInval(), ( << "[" << aNode << "]: 0x" << std::hex << block ) );
+          DBG_Assert(info->noAccesses(), ( << "[" << aNode << "]: 0x" << std::hex << block ) );
           statInvTagReplaceNoData++;
-          theInvalidTags[aNode].erase(freeSharing(iter));
+          freeSharing(*info);
+          theInvalidTags[aNode].erase(block);
         }
       }
       statInvTagReplace++;
@@ -472,12 +468,11 @@ private:
     return valueDiff;
   }
 
-  SharingMap::iterator & freeSharing(SharingMap::iterator & iter) {
-    uint64_t * array = iter->second.getValueAtInval();
+  void freeSharing(SharingInfo & info) {
+    uint64_t * array = info.getValueAtInval();
     if (array) {
       theBlockValuePool.free(array);
     }
-    return iter;
   }
 
   void doStats(SharingInfo & data, address_t block) {
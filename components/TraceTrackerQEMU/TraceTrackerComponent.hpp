@@ -52,6 +52,8 @@ COMPONENT_PARAMETERS(
   PARAMETER(Enable, bool, "Enable Trace Tracker", "enable", false )
   PARAMETER(NumNodes, int, "Number of nodes", "num-nodes", 16)
   PARAMETER(BlockSize, long, "Cache block size", "bsize", 64 )
+  PARAMETER(EventLog, std::string, "Binary event log file (empty to disable)", "event-log", "" )
+  PARAMETER(EventLogBuffer, int, "Events buffered before handing off to the log writer", "event-log-buffer", 65536 )
 );
 
 COMPONENT_EMPTY_INTERFACE ;
@@ -72,6 +72,9 @@ public:
   }
 
   void initialize() {
+    if (! cfg.EventLog.empty()) {
+      theTraceTracker.openEventLog(cfg.EventLog, cfg.EventLogBuffer);
+    }
     theTraceTracker.initialize();
   }
 
@@ -79,6 +82,24 @@ public:
     theTraceTracker.finalize();
   }
 
+  bool isReconfigurable(std::string const & aSwitch) const {
+    return aSwitch == "event-log" || aSwitch == "event-log-buffer";
+  }
+
+  //The log writer is a thread, which would not survive a fork
+  void prepareFork() {
+    theTraceTracker.closeEventLog();
+  }
+
+  //Sweep copies run in their own directory, so each reopens the log there
+  //under the same file name
+  void reconfigure() {
+    if (! cfg.EventLog.empty()) {
+      std::string::size_type slash = cfg.EventLog.rfind('/');
+      theTraceTracker.openEventLog( slash == std::string::npos ? cfg.EventLog : cfg.EventLog.substr(slash + 1), cfg.EventLogBuffer);
+    }
+  }
+
 };
 
 } // end namespace nTraceTrackerComponent
@@ -59,6 +59,7 @@ COMPONENT_PARAMETERS(
   PARAMETER( SendAcks, bool, "Send acknowledgements when we received data", "send_acks", false )
   PARAMETER( UseReplyChannel, bool, "Send replies on Reply Channel and only Evicts on Snoop Channel", "use_reply_channel", false )
   PARAMETER( EvictOnSnoop, bool, "Send evicts on Snoop Channel (otherwise use Request Channel)", "evict_on_snoop", true )
+  PARAMETER( TranslationMemoSize, uint32_t, "Entries in the per-thread instruction translation memo", "xlat_memo", 8 )
 );
 
 COMPONENT_INTERFACE(
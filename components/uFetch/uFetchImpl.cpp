@@ -34,10 +34,12 @@
 // CONTRACT, TORT OR OTHERWISE).
 //
 // DO-NOT-REMOVE end-copyright-block   
+#include <algorithm>
 #include <fstream>
 #include <set>
 
 #include <boost/none.hpp>
+#include <boost/circular_buffer.hpp>
 #include <core/boost_extensions/padded_string_cast.hpp>
 #include <core/stats.hpp>
 
@@ -217,10 +219,178 @@ struct SimCache {
 
 };
 
+// Set of block addresses with an outstanding evict.  It rarely holds more
+// than a handful of entries, so it is a small open-addressed table with
+// kBadTag marking empty slots, and it only grows if it fills past half.
+class EvictSet {
+  std::vector<uint64_t> theSlots;
+  uint32_t theBits;
+  uint32_t theSize;
+
+  uint32_t home(uint64_t anAddress) const {
+    return static_cast<uint32_t>((anAddress * 0x9E3779B97F4A7C15ULL) >> (64 - theBits));
+  }
+
+  int32_t findSlot(uint64_t anAddress) const {
+    uint32_t mask = theSlots.size() - 1;
+    for (uint32_t i = home(anAddress); ; i = (i + 1) & mask) {
+      if (theSlots[i] == anAddress) {
+        return i;
+      }
+      if (theSlots[i] == kBadTag) {
+        return -1;
+      }
+    }
+  }
+
+  void place(uint64_t anAddress) {
+    uint32_t mask = theSlots.size() - 1;
+    uint32_t i = home(anAddress);
+    while (theSlots[i] != kBadTag) {
+      i = (i + 1) & mask;
+    }
+    theSlots[i] = anAddress;
+  }
+
+public:
+  EvictSet()
+    : theSlots(16, kBadTag)
+    , theBits(4)
+    , theSize(0)
+  {}
+
+  uint32_t size() const {
+    return theSize;
+  }
+
+  bool contains(uint64_t anAddress) const {
+    return findSlot(anAddress) >= 0;
+  }
+
+  bool insert(uint64_t anAddress) {
+    if (contains(anAddress)) {
+      return false;
+    }
+    if (2 * (theSize + 1) > theSlots.size()) {
+      std::vector<uint64_t> old(theSlots.size() * 2, kBadTag);
+      old.swap(theSlots);
+      ++theBits;
+      for (uint64_t addr : old) {
+        if (addr != kBadTag) {
+          place(addr);
+        }
+      }
+    }
+    place(anAddress);
+    ++theSize;
+    return true;
+  }
+
+  bool erase(uint64_t anAddress) {
+    int32_t slot = findSlot(anAddress);
+    if (slot < 0) {
+      return false;
+    }
+    // backward-shift the rest of the probe run into the hole
+    uint32_t mask = theSlots.size() - 1;
+    uint32_t hole = slot;
+    for (uint32_t i = (hole + 1) & mask; theSlots[i] != kBadTag; i = (i + 1) & mask) {
+      if (((i - home(theSlots[i])) & mask) >= ((i - hole) & mask)) {
+        theSlots[hole] = theSlots[i];
+        hole = i;
+      }
+    }
+    theSlots[hole] = kBadTag;
+    --theSize;
+    return true;
+  }
+};
+
+// Append to a ring, doubling it in the rare case that it is full so that a
+// queued entry is never overwritten.
+template <class T>
+void ringPush( boost::circular_buffer<T> & aRing, T const & anItem ) {
+  if (aRing.full()) {
+    aRing.set_capacity(aRing.capacity() < 4 ? 8 : aRing.capacity() * 2);
+  }
+  aRing.push_back(anItem);
+}
+
+// Small fully-associative memo of recent instruction translations for one
+// thread, kept in MRU order.  Entries are keyed by the smallest SPARC page
+// (8KB) together with the TL/PSTATE and MMU primary context the
+// translation was made under, so a larger page simply occupies several
+// entries.  A physical page of zero
+// records a failed translation.
+class TranslationMemo {
+public:
+  static const uint32_t kPageShift = 13;
+
+private:
+  struct Entry {
+    uint64_t theVPage;
+    uint64_t thePPage;
+    uint64_t theContext;
+    int32_t theTL;
+    int32_t thePSTATE;
+  };
+  std::vector<Entry> theEntries;
+  uint32_t theCapacity;
+
+public:
+  TranslationMemo()
+    : theCapacity(0)
+  {}
+
+  void setCapacity(uint32_t aCapacity) {
+    theCapacity = aCapacity;
+    theEntries.clear();
+    theEntries.reserve(aCapacity);
+  }
+
+  void clear() {
+    theEntries.clear();
+  }
+
+  bool lookup(uint64_t aVAddr, CPUState const & aState, uint64_t aContext, uint64_t & aPAddr) {
+    uint64_t vpage = aVAddr >> kPageShift;
+    for (uint32_t i = 0; i < theEntries.size(); ++i) {
+      Entry const & e = theEntries[i];
+      if (e.theVPage == vpage && e.theContext == aContext && e.theTL == aState.theTL && e.thePSTATE == aState.thePSTATE) {
+        if (i != 0) {
+          std::rotate(theEntries.begin(), theEntries.begin() + i, theEntries.begin() + i + 1);
+        }
+        uint64_t offset = aVAddr & ((1ULL << kPageShift) - 1);
+        aPAddr = theEntries[0].thePPage ? (theEntries[0].thePPage | offset) : 0;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void insert(uint64_t aVAddr, CPUState const & aState, uint64_t aContext, uint64_t aPAddr) {
+    if (theCapacity == 0) {
+      return;
+    }
+    Entry e;
+    e.theVPage = aVAddr >> kPageShift;
+    e.thePPage = aPAddr & ~((1ULL << kPageShift) - 1);
+    e.theContext = aContext;
+    e.theTL = aState.theTL;
+    e.thePSTATE = aState.thePSTATE;
+    if (theEntries.size() < theCapacity) {
+      theEntries.push_back(e);
+    } else {
+      theEntries.back() = e;
+    }
+    std::rotate(theEntries.begin(), theEntries.end() - 1, theEntries.end());
+  }
+};
+
 class FLEXUS_COMPONENT(uFetch) {
   FLEXUS_COMPONENT_IMPL(uFetch);
 
-  std::vector< std::list< FetchAddr > > theFAQ;
+  std::vector< boost::circular_buffer< FetchAddr > > theFAQ;
 
   //This opcode is used to signal an ITLB miss to the core, to force
   //a resync with Qemu 
@@ -231,6 +401,8 @@ class FLEXUS_COMPONENT(uFetch) {
   Stat::StatCounter theFetches;
   Stat::StatCounter thePrefetches;
   Stat::StatCounter theFailedTranslations;
+  Stat::StatCounter theTranslationMemoHits;
+  Stat::StatCounter theTranslationMemoMisses;
   Stat::StatCounter theMisses;
   Stat::StatCounter theHits;
   Stat::StatCounter theMissCycles;
@@ -253,19 +425,20 @@ class FLEXUS_COMPONENT(uFetch) {
   std::vector< boost::optional< uint64_t > > theLastPrefetchVTagSet;
 
   // Set of outstanding evicts.
-  std::set< uint64_t > theEvictSet;
+  EvictSet theEvictSet;
 
-  //Cache the last translation to avoid calling Qemu 
-  uint64_t theLastVTagSet;
-  PhysicalMemoryAddress theLastPhysical;
+  //Per-thread memo of recent translations, to avoid calling Qemu
+  std::vector< TranslationMemo > theTranslationMemo;
+  //Physical address of the last line looked up in the I-cache
+  std::vector< PhysicalMemoryAddress > theLastPhysical;
 
   uint32_t theIndexShift;
   uint64_t theBlockMask;
   uint32_t theMissQueueSize;
 
-  std::list< MemoryTransport > theMissQueue;
-  std::list< MemoryTransport > theSnoopQueue;
-  std::list< MemoryTransport > theReplyQueue;
+  boost::circular_buffer< MemoryTransport > theMissQueue;
+  boost::circular_buffer< MemoryTransport > theSnoopQueue;
+  boost::circular_buffer< MemoryTransport > theReplyQueue;
 
   std::vector<CPUState> theCPUState;
 
@@ -309,13 +482,13 @@ public:
     , theFetches( statName() + "-Fetches" )
     , thePrefetches( statName() + "-Prefetches" )
     , theFailedTranslations( statName() + "-FailedTranslations" )
+    , theTranslationMemoHits( statName() + "-TranslationMemoHits" )
+    , theTranslationMemoMisses( statName() + "-TranslationMemoMisses" )
     , theMisses( statName() + "-Misses" )
     , theHits( statName() + "-Hits" )
     , theMissCycles( statName() + "-MissCycles" )
     , theAllocations( statName() + "-Allocations" )
     , theMaxOutstandingEvicts( statName() + "-MaxEvicts" )
-    , theLastVTagSet(0)
-    , theLastPhysical(0)
   {}
 
   void initialize() {
@@ -325,6 +498,9 @@ public:
     theBlockMask = ~ (cfg.ICacheLineSize - 1);
 
     theFAQ.resize(cfg.Threads);
+    for (uint32_t i = 0; i < cfg.Threads; ++i) {
+      theFAQ[i].set_capacity(cfg.FAQSize);
+    }
     theIcacheMiss.resize(cfg.Threads);
     theIcacheVMiss.resize(cfg.Threads);
     theFetchReplyTransactionTracker.resize(cfg.Threads);
@@ -332,8 +508,17 @@ public:
     theIcachePrefetch.resize(cfg.Threads);
     theLastPrefetchVTagSet.resize(cfg.Threads);
     theCPUState.resize(cfg.Threads);
+    theTranslationMemo.resize(cfg.Threads);
+    for (uint32_t i = 0; i < cfg.Threads; ++i) {
+      theTranslationMemo[i].setCapacity(cfg.TranslationMemoSize);
+    }
+    theLastPhysical.resize(cfg.Threads, PhysicalMemoryAddress(0));
 
     theMissQueueSize = cfg.MissQueueSize;
+    // evicts and demand misses may briefly exceed MissQueueSize
+    theMissQueue.set_capacity(2 * theMissQueueSize + 2);
+    theSnoopQueue.set_capacity(8);
+    theReplyQueue.set_capacity(8);
   }
 
   void finalize() {}
@@ -369,11 +554,9 @@ public:
   //FetchAddressIn
   FLEXUS_PORT_ARRAY_ALWAYS_AVAILABLE(FetchAddressIn);
   void push( interface::FetchAddressIn const &, index_t anIndex, boost::intrusive_ptr<FetchCommand> & aCommand) {
-    std::copy
-    ( aCommand->theFetches.begin()
-      , aCommand->theFetches.end()
-      , std::back_inserter( theFAQ[anIndex] )
-    );
+    for (FetchAddr const & fetch : aCommand->theFetches) {
+      ringPush( theFAQ[anIndex], fetch );
+    }
   }
 
   //AvailableFAQOut
@@ -393,6 +576,7 @@ public:
     theLastMiss[anIndex] = boost::none;
     theIcachePrefetch[anIndex] = boost::none;
     theLastPrefetchVTagSet[anIndex] = 0;
+    theTranslationMemo[anIndex].clear();
   }
 
   //ChangeCPUState
@@ -400,6 +584,7 @@ public:
   void push( interface::ChangeCPUState const &, index_t anIndex, CPUState & aState) {
     DBG_( Iface, Comp(*this) ( << "CPU[" << std::setfill('0') << std::setw(2) << flexusIndex() << "." << anIndex << "] Change CPU State.  TL: " << aState.theTL << " PSTATE: " << std::hex << aState.thePSTATE << std::dec ));
     theCPUState[anIndex] = aState;
+    theTranslationMemo[anIndex].clear();
   }
 
   //FetchMissIn
@@ -479,31 +664,29 @@ private:
 
   bool icacheLookup( index_t anIndex, VirtualMemoryAddress vaddr ) {
     //Translate virtual address to physical.
-    //First, see if it is our cached translation
-    PhysicalMemoryAddress paddr;
+    //First, see if it is one of our memoized translations
     uint64_t tagset = vaddr >> theIndexShift;
-    if ( tagset == theLastVTagSet ) {
-      paddr = theLastPhysical;
-      if (paddr == 0) {
-        ++theFailedTranslations;
-        return true; //Failed translations are treated as hits - they will cause an ITLB miss in the pipe.
-      }
+    uint64_t memo_paddr = 0;
+    uint64_t context = cpu(anIndex)->primaryContext();
+    if ( theTranslationMemo[anIndex].lookup(vaddr, theCPUState[anIndex], context, memo_paddr) ) {
+      ++theTranslationMemoHits;
     } else {
+      ++theTranslationMemoMisses;
       Flexus::Qemu::Translation xlat;
       xlat.theVaddr = vaddr;
       xlat.theTL = theCPUState[anIndex].theTL;
       xlat.thePSTATE = theCPUState[anIndex].thePSTATE;
       xlat.theType = Flexus::Qemu::Translation::eFetch;
       cpu(anIndex)->translate(xlat, false /* do not trap */ );
-      paddr = xlat.thePaddr;
-      if (paddr == 0) {
-        ++theFailedTranslations;
-        return true; //Failed translations are treated as hits - they will cause an ITLB miss in the pipe.
-      }
-      //Cache translation
-      theLastPhysical = paddr;
-      theLastVTagSet = tagset;
+      memo_paddr = xlat.thePaddr;
+      theTranslationMemo[anIndex].insert(vaddr, theCPUState[anIndex], context, memo_paddr);
+    }
+    PhysicalMemoryAddress paddr(memo_paddr);
+    if (paddr == 0) {
+      ++theFailedTranslations;
+      return true; //Failed translations are treated as hits - they will cause an ITLB miss in the pipe.
     }
+    theLastPhysical[anIndex] = paddr;
 
     bool hit = lookup(paddr);
     ++theFetchAccesses;
@@ -550,7 +733,7 @@ private:
 
       if (!trans[MemoryMessageTag]->isEvictType()) {
         PhysicalMemoryAddress temp(trans[MemoryMessageTag]->address() & theBlockMask);
-        if (theEvictSet.find(temp) != theEvictSet.end()) {
+        if (theEvictSet.contains(temp)) {
           DBG_(Trace, Comp(*this) ( << "Trying to fetch block while evict in process, stalling miss: " << *trans[MemoryMessageTag] ));
           break;
         }
@@ -593,9 +776,9 @@ private:
     }
     aTransport.set ( MemoryMessageTag, msg );
     if (cfg.UseReplyChannel) {
-      theReplyQueue.push_back ( aTransport );
+      ringPush( theReplyQueue, aTransport );
     } else {
-      theSnoopQueue.push_back ( aTransport );
+      ringPush( theSnoopQueue, aTransport );
     }
   }
 
@@ -685,8 +868,7 @@ private:
           aTransport[DestinationTag]->type = DestinationMessage::Requester;
           queueSnoopMessage( aTransport, MemoryMessage::FwdReply, reply->address());
         } else {
-          std::set<uint64_t>::iterator iter = theEvictSet.find(reply->address());
-          if (iter != theEvictSet.end()) {
+          if (theEvictSet.contains(reply->address())) {
             aTransport[DestinationTag]->type = DestinationMessage::Requester;
             queueSnoopMessage( aTransport, MemoryMessage::FwdReply, reply->address());
           } else {
@@ -705,8 +887,7 @@ private:
           aTransport[DestinationTag]->type = DestinationMessage::Requester;
           queueSnoopMessage( aTransport, MemoryMessage::FwdReplyWritable, reply->address());
         } else {
-          std::set<uint64_t>::iterator iter = theEvictSet.find(reply->address());
-          if (iter != theEvictSet.end()) {
+          if (theEvictSet.contains(reply->address())) {
             aTransport[DestinationTag]->type = DestinationMessage::Requester;
             queueSnoopMessage( aTransport, MemoryMessage::FwdReplyWritable, reply->address());
           } else {
@@ -736,9 +917,8 @@ private:
         break;
 
       case MemoryMessage::EvictAck: {
-        std::set<uint64_t>::iterator iter = theEvictSet.find(reply->address());
-        DBG_Assert(iter != theEvictSet.end(), Comp(*this) ( << "Block not found in EvictBuffer upon receipt of Ack: " << *reply ));
-        theEvictSet.erase(iter);
+        bool found = theEvictSet.erase(reply->address());
+        DBG_Assert(found, Comp(*this) ( << "Block not found in EvictBuffer upon receipt of Ack: " << *reply ));
         break;
       }
       default:
@@ -753,8 +933,8 @@ private:
       operation->reqSize() = 64;
 
       // Put in evict buffer and wait for Ack
-      std::pair<std::set<uint64_t>::iterator, bool> ret = theEvictSet.insert(anAddress);
-      DBG_Assert(ret.second);
+      bool inserted = theEvictSet.insert(anAddress);
+      DBG_Assert(inserted);
       theMaxOutstandingEvicts << theEvictSet.size();
       operation->ackRequired() = true;
 
@@ -765,9 +945,9 @@ private:
       transport.set(MemoryMessageTag, operation);
 
       if (cfg.EvictOnSnoop) {
-        theSnoopQueue.push_back ( transport );
+        ringPush( theSnoopQueue, transport );
       } else {
-        theMissQueue.push_back( transport );
+        ringPush( theMissQueue, transport );
       }
     }
   }
@@ -786,7 +966,7 @@ private:
     transport.set(TransactionTrackerTag, tracker);
     transport.set(MemoryMessageTag, operation);
 
-    theMissQueue.push_back(transport);
+    ringPush( theMissQueue, transport );
   }
 
   //Implementation of the FetchDrive drive interface
@@ -850,7 +1030,7 @@ private:
                                       , theFetchReplyTransactionTracker[anIndex]
                                                    )
                                     );
-        if (from_icache && theLastMiss[anIndex] && theLastPhysical == theLastMiss[anIndex]->first) {
+        if (from_icache && theLastMiss[anIndex] && theLastPhysical[anIndex] == theLastMiss[anIndex]->first) {
           bundle->theFillLevels.push_back(theLastMiss[anIndex]->second);
           theLastMiss[anIndex] = boost::none;
         } else {
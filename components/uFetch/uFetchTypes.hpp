@@ -41,6 +41,7 @@
 #include <iostream>
 
 #include <core/boost_extensions/intrusive_ptr.hpp>
+#include <core/fast_alloc.hpp>
 #include <components/CommonQEMU/Slices/TransactionTracker.hpp>
 #include <components/CommonQEMU/Slices/FillLevel.hpp>
 
@@ -78,6 +79,14 @@ struct BPredState : boost::counted_base {
   eDirection theGSharePrediction;
   uint32_t theGShareShiftReg;
   uint32_t theSerial;
+  //Tagged table indices and tags hashed at predict time by the TAGE
+  //predictor, so feedback trains the entries the prediction read
+  static const int32_t kTageTables = 7;
+  static const int32_t kTageTargetTables = 5;
+  uint32_t theTageIndex[kTageTables];
+  uint16_t theTageTag[kTageTables];
+  uint32_t theTageTargetIndex[kTageTargetTables];
+  uint16_t theTageTargetTag[kTageTargetTables];
 };
 
 struct FetchAddr {
@@ -123,7 +132,7 @@ struct FetchedOpcode {
   { }
 };
 
-struct FetchBundle : public boost::counted_base {
+struct FetchBundle : public boost::counted_base, public FastAlloc {
   std::list< FetchedOpcode > theOpcodes;
   std::list< tFillLevel > theFillLevels;
 };
@@ -137,6 +137,7 @@ private:
     ar & boost::serialization::base_object<Measurement>(*this);
     ar & theStats;
   }
+protected:
   SimpleMeasurement( ) {}
 
 public:
@@ -147,6 +148,7 @@ public:
 
   void addToMeasurement( Stat * aStat );
   void close();
+  void reset();
   bool isSimple() {
     return true;
   }
@@ -234,6 +236,74 @@ public:
   void fire();
 };
 
+//Evaluates a stats_calc expression over its stats once per interval, then
+//resets them, keeping the running mean and variance of the results.  When
+//the relative confidence interval of the mean first narrows to the target,
+//theOnConverged runs (e.g. to end the simulation).  With a period of zero
+//the owner drives the intervals through reset() and sample(), or computes
+//each interval's value elsewhere and passes it to addSample().
+class ConfidenceMeasurement : public SimpleMeasurement {
+  std::string theExpression;
+  int64_t thePeriod;
+  double theConfidence;
+  double theTargetError;
+  int64_t theMinSamples;
+  bool theCancelled;
+  bool theConverged;
+  int64_t theSamples;
+  double theMean;
+  double theM2;
+  std::function<void()> theOnConverged;
+
+private:
+  friend class boost::serialization::access;
+  template<class Archive>
+  void serialize(Archive & ar, uint32_t version) {
+    ar & boost::serialization::base_object<SimpleMeasurement>(*this);
+    ar & theExpression;
+    ar & thePeriod;
+    ar & theConfidence;
+    ar & theTargetError;
+    ar & theMinSamples;
+    ar & theConverged;
+    ar & theSamples;
+    ar & theMean;
+    ar & theM2;
+  }
+  ConfidenceMeasurement( )
+    : theCancelled(true)
+  {}
+
+public:
+  ConfidenceMeasurement( std::string const & aName, std::string const & aStatExpression, std::string const & anExpression, int64_t aPeriod, double aConfidence, double aTargetError, int64_t aMinSamples, std::function<void()> anOnConverged);
+  virtual ~ConfidenceMeasurement() {}
+
+  void close();
+  void print( std::ostream & anOstream, std::string const & options = std::string(""));
+  void fire();
+  bool sample();
+  void addSample(double aValue);
+
+  int64_t samples() const {
+    return theSamples;
+  }
+  double mean() const {
+    return theMean;
+  }
+  bool converged() const {
+    return theConverged;
+  }
+  //Sample variance of the interval values
+  double variance() const;
+  //Confidence interval half-width relative to the mean.  An interval of
+  //zero width is 0 even when the mean is 0, so a metric that is always 0
+  //converges; otherwise a mean of 0 gives HUGE_VAL.
+  double relativeError() const;
+
+  //Two-sided standard normal quantile, e.g. 0.95 -> 1.96
+  static double zScore(double aConfidence);
+};
+
 } // end aux_
 } // end Stat
 } // end Flexus
@@ -59,7 +59,13 @@ struct ComponentManager {
   // end PLotfi
   virtual bool isQuiesced() const = 0;
   virtual void doSave(std::string const & aDirectory) const = 0;
-  virtual void doLoad(std::string const & aDirectory) = 0;
+  virtual void doLoad(std::string const & aDirectory, uint32_t aThreads = 1) = 0;
+  //Workers loading component state concurrently; 1 outside a parallel doLoad
+  virtual uint32_t loadThreads() const = 0;
+  //aParameter is a configuration key, "-<config>:<switch>"
+  virtual bool isReconfigurable(std::string const & aParameter) const = 0;
+  virtual void prepareFork() = 0;
+  virtual void reconfigureComponents() = 0;
   virtual void registerComponent( ComponentInterface * aComponent) = 0;
   virtual void registerHandle( std::function< void (Flexus::Core::index_t) > anInstantiator) = 0;
   virtual void instantiateComponents(Flexus::Core::index_t aSystemWidth  )  = 0;
@@ -171,6 +177,10 @@ public:
     return name();
   }
 
+  std::string configName() const {
+    return cfg.name();
+  }
+
   virtual bool isQuiesced() const {
     DBG_( Crit, ( << "Warning: isQuiesced() is not implemented in component " << name() ) );
     return true;
@@ -67,6 +67,23 @@ struct ComponentInterface {
   virtual bool isQuiesced() const = 0;
   virtual void saveState(std::string const & aDirectory) = 0;
   virtual void loadState(std::string const & aDirectory) = 0;
+  //Components whose loadState only touches their own state and files
+  //return true, so the ComponentManager may load them concurrently
+  virtual bool loadsIndependently() const {
+    return false;
+  }
+  //Configuration sweeps fork warmed copies of the simulator.  prepareFork()
+  //is called before the fork and must stop any thread the component owns,
+  //as only the forking thread survives in the copies.  Each copy then
+  //applies its overrides and calls reconfigure(), which re-applies the
+  //parameters and restarts what prepareFork() stopped.  Overrides are only
+  //accepted for switches isReconfigurable() names.
+  virtual void prepareFork() {}
+  virtual void reconfigure() {}
+  virtual bool isReconfigurable(std::string const & aSwitch) const {
+    return false;
+  }
+  virtual std::string configName() const = 0;
   virtual std::string name() const = 0;
   virtual ~ComponentInterface() {}
 
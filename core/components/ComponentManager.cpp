@@ -37,6 +37,9 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
 
 #include <functional>
 
@@ -59,8 +62,12 @@ class ComponentManagerImpl : public ComponentManager {
   std::vector< std::function< void (Flexus::Core::index_t aSystemWidth ) > > theInstantiationFunctions;
   std::vector< ComponentInterface * > theComponents;
   Flexus::Core::index_t theSystemWidth;
+  uint32_t theLoadThreads;
 
 public:
+  ComponentManagerImpl()
+    : theLoadThreads(1)
+  {}
   virtual ~ComponentManagerImpl() {}
 
   Flexus::Core::index_t systemWidth() const {
@@ -137,23 +144,88 @@ public:
     // );
   }
 
-  void doLoad(std::string const & aDirectory) {
-    std::vector< ComponentInterface * >::iterator iter, end;
-    iter = theComponents.begin();
-    end = theComponents.end();
-    while (iter != end) {
-      DBG_( Dev, ( << "Loading state: " << (*iter)->name() ) );
-      (*iter)->loadState(aDirectory);
-      ++iter;
+  //Components that don't declare loadsIndependently() are loaded first, in
+  //registration order, on the calling thread.  The rest are handed out to
+  //aThreads workers (0 = one per hardware thread), and doLoad returns once
+  //all of them have finished.
+  void doLoad(std::string const & aDirectory, uint32_t aThreads) {
+    std::vector< ComponentInterface * > independent;
+    for(auto* aComponent: theComponents){
+      if (aComponent->loadsIndependently()) {
+        independent.push_back(aComponent);
+      } else {
+        DBG_( Dev, ( << "Loading state: " << aComponent->name() ) );
+        aComponent->loadState(aDirectory);
+      }
+    }
+
+    if (aThreads == 0) {
+      aThreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    aThreads = std::min<std::size_t>(aThreads, independent.size());
+
+    std::atomic<std::size_t> next(0);
+    auto loader = [&]() {
+      for (std::size_t i = next++; i < independent.size(); i = next++) {
+        DBG_( Dev, ( << "Loading state: " << independent[i]->name() ) );
+        independent[i]->loadState(aDirectory);
+      }
+    };
+    if (aThreads <= 1) {
+      loader();
+    } else {
+      DBG_( Dev, ( << "Loading " << independent.size() << " components on " << aThreads << " threads" ) );
+      //Components size their own worker pools from loadThreads()
+      theLoadThreads = aThreads;
+      std::vector< std::future<void> > workers;
+      for (uint32_t i = 0; i < aThreads; ++i) {
+        workers.push_back( std::async( std::launch::async, loader ) );
+      }
+      //get() rethrows a failure from any worker on this thread
+      for (auto & worker: workers) {
+        worker.get();
+      }
+      theLoadThreads = 1;
     }
     DBG_( Crit, ( << " Done loading.") );
-    /*
-          std::for_each
-            ( theComponents.begin()
-            , theComponents.end()
-            , ll::bind( &ComponentInterface::loadState, ll::_1, aDirectory )
-            );
-    */
+  }
+
+  uint32_t loadThreads() const {
+    return theLoadThreads;
+  }
+
+  //A parameter is reconfigurable if its configuration has components and
+  //every one of them can re-apply the switch
+  bool isReconfigurable(std::string const & aParameter) const {
+    std::string::size_type colon = aParameter.find(':');
+    if (aParameter.empty() || aParameter[0] != '-' || colon == std::string::npos) {
+      return false;
+    }
+    std::string config( aParameter.substr(1, colon - 1) );
+    std::string option( aParameter.substr(colon + 1) );
+    bool found = false;
+    for(auto* aComponent: theComponents){
+      if (aComponent->configName() == config) {
+        if (! aComponent->isReconfigurable(option)) {
+          return false;
+        }
+        found = true;
+      }
+    }
+    return found;
+  }
+
+  void prepareFork() {
+    for(auto* aComponent: theComponents){
+      aComponent->prepareFork();
+    }
+  }
+
+  void reconfigureComponents() {
+    for(auto* aComponent: theComponents){
+      DBG_( Dev, ( << "Reconfiguring " << aComponent->name() ) );
+      aComponent->reconfigure();
+    }
   }
 
 };
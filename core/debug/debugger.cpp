@@ -60,6 +60,7 @@ Debugger::~Debugger() {
 }
 
 void Debugger::process(Entry const & anEntry) {
+  std::lock_guard<std::recursive_mutex> lock(theProcessLock);
   for(auto* aTarget: theTargets){
     aTarget->process(anEntry);
   }
@@ -38,6 +38,8 @@
 #include <string>
 #include <memory>
 #include <queue>
+#include <atomic>
+#include <mutex>
 
 #include <boost/optional.hpp>
 
@@ -74,9 +76,13 @@ class Debugger {
   std::map<std::string, bool *> theCategories;
   std::map<std::string, std::vector< bool *> > theComponents;
 
-  int64_t theCount;
+  std::atomic<int64_t> theCount;
   uint64_t * theCycleCount;
 
+  //Components may load their state on worker threads, so entries reaching
+  //the targets are serialized
+  std::recursive_mutex theProcessLock;
+
   std::priority_queue<At> theAts; //Owns all targets
 
 public:
@@ -64,61 +64,73 @@
  * 608-262-2196
  *
  */
-#ifdef __GNUC__
-#pragma implementation
-#endif
+#include <string>
+#include <vector>
 
 #include <core/fast_alloc.hpp>
+#include <core/stats.hpp>
 
-void * FastAlloc::freeLists[Num_Buckets];
+FastAlloc::Bucket FastAlloc::theBuckets[Num_Buckets];
 
-#ifdef FAST_ALLOC_STATS
-unsigned FastAlloc::newCount[Num_Buckets];
-unsigned FastAlloc::deleteCount[Num_Buckets];
-unsigned FastAlloc::allocCount[Num_Buckets];
-#endif
+void * FastAlloc::moreStructs(Bucket & aBucket, int32_t bucket) {
+  DBG_Assert(bucket > 0 && bucket < Num_Buckets);
 
-void * FastAlloc::moreStructs(int32_t bucket) {
-  assert(bucket > 0 && bucket < Num_Buckets);
+  size_t sz = bucket * Alloc_Quantum;
+  size_t nstructs = Slab_Size / sz;
+  char * p = static_cast<char *>(::operator new(nstructs * sz));
+  ++aBucket.theSlabs;
 
-  int32_t sz = bucket * Alloc_Quantum;
-  const int32_t nstructs = Num_Structs_Per_New; // how many to allocate?
-  char * p = (char *)::new char[nstructs * sz];
+  // Hand out the first struct; thread the rest onto the free list
+  aBucket.theFreeList = p + sz;
+  char * q = p + sz;
+  for (size_t i = 1; i < (nstructs - 1); ++i, q += sz) {
+    * (void **)q = q + sz;
+  }
+  *(void **)q = 0;
 
-#ifdef FAST_ALLOC_STATS
-  ++allocCount[bucket];
-#endif
+  return p;
+}
 
-  freeLists[bucket] = p;
-  for (int32_t i = 0; i < (nstructs - 2); ++i, p += sz)
-    * (void **)p = p + sz;
-  *(void **)p = 0;
+namespace {
+struct FastAllocStats {
+  Flexus::Stat::StatCounter theLive;
+  Flexus::Stat::StatMax thePeak;
+  int64_t theReportedLive;
 
-  return (p + sz);
+  FastAllocStats(std::string const & aName)
+    : theLive(aName + "-Live")
+    , thePeak(aName + "-Peak")
+    , theReportedLive(0)
+  {}
+};
 }
 
-#ifdef FAST_ALLOC_DEBUG
+void FastAlloc::reportStats() {
+  // Stats for a size class are created the first time it is seen in use,
+  // so classes no object ever mapped to do not clutter the stats file.
+  static std::vector<FastAllocStats *> theStats(Num_Buckets, static_cast<FastAllocStats *>(0));
+  static Flexus::Stat::StatCounter theSlabBytes("sys-FastAlloc-SlabBytes");
+  static int64_t theReportedSlabBytes = 0;
 
-FastAlloc * FastAlloc::inUseList;
+  int64_t slab_bytes = 0;
+  for (int32_t b = 1; b < Num_Buckets; ++b) {
+    Bucket & bucket = theBuckets[b];
+    while (bucket.theLock.test_and_set(std::memory_order_acquire)) { }
+    int64_t live = bucket.theLive;
+    int64_t peak = bucket.thePeak;
+    slab_bytes += bucket.theSlabs * static_cast<int64_t>(Slab_Size / (b * Alloc_Quantum) * (b * Alloc_Quantum));
+    bucket.theLock.clear(std::memory_order_release);
 
-FastAlloc::FastAlloc() {
-  inUsePrev = nullptr;
-  inUseNext = inUseList;
-  if (inUseList) {
-    inUseList->inUsePrev = this;
+    if (peak == 0) {
+      continue;
+    }
+    if (!theStats[b]) {
+      theStats[b] = new FastAllocStats("sys-FastAlloc-" + std::to_string(b * Alloc_Quantum) + "B");
+    }
+    theStats[b]->theLive += live - theStats[b]->theReportedLive;
+    theStats[b]->theReportedLive = live;
+    theStats[b]->thePeak << peak;
   }
-  inUseList = this;
+  theSlabBytes += slab_bytes - theReportedSlabBytes;
+  theReportedSlabBytes = slab_bytes;
 }
-
-FastAlloc::~FastAlloc() {
-  if (inUsePrev) {
-    inUsePrev->inUseNext = inUseNext;
-  } else {
-    assert(inUseList == this);
-    inUseList = inUseNext;
-  }
-
-  inUseNext->inUsePrev = inUsePrev;
-}
-
-#endif
@@ -67,13 +67,22 @@
 #ifndef _fast_alloc_h
 #define _fast_alloc_h
 
-#ifdef __GNUC__
-#pragma interface
-#endif
-
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <core/debug/debug.hpp>
 
+// Size-class slab allocator for small, frequently allocated simulator
+// objects.  Deriving from FastAlloc routes a class's operator new/delete
+// through per-size-class free lists carved out of large slabs, so the
+// per-transaction objects (messages, trackers, lookup results, directory
+// entries) never reach malloc in steady state.  FastAlloc adds no data
+// members and no vtable; the sized operator delete relies on the derived
+// class having a virtual destructor (counted_base provides one) whenever
+// objects are deleted through a base pointer.
+//
+// Live and peak object counts per size class are kept here and published
+// to the stats system by reportStats().
 class FastAlloc {
 public:
 
@@ -81,51 +90,48 @@ public:
   static void deallocate(void *, size_t);
 
   void * operator new(size_t);
-  // inline void operator delete(void *, size_t);
-  inline void operator delete(void *, size_t);
-
-#ifdef FAST_ALLOC_DEBUG
-  FastAlloc();
-  virtual ~FastAlloc();
-#else
-  virtual ~FastAlloc() {}
-#endif
+  void operator delete(void *, size_t);
+
+  // Push live/peak counts into the sys-FastAlloc-* stats.  Called from
+  // the simulator before stats are written out.
+  static void reportStats();
+
+protected:
+  ~FastAlloc() {}
 
 private:
 
   // Max_Alloc_Size is the largest object that can be allocated with
-  // this class.  There's no fundamental limit, but this limits the
-  // size of the freeLists array.  Let's not make this really huge
-  // like in Blizzard.
+  // this class.  Larger objects go straight to the global operator new.
   static const size_t Max_Alloc_Size = 512;
 
-  // Alloc_Quantum is the difference in size between adjacent
-  // buckets in the free list array.
-  static const int32_t Log2_Alloc_Quantum = 3;
+  // Alloc_Quantum is the difference in size between adjacent buckets
+  // in the free list array.  16 keeps every object at the alignment
+  // the global operator new guarantees.
+  static const int32_t Log2_Alloc_Quantum = 4;
   static const int32_t Alloc_Quantum = (1 << Log2_Alloc_Quantum);
 
   // Num_Buckets = bucketFor(Max_Alloc_Size) + 1
   static const int32_t Num_Buckets = ((Max_Alloc_Size + Alloc_Quantum - 1) >> Log2_Alloc_Quantum) + 1;
 
-  // when we call new() for more structures, how many should we get?
-  static const int32_t Num_Structs_Per_New = 20;
+  // Bytes requested from the global allocator each time a bucket runs dry.
+  static const size_t Slab_Size = 64 * 1024;
 
-  static int32_t bucketFor(size_t);
-  static void * moreStructs(int32_t bucket);
-
-  static void * freeLists[Num_Buckets];
+  struct Bucket {
+    // Simulation is single threaded, but helper threads (e.g. parallel
+    // state loading) may create objects too; the lock is uncontended in
+    // the common case.
+    std::atomic_flag theLock;
+    void * theFreeList;
+    int64_t theLive;
+    int64_t thePeak;
+    int64_t theSlabs;
+  };
 
-#ifdef FAST_ALLOC_STATS
-  static unsigned newCount[Num_Buckets];
-  static unsigned deleteCount[Num_Buckets];
-  static unsigned allocCount[Num_Buckets];
-#endif
+  static int32_t bucketFor(size_t);
+  static void * moreStructs(Bucket &, int32_t bucket);
 
-#ifdef FAST_ALLOC_DEBUG
-  static FastAlloc * inUseList;
-  FastAlloc * inUsePrev;
-  FastAlloc * inUseNext;
-#endif
+  static Bucket theBuckets[Num_Buckets];
 };
 
 inline
@@ -135,24 +141,25 @@ int32_t FastAlloc::bucketFor(size_t sz) {
 
 inline
 void * FastAlloc::allocate(size_t sz) {
-  int32_t b;
-  void * p;
-
-  if (sz > Max_Alloc_Size)
-    return (void *)::new char[sz];
-
-  b = bucketFor(sz);
-  p = freeLists[b];
+  if (sz > Max_Alloc_Size) {
+    return ::operator new(sz);
+  }
 
-  if (p)
-    freeLists[b] = *(void **)p;
-  else
-    p = moreStructs(b);
+  int32_t b = bucketFor(sz);
+  Bucket & bucket = theBuckets[b];
+  while (bucket.theLock.test_and_set(std::memory_order_acquire)) { }
 
-#ifdef FAST_ALLOC_STATS
-  ++newCount[b];
-#endif
+  void * p = bucket.theFreeList;
+  if (p) {
+    bucket.theFreeList = *(void **)p;
+  } else {
+    p = moreStructs(bucket, b);
+  }
+  if (++bucket.theLive > bucket.thePeak) {
+    bucket.thePeak = bucket.theLive;
+  }
 
+  bucket.theLock.clear(std::memory_order_release);
   return p;
 }
 
@@ -163,26 +170,28 @@ void * FastAlloc::operator new(size_t sz) {
 
 inline
 void FastAlloc::deallocate(void * p, size_t sz) {
-  int32_t b;
-
   DBG_Assert(p != nullptr);
 
   if (sz > Max_Alloc_Size) {
-    ::delete [] ((char *) p);
+    ::operator delete(p);
     return;
   }
 
-  b = bucketFor(sz);
-  *(void **)p = freeLists[b];
-  freeLists[b] = p;
-#ifdef FAST_ALLOC_STATS
-  ++deleteCount[b];
-#endif
+  Bucket & bucket = theBuckets[bucketFor(sz)];
+  while (bucket.theLock.test_and_set(std::memory_order_acquire)) { }
+
+  *(void **)p = bucket.theFreeList;
+  bucket.theFreeList = p;
+  --bucket.theLive;
+
+  bucket.theLock.clear(std::memory_order_release);
 }
 
 inline
 void FastAlloc::operator delete(void * p, size_t sz) {
-  deallocate(p, sz);
+  if (p) {
+    deallocate(p, sz);
+  }
 }
 
 #endif
@@ -40,9 +40,13 @@
 #include <fstream>
 #include <sstream>
 #include <chrono>
+#include <vector>
+#include <algorithm>
 
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include <core/target.hpp>
 
@@ -57,6 +61,7 @@
 #include <core/drive_reference.hpp>
 
 #include <core/stats.hpp>
+#include <core/fast_alloc.hpp>
 
 #include <core/exception.hpp>
 
@@ -103,6 +108,12 @@ private:
   uint64_t theProfileInterval;
   uint64_t theTimestampInterval;
   uint64_t theStopCycle;
+  uint64_t theSweepCycle;
+  typedef std::vector< std::pair<std::string, std::string> > sweep_overrides;
+  typedef std::vector< std::pair<std::string, sweep_overrides> > sweep_variants;
+  sweep_variants theSweepVariants;
+  uint32_t theLoadThreads;
+  bool theLoadMismatchOk;
   Stat::StatCounter theCycleCountStat;
 
   std::string theCurrentStatRegionName;
@@ -169,6 +180,12 @@ public:
   //Flexus command line interface
   void printCycleCount();
   void setStopCycle(std::string const & aValue);
+  void forkSweep(std::string const & aSpecFile);
+  void scheduleForkSweep(std::string const & aSpecFile, uint64_t aCycle);
+  bool readSweep(std::string const & aSpecFile, sweep_variants & aVariants);
+  void forkVariants(sweep_variants const & aVariants);
+  void setLoadThreads(uint32_t aThreads);
+  void setLoadMismatchOk(bool anOk);
   void setStatInterval(std::string const & aValue);
   void setRegionInterval(std::string const & aValue);
   void setBreakCPU(int32_t aCPU);
@@ -195,6 +212,11 @@ public:
   void loadState(std::string const & aDirName);
   void doLoad(std::string const & aDirName);
   void doSave(std::string const & aDirName, bool justFlexus = false);
+  void doSaveAndBreak(std::string const & aDirName);
+#ifdef CONFIG_QEMU
+  void writeCheckpointManifest(std::string const & aDirName) const;
+  void readCheckpointManifest(std::string const & aDirName);
+#endif
   void backupStats(std::string const & aFilename) const;
   void saveStats(std::string const & aFilename) const;
   void saveStatsUncompressed(std::ofstream & anOstream) const;
@@ -212,6 +234,7 @@ public:
   void writeDebugConfiguration(std::string const & aFilename);
   void onTerminate( std::function<void () > );
   void terminateSimulation();
+  void requestStop();
   void log(std::string const & aName, std::string const & anInterval, std::string const & aRegEx);
   void printMMU(int32_t aCPU);
 
@@ -227,6 +250,9 @@ public:
     , theProfileInterval(1000000)
     , theTimestampInterval(100000)
     , theStopCycle(2000000000)
+    , theSweepCycle(0)
+    , theLoadThreads(1)
+    , theLoadMismatchOk(false)
     , theCycleCountStat("sys-cycles")
     , theWatchdogWarning(false)
     , theQuiesceRequested(false)
@@ -248,6 +274,9 @@ public:
     , theProfileInterval(1000000)
     , theTimestampInterval(100000)
     , theStopCycle(2000000000)
+    , theSweepCycle(0)
+    , theLoadThreads(1)
+    , theLoadMismatchOk(false)
     , theCycleCountStat("sys-cycles")
     , theWatchdogWarning(false)
     , theQuiesceRequested(false)
@@ -297,7 +326,7 @@ void FlexusImpl::advanceCycles(int64_t aCycleCount) {
     theQuiesceRequested = false;
     if (theSaveRequested) {
       theSaveRequested = false;
-      doSave( theSaveName );
+      doSaveAndBreak( theSaveName );
     } else {
 #ifndef CONFIG_QEMU
       Simics::BreakSimulation( "Flexus is quiesced." );
@@ -322,9 +351,15 @@ void FlexusImpl::advanceCycles(int64_t aCycleCount) {
     terminateSimulation();
   }
 
+  if ( (theSweepCycle > 0) && (theCycleCount >= theSweepCycle) ) {
+    theSweepCycle = 0;
+    forkVariants(theSweepVariants);
+  }
+
   static uint64_t last_stats = 0;
   if (theCycleCount - last_stats >= theStatInterval) {
     DBG_(Dev, Core() ( << "Saving stats at: " << theCycleCount));
+    FastAlloc::reportStats();
     backupStats("stats_db");
 
 #ifdef WRITE_ALL_MEASUREMENT_OUT
@@ -428,6 +463,192 @@ void FlexusImpl::setStopCycle(std::string const & aValue) {
   theStopCycle = boost::lexical_cast<uint64_t>(aValue);
 }
 
+void FlexusImpl::requestStop() {
+  theStopCycle = theCycleCount + 1;
+}
+
+void FlexusImpl::setLoadThreads(uint32_t aThreads) {
+  theLoadThreads = aThreads;
+}
+
+void FlexusImpl::setLoadMismatchOk(bool anOk) {
+  theLoadMismatchOk = anOk;
+}
+
+//A sweep scheduled from the configuration is checked before any warming,
+//so a bad sweep file stops the run at startup rather than at fork time.
+void FlexusImpl::scheduleForkSweep(std::string const & aSpecFile, uint64_t aCycle) {
+  bool valid = readSweep(aSpecFile, theSweepVariants);
+  DBG_Assert( valid && ! theSweepVariants.empty(), ( << "Rejecting configuration sweep " << aSpecFile ) );
+  theSweepCycle = std::max<uint64_t>(aCycle, 1);
+  DBG_(Dev, Set( (Source) << "flexus") ( << "Configuration sweep " << aSpecFile << " will fork " << theSweepVariants.size() << " variants at cycle " << theSweepCycle ) );
+}
+
+// Reads a configuration sweep file.  Each line names a variant followed by
+// the parameter overrides it applies:
+//
+//   <variant-name> <parameter>=<value> [<parameter>=<value> ...]
+//
+// Parameters are configuration keys, as in configuration.out, e.g.
+// -L1d:size=32768.  Blank lines and lines starting with '#' are ignored.
+// The variant name becomes a directory name, so it may not contain '/',
+// be "." or "..", or repeat an earlier variant.  Every override must name
+// a parameter that all components of its configuration can re-apply in
+// reconfigure().
+//
+// Variants breaking these rules are reported and left out of aVariants;
+// the result is false if there were any, or if the file cannot be read.
+bool FlexusImpl::readSweep(std::string const & aSpecFile, sweep_variants & aVariants) {
+  aVariants.clear();
+  std::ifstream spec(aSpecFile.c_str());
+  if (! spec) {
+    DBG_( Crit, ( << "Unable to open configuration sweep file " << aSpecFile ) );
+    return false;
+  }
+
+  bool valid = true;
+  std::string line;
+  while (std::getline(spec, line)) {
+    std::istringstream fields(line);
+    std::string name;
+    if (! (fields >> name) || name[0] == '#') {
+      continue;
+    }
+    bool variant_valid = true;
+    if (name == "." || name == ".." || name.find('/') != std::string::npos) {
+      DBG_( Crit, ( << "Sweep variant name \"" << name << "\" is not a plain directory name" ) );
+      variant_valid = false;
+    }
+    for (auto const & variant : aVariants) {
+      if (variant.first == name) {
+        DBG_( Crit, ( << "Sweep variant " << name << " is listed twice" ) );
+        variant_valid = false;
+      }
+    }
+    sweep_overrides overrides;
+    std::string assignment;
+    while (fields >> assignment) {
+      std::string::size_type eq = assignment.find('=');
+      if (eq == std::string::npos || eq == 0) {
+        DBG_( Crit, ( << "Malformed override \"" << assignment << "\" for sweep variant " << name ) );
+        variant_valid = false;
+        continue;
+      }
+      std::string parameter( assignment.substr(0, eq) );
+      if (ConfigurationManager::getParameterValue(parameter) == "not_found") {
+        DBG_( Crit, ( << "Sweep variant " << name << " overrides unknown parameter " << parameter ) );
+        variant_valid = false;
+      } else if (! ComponentManager::getComponentManager().isReconfigurable(parameter)) {
+        DBG_( Crit, ( << "Sweep variant " << name << " overrides " << parameter << ", which its components cannot re-apply after warming" ) );
+        variant_valid = false;
+      }
+      overrides.push_back( std::make_pair(parameter, assignment.substr(eq + 1)) );
+    }
+    if (variant_valid) {
+      aVariants.push_back( std::make_pair(name, overrides) );
+    } else {
+      DBG_( Crit, ( << "Skipping sweep variant " << name ) );
+      valid = false;
+    }
+  }
+  if (aVariants.empty()) {
+    DBG_( Crit, ( << "Configuration sweep file " << aSpecFile << " lists no usable variants" ) );
+  }
+  return valid;
+}
+
+//Forks the variants of aSpecFile now, skipping any that readSweep rejects
+void FlexusImpl::forkSweep(std::string const & aSpecFile) {
+  sweep_variants variants;
+  readSweep(aSpecFile, variants);
+  forkVariants(variants);
+}
+
+//Threads of this process, including the calling one; 0 if unknown
+static uint32_t countThreads() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.compare(0, 8, "Threads:") == 0) {
+      return boost::lexical_cast<uint32_t>( line.substr(line.find_first_not_of(" \t", 8)) );
+    }
+  }
+  return 0;
+}
+
+// Forks one copy of the (warmed) simulator per variant.  Every child moves
+// into its own subdirectory <variant-name>/, so stats_db and other relative
+// outputs are kept apart, applies its overrides, has every component
+// reconfigure itself and continues simulating.  The parent waits for all
+// children and then terminates.
+//
+// Only the calling thread survives fork().  Components stop the threads
+// they own in prepareFork() and restart them in reconfigure(); the other
+// Flexus worker threads (flexpoint codecs, parallel state load) only live
+// for the duration of a save or load.
+//
+// The QEMU API offers no way to pause or quiesce the emulator, so sweeps
+// are only supported with a single-threaded QEMU (no I/O thread, no
+// multi-threaded TCG).  If any other thread is still running once the
+// components have stopped theirs, the sweep is refused and the simulation
+// ends.  Children also inherit QEMU's open file descriptors, disk images
+// included, so guests must not write to disk after the fork (run QEMU
+// with -snapshot).
+void FlexusImpl::forkVariants(sweep_variants const & aVariants) {
+  if (aVariants.empty()) {
+    return;
+  }
+
+  FastAlloc::reportStats();
+  backupStats("stats_db");
+  ComponentManager::getComponentManager().prepareFork();
+  uint32_t threads = countThreads();
+  if (threads != 1) {
+    DBG_( Crit, ( << "Refusing to fork a configuration sweep: " << threads << " threads are running, and only the forking one would survive.  Sweeps need a single-threaded QEMU." ) );
+    terminateSimulation();
+    return;
+  }
+  DBG_( Crit, ( << "Forking " << aVariants.size() << " sweep variants at cycle " << theCycleCount ) );
+
+  std::vector<pid_t> children;
+  for (auto const & variant : aVariants) {
+    std::cout.flush();
+    std::cerr.flush();
+    pid_t pid = fork();
+    if (pid < 0) {
+      DBG_( Crit, ( << "fork() failed for sweep variant " << variant.first ) );
+      break;
+    }
+    if (pid == 0) {
+      mkdir(variant.first.c_str(), 0777);
+      if (chdir(variant.first.c_str()) != 0) {
+        DBG_Assert( false, ( << "Sweep variant cannot enter directory " << variant.first ) );
+      }
+      for (auto const & assignment : variant.second) {
+        setConfiguration(assignment.first, assignment.second);
+      }
+      ComponentManager::getComponentManager().reconfigureComponents();
+      writeConfiguration("configuration.out");
+
+      Stat::getStatManager()->closeMeasurement(theCurrentStatRegionName);
+      theCurrentStatRegionName = std::string("Region ") + boost::padded_string_cast < 3, '0' > (theCurrentStatRegion++);
+      Stat::getStatManager()->openMeasurement(theCurrentStatRegionName);
+      Stat::getStatManager()->openMeasurement("sweep");
+
+      DBG_( Crit, ( << "Sweep variant " << variant.first << " continuing as pid " << getpid() ) );
+      return;
+    }
+    children.push_back(pid);
+  }
+
+  for (pid_t child : children) {
+    int32_t status = 0;
+    waitpid(child, &status, 0);
+    DBG_( Crit, ( << "Sweep child " << child << " exited with status " << (WIFEXITED(status) ? WEXITSTATUS(status) : -1) ) );
+  }
+  terminateSimulation();
+}
+
 void FlexusImpl::setStatInterval(std::string const & aValue) {
   theStatInterval = boost::lexical_cast<uint64_t>(aValue);
   DBG_(Dev, Set( (Source) << "flexus") ( << "Set stat interval to : " << theStatInterval) );
@@ -541,7 +762,7 @@ void FlexusImpl::quiesceAndSave() {
     theSaveRequested = true;
     theSaveName = "newckpt-" + boost::padded_string_cast < 4, '0' > (theSaveCtr);
   } else {
-    doSave("newckpt-" + boost::padded_string_cast < 4, '0' > (theSaveCtr));
+    doSaveAndBreak("newckpt-" + boost::padded_string_cast < 4, '0' > (theSaveCtr));
   }
   ++theSaveCtr;
 }
@@ -553,7 +774,7 @@ void FlexusImpl::quiesceAndSave(uint32_t aSaveNum) {
     theSaveRequested = true;
     theSaveName = "ckpt-" + boost::padded_string_cast < 4, '0' > (aSaveNum);
   } else {
-    doSave("ckpt-" + boost::padded_string_cast < 4, '0' > (aSaveNum));
+    doSaveAndBreak("ckpt-" + boost::padded_string_cast < 4, '0' > (aSaveNum));
   }
 }
 
@@ -587,10 +808,23 @@ void FlexusImpl::doLoad(std::string const & aDirName) {
   if (! initialized() ) {
     initializeComponents();
   }
-  ComponentManager::getComponentManager().doLoad( aDirName );
-#else 
-  // FIXME TODO XXX
-    DBG_( Crit, ( << "Actually, QEMU can't do this... Yet?? " ) );
+  ComponentManager::getComponentManager().doLoad( aDirName, theLoadThreads );
+#else
+  if (! initialized() ) {
+    initializeComponents();
+  }
+  readCheckpointManifest( aDirName );
+  ComponentManager::getComponentManager().doLoad( aDirName, theLoadThreads );
+
+  // Stats from the run that produced the checkpoint are kept as separate,
+  // prefixed measurements; the live measurements restart from zero.
+  std::ifstream stats_in( (aDirName + "/stats_db.out.gz").c_str(), std::ios::binary );
+  if (stats_in) {
+    boost::iostreams::filtering_istream in;
+    in.push(boost::iostreams::gzip_decompressor());
+    in.push(stats_in);
+    Stat::getStatManager()->loadMore(in, "ckpt-");
+  }
 #endif
 }
 
@@ -609,12 +843,88 @@ void FlexusImpl::doSave(std::string const & aDirName, bool justFlexus) {
   }
   ComponentManager::getComponentManager().doSave( aDirName );
 #else
-  // FIXME TODO XXX
-    DBG_( Crit, ( << "Actually, QEMU can't do this... Yet??" ) );
+  // Only Flexus state is written; the emulator snapshot is taken
+  // separately and must match the positions recorded in the manifest.
+  mkdir(aDirName.c_str(), 0777);
+  writeCheckpointManifest( aDirName );
+  ComponentManager::getComponentManager().doSave( aDirName );
+  FastAlloc::reportStats();
+  saveStats( aDirName + "/stats_db.out.gz" );
 #endif
 
 }
 
+//Saves made while simulation is running.  Under QEMU only Flexus state is
+//written, so simulation breaks after the save to let the driver take the
+//emulator snapshot at exactly the position recorded in the manifest.
+void FlexusImpl::doSaveAndBreak(std::string const & aDirName) {
+  doSave(aDirName);
+#ifdef CONFIG_QEMU
+  std::string msg("Flexus saved " + aDirName + "; take the matching emulator snapshot.");
+  Qemu::API::QEMU_break_simulation(msg.c_str());
+#endif
+}
+
+#ifdef CONFIG_QEMU
+// The manifest identifies a Flexus checkpoint and records where the
+// emulator must be for the component state to be resumable: the Flexus
+// cycle count and the instruction count of every CPU at save time.
+static const uint32_t kCheckpointVersion = 1;
+
+void FlexusImpl::writeCheckpointManifest(std::string const & aDirName) const {
+  std::ofstream manifest( (aDirName + "/flexus-checkpoint").c_str() );
+  manifest << "version " << kCheckpointVersion << std::endl;
+  manifest << "cycle " << theCycleCount << std::endl;
+  int32_t num_cpus = Qemu::API::QEMU_get_num_cores();
+  manifest << "cpus " << num_cpus << std::endl;
+  for (int32_t i = 0; i < num_cpus; ++i) {
+    manifest << "icount " << i << " " << Qemu::API::QEMU_get_instruction_count(i) << std::endl;
+  }
+  DBG_Assert( manifest.good(), ( << "Unable to write checkpoint manifest in " << aDirName ) );
+}
+
+void FlexusImpl::readCheckpointManifest(std::string const & aDirName) {
+  std::ifstream manifest( (aDirName + "/flexus-checkpoint").c_str() );
+  if (! manifest) {
+    DBG_( Crit, ( << "No checkpoint manifest in " << aDirName << "; loading component state only" ) );
+    return;
+  }
+
+  std::string key;
+  uint32_t version = 0;
+  bool positioned = true;
+  while (manifest >> key) {
+    if (key == "version") {
+      manifest >> version;
+      DBG_Assert( version == kCheckpointVersion, ( << "Checkpoint " << aDirName << " has version " << version << ", expected " << kCheckpointVersion ) );
+    } else if (key == "cycle") {
+      manifest >> theCycleCount;
+    } else if (key == "cpus") {
+      int32_t num_cpus;
+      manifest >> num_cpus;
+      DBG_Assert( num_cpus == Qemu::API::QEMU_get_num_cores(), ( << "Checkpoint " << aDirName << " was taken with " << num_cpus << " cpus" ) );
+    } else if (key == "icount") {
+      int32_t cpu;
+      uint64_t count;
+      manifest >> cpu >> count;
+      uint64_t current = Qemu::API::QEMU_get_instruction_count(cpu);
+      if (current != count) {
+        DBG_( Crit, ( << "CPU " << cpu << " is at instruction " << current << " but checkpoint " << aDirName << " was taken at " << count ) );
+        positioned = false;
+      }
+    } else {
+      std::getline(manifest, key);
+    }
+  }
+  DBG_Assert( version != 0, ( << "Checkpoint manifest in " << aDirName << " has no version" ) );
+  if (! positioned) {
+    DBG_Assert( theLoadMismatchOk, ( << "Emulator state does not match checkpoint " << aDirName << "; load the snapshot taken with it, or set ckpt_load_mismatch_ok to resume anyway" ) );
+    DBG_( Crit, ( << "Emulator state does not match checkpoint " << aDirName << "; simulation continues from mismatched state" ) );
+  }
+  DBG_( Crit, ( << "Resuming from checkpoint " << aDirName << " at cycle " << theCycleCount ) );
+}
+#endif
+
 void FlexusImpl::backupStats(std::string const & aFilename) const {
   std::string fullName = aFilename + std::string(".out.gz");
   std::string last1Name = aFilename + std::string(".001.out.gz");
@@ -766,6 +1076,7 @@ void FlexusImpl::terminateSimulation() {
     (*iter)();
   }
 
+  FastAlloc::reportStats();
   Flexus::Stat::getStatManager()->finalize();
   backupStats("stats_db");
 
@@ -957,6 +1268,13 @@ public:
       , "value"
     );
 
+    aClass.addCommand
+    ( & FlexusImpl::forkSweep
+      , "fork-sweep"
+      , "Fork one warmed copy of the simulator per variant in a sweep file"
+      , "filename"
+    );
+
     aClass.addCommand
     ( & FlexusImpl::enterFastMode
       , "fast-mode"
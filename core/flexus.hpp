@@ -73,9 +73,16 @@ public:
 
   virtual void onTerminate( std::function<void () > ) = 0;
   virtual void terminateSimulation() = 0;
+  //End the simulation at the next advanceCycles(), via the stop-cycle check
+  virtual void requestStop() = 0;
   virtual void quiesce() = 0;
   virtual void quiesceAndSave(uint32_t aSaveNum) = 0;
   virtual void quiesceAndSave() = 0;
+  virtual void loadState(std::string const & aDirName) = 0;
+  //Workers for loading independent components (0 = all cores, 1 = serial)
+  virtual void setLoadThreads(uint32_t aThreads) = 0;
+  //Resume even if the emulator is not where the checkpoint was taken
+  virtual void setLoadMismatchOk(bool anOk) = 0;
 
   virtual void setDebug(std::string const & aDebugSeverity) = 0;
 
@@ -84,6 +91,9 @@ public:
   virtual void setTimestampInterval(std::string const & aValue) = 0;
   virtual void setRegionInterval(std::string const & aValue) = 0;
 
+  //Configuration sweeps: at aCycle, fork one child per variant in aSpecFile
+  virtual void scheduleForkSweep(std::string const & aSpecFile, uint64_t aCycle) = 0;
+
 };
 
 extern FlexusInterface * theFlexus;
@@ -494,8 +494,10 @@ public:
   bool validateMMU(MMU::mmu_t * m = NULL);
   void dumpMMU(MMU::mmu_t * m = NULL);
   void initializeASIInfo();
+  void flushSoftTLB() const;
 
   unsigned long long mmuRead(VirtualMemoryAddress anAddress, int anASI);
+  unsigned long long primaryContext() const;
   void mmuWrite(VirtualMemoryAddress anAddress, int anASI, unsigned long long aValue);
 
   //QemuImpl MMU API
@@ -565,6 +567,7 @@ public:
 
 #if FLEXUS_TARGET_IS(v9)
 bool isTranslatingASI(int anASI);
+void setSoftTLBSize(unsigned int anEntries);
 #endif
 
 unsigned long long endianFlip(unsigned long long val, int aSize);
@@ -75,6 +75,30 @@ std::vector<std::deque<MMU::mmu_t> > theMMUckpts;
 
 std::vector<int> theMMUMap;
 
+// Direct-mapped software TLB per processor, in front of mmu_lookup().  Only
+// successful translations are cached.  Entries are indexed by 8KB virtual
+// page (the smallest SPARC page) and hold the full TTE, so mmu_make_paddr()
+// supplies the offset for larger pages.  Every Flexus-side MMU update
+// flushes the processor's table.
+struct SoftTLBEntry {
+  MMU::address_t theVPage;
+  unsigned long long theKey;
+  MMU::tte_data theData;
+  bool theValid;
+  bool theUsedSet; //entry was filled by an MMU_TRANSLATE lookup, so the TTE U bit is already set
+};
+
+unsigned int theSoftTLBSize = 64;
+std::vector<std::vector<SoftTLBEntry> > theSoftTLBs;
+
+void setSoftTLBSize(unsigned int anEntries) {
+  DBG_Assert( (anEntries & (anEntries - 1)) == 0, ( << "Soft TLB size must be a power of 2: " << anEntries ) );
+  theSoftTLBSize = anEntries;
+  for (unsigned int i = 0; i < theSoftTLBs.size(); ++i) {
+    theSoftTLBs[i].assign(theSoftTLBSize, SoftTLBEntry());
+  }
+}
+
 void v9ProcessorImpl::initializeMMUs() {
   if (!theMMUs_initialized) {
     theMMUs_initialized = true;
@@ -86,6 +110,8 @@ void v9ProcessorImpl::initializeMMUs() {
     theMMUckpts.resize( num_procs );
 
     theMMUMap.resize( num_procs );
+    theSoftTLBs.resize( num_procs );
+    setSoftTLBSize( theSoftTLBSize );
 
     for (unsigned int i = 0; i < theMMUs.size(); ++i) {
       //API::conf_object_t * cpu = Qemu::API::QEMU_get_processor(ProcessorMapper::mapFlexusIndex2ProcNum(i));
@@ -360,9 +386,11 @@ void v9ProcessorImpl::rollbackMMUCkpts(int n) {
   for (int i = 0; i < n; ++i) theMMUckpts[id()].pop_back();
   theMMUs[id()] = theMMUckpts[id()].back();
   theMMUckpts[id()].pop_back();
+  flushSoftTLB();
 }
 
 void v9ProcessorImpl::resyncMMU() {
+  flushSoftTLB();
   //MMU::fm_init_mmu_from_simics(&theMMUs[id()], SIM_get_attribute(*this, "mmu").u.object );	//ALEX - FIXME
 }
 
@@ -387,6 +415,10 @@ unsigned long long v9ProcessorImpl::mmuRead(VirtualMemoryAddress anAddress, int
   return access.val;
 }
 
+unsigned long long v9ProcessorImpl::primaryContext() const {
+  return theMMUs[id()].primary_context;
+}
+
 void v9ProcessorImpl::mmuWrite(VirtualMemoryAddress anAddress, int anASI, unsigned long long aValue) {
   MMU::mmu_access_t access;
   access.va = anAddress;
@@ -394,6 +426,15 @@ void v9ProcessorImpl::mmuWrite(VirtualMemoryAddress anAddress, int anASI, unsign
   access.type = MMU::mmu_access_store;
   access.val = aValue;
   mmu_access( &theMMUs[id()], & access );
+  flushSoftTLB();
+}
+
+void v9ProcessorImpl::flushSoftTLB() const {
+  if (id() < static_cast<int>(theSoftTLBs.size())) {
+    for (SoftTLBEntry & entry : theSoftTLBs[id()]) {
+      entry.theValid = false;
+    }
+  }
 }
 
 void v9ProcessorImpl::dumpMMU(MMU::mmu_t * anMMU) {
@@ -454,16 +495,53 @@ void v9ProcessorImpl::translate_MMUImpl(Translation & aTranslation, bool aTakeEx
 
     MMU::mmu_exception_t exception(MMU::no_exception);
 
-    MMU::tte_data data = MMU::mmu_lookup(&theMMUs[id()],
-                                         (aTranslation.theType == Translation::eFetch),
-                                         aTranslation.theVaddr,
-                                         asi_class,
-                                         aTranslation.theASI,
-                                         false /*no_fault*/,
-                                         aTranslation.thePSTATE & 0x4,
-                                         ((aTranslation.theType == Translation::eStore) ? MMU::mmu_access_store : MMU::mmu_access_load),
-                                         & exception,
-                                         mode);
+    //Look in the soft TLB first.  The key covers everything else
+    //mmu_lookup() depends on: context, ASI, class, fetch, privilege and store.
+    MMU::mmu_t & mmu = theMMUs[id()];
+    MMU::mmu_reg_t ctxt = 0;
+    if (asi_class == MMU::CLASS_ASI_PRIMARY) {
+      ctxt = mmu.primary_context;
+    } else if (asi_class == MMU::CLASS_ASI_SECONDARY) {
+      ctxt = mmu.secondary_context;
+    }
+    bool is_fetch = (aTranslation.theType == Translation::eFetch);
+    bool is_store = (aTranslation.theType == Translation::eStore);
+    bool priv = (aTranslation.thePSTATE & 0x4);
+    unsigned long long key = (ctxt << 16)
+                             | ((aTranslation.theASI & 0xFF) << 8)
+                             | (asi_class << 4)
+                             | (is_fetch << 2)
+                             | (priv << 1)
+                             | is_store;
+    MMU::address_t vpage = aTranslation.theVaddr >> 13;
+    SoftTLBEntry * entry = 0;
+    if (id() < static_cast<int>(theSoftTLBs.size()) && theSoftTLBSize > 0) {
+      entry = &theSoftTLBs[id()][vpage & (theSoftTLBSize - 1)];
+    }
+
+    MMU::tte_data data;
+    if (entry && entry->theValid && entry->theVPage == vpage && entry->theKey == key
+        && (entry->theUsedSet || mode != MMU::MMU_TRANSLATE)) {
+      data = entry->theData;
+    } else {
+      data = MMU::mmu_lookup(&mmu,
+                             is_fetch,
+                             aTranslation.theVaddr,
+                             asi_class,
+                             aTranslation.theASI,
+                             false /*no_fault*/,
+                             priv,
+                             (is_store ? MMU::mmu_access_store : MMU::mmu_access_load),
+                             & exception,
+                             mode);
+      if (entry && exception == MMU::no_exception) {
+        entry->theVPage = vpage;
+        entry->theKey = key;
+        entry->theData = data;
+        entry->theValid = true;
+        entry->theUsedSet = (mode == MMU::MMU_TRANSLATE);
+      }
+    }
     aTranslation.theTTEEntry = data;
     aTranslation.thePaddr = PhysicalMemoryAddress(MMU::mmu_make_paddr(data, aTranslation.theVaddr));
     aTranslation.theException = exception;
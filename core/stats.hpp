@@ -99,7 +99,11 @@ struct StatManager {
   virtual boost::intrusive_ptr<aux_::Measurement> openMeasurement(std::string const & aName, std::string const & aStatSpec = std::string(".*")) = 0;
   virtual void openPeriodicMeasurement(std::string const & aName, int64_t aPeriod, accumulation_type anAccumulation, std::string const & aStatSpec = std::string(".*")) = 0;
   virtual void openLoggedPeriodicMeasurement(std::string const & aName, int64_t aPeriod, accumulation_type anAccumulation, std::ostream & anOstream, std::string const & aStatSpec = std::string(".*")) = 0;
+  virtual boost::intrusive_ptr<aux_::ConfidenceMeasurement> openConfidenceMeasurement(std::string const & aName, int64_t aPeriod, std::string const & anExpression, double aConfidence, double aTargetError, int64_t aMinSamples, std::function<void()> anOnConverged = std::function<void()>(), std::string const & aStatSpec = std::string(".*")) = 0;
   virtual void closeMeasurement(std::string const & aName) = 0;
+  //Evaluates a stats_calc expression (as used by <EXPR:...>) with
+  //aMeasurement as the default measurement
+  virtual bool evaluate(std::string const & anExpression, std::string const & aMeasurement, double & aValue) = 0;
   virtual void listStats(std::ostream & anOstream) = 0;
   virtual void listMeasurements(std::ostream & anOstream) = 0;
   virtual void printMeasurement(std::string const & aMeasurementSpec, std::ostream & anOstream) = 0;
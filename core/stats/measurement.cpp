@@ -109,6 +109,11 @@ void SimpleMeasurement :: close() {
   }
 }
 
+void SimpleMeasurement :: reset() {
+  for (auto & aStat : theStats)
+    aStat.second.reset();
+}
+
 void SimpleMeasurement :: print(std::ostream & anOstream, std::string const & options) {
   stat_handle_map::iterator iter = theStats.begin();
   stat_handle_map::iterator end = theStats.end();
@@ -1024,6 +1029,110 @@ void LoggedPeriodicMeasurement  :: fire () {
   }
 }
 
+ConfidenceMeasurement::ConfidenceMeasurement( std::string const & aName, std::string const & aStatExpression, std::string const & anExpression, int64_t aPeriod, double aConfidence, double aTargetError, int64_t aMinSamples, std::function<void()> anOnConverged)
+  : SimpleMeasurement(aName, aStatExpression)
+  , theExpression(anExpression)
+  , thePeriod(aPeriod)
+  , theConfidence(aConfidence)
+  , theTargetError(aTargetError)
+  , theMinSamples(aMinSamples < 2 ? 2 : aMinSamples)
+  , theCancelled(false)
+  , theConverged(false)
+  , theSamples(0)
+  , theMean(0)
+  , theM2(0)
+  , theOnConverged(anOnConverged) {
+  //Period of zero means the owner calls sample()
+  if (aPeriod > 0) {
+    getStatManager()->addEvent(getStatManager()->ticks() + aPeriod, [this](){ return this->fire(); });
+  }
+}
+
+void ConfidenceMeasurement :: close() {
+  theCancelled = true;
+  SimpleMeasurement::close();
+}
+
+void ConfidenceMeasurement :: print(std::ostream & anOstream, std::string const & options) {
+  anOstream << *this << ": " << theExpression << " = " << theMean;
+  if (theSamples >= 2) {
+    anOstream << " +/- " << std::setprecision(3) << relativeError() * 100 << "%";
+  }
+  anOstream << " at " << theConfidence * 100 << "% confidence over " << theSamples << " intervals" << (theConverged ? " (converged)" : "") << std::endl;
+  SimpleMeasurement::print(anOstream, options);
+}
+
+void ConfidenceMeasurement :: fire () {
+  if (! theCancelled) {
+    if (! sample()) {
+      std::cout << "Measurement " << name() << " cannot evaluate " << theExpression << "; no longer sampling" << std::endl;
+      theCancelled = true;
+      return;
+    }
+    getStatManager()->addEvent(getStatManager()->ticks() + thePeriod, [this](){ return this->fire(); });
+  }
+}
+
+bool ConfidenceMeasurement :: sample() {
+  double value;
+  if (! getStatManager()->evaluate(theExpression, name(), value)) {
+    return false;
+  }
+  reset();
+  addSample(value);
+  return true;
+}
+
+void ConfidenceMeasurement :: addSample(double aValue) {
+  ++theSamples;
+  double delta = aValue - theMean;
+  theMean += delta / theSamples;
+  theM2 += delta * (aValue - theMean);
+
+  if (! theConverged && theSamples >= theMinSamples && relativeError() <= theTargetError) {
+    theConverged = true;
+    std::cout << "Measurement " << name() << " converged after " << theSamples << " intervals: "
+              << theExpression << " = " << theMean << " +/- " << relativeError() * 100 << "%" << std::endl;
+    if (theOnConverged) {
+      theOnConverged();
+    }
+  }
+}
+
+double ConfidenceMeasurement :: variance() const {
+  if (theSamples < 2) {
+    return 0.0;
+  }
+  return theM2 / (theSamples - 1);
+}
+
+double ConfidenceMeasurement :: relativeError() const {
+  if (theSamples < 2) {
+    return HUGE_VAL;
+  }
+  double half_width = zScore(theConfidence) * std::sqrt(variance() / theSamples);
+  if (half_width == 0.0) {
+    return 0.0;
+  }
+  if (theMean == 0.0) {
+    return HUGE_VAL;
+  }
+  return half_width / std::fabs(theMean);
+}
+
+double ConfidenceMeasurement :: zScore(double aConfidence) {
+  double lo = 0.0, hi = 10.0;
+  for (int32_t i = 0; i < 64; ++i) {
+    double mid = (lo + hi) / 2;
+    if (std::erf(mid / std::sqrt(2.0)) < aConfidence) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  return (lo + hi) / 2;
+}
+
 }
 
 } // end Stat
@@ -346,6 +346,7 @@ void Prediction::reject(int64_t anOverride) {
 namespace aux_ {
 
 void doEXPR( std::ostream & anOstream, std::string const & options, std::map<std::string, Measurement *> & measurements,  std::string const & default_measurement );
+bool evalEXPR( std::string const & anExpression, std::map<std::string, Measurement *> & measurements,  std::string const & default_measurement, double & aValue, std::string & anError );
 
 template <class BiDirIter>
 class LineFormatter {
@@ -814,6 +815,20 @@ public:
     }
   }
 
+  boost::intrusive_ptr<ConfidenceMeasurement> openConfidenceMeasurement(std::string const & aName, int64_t aPeriod, std::string const & anExpression, double aConfidence, double aTargetError, int64_t aMinSamples, std::function<void()> anOnConverged = std::function<void()>(), std::string const & aStatSpec = std::string(".*")) {
+    if (theMeasurements.find(aName) == theMeasurements.end()) {
+      boost::intrusive_ptr<ConfidenceMeasurement> measurement(new ConfidenceMeasurement(aName, aStatSpec, anExpression, aPeriod, aConfidence, aTargetError, aMinSamples, anOnConverged));
+      for(auto* aStat: theStats)
+        measurement->addToMeasurement(aStat);
+
+      theMeasurements[aName] = measurement;
+      return measurement;
+    } else {
+      //Need to implement re-opening
+      return boost::dynamic_pointer_cast<ConfidenceMeasurement>(theMeasurements[aName]);
+    }
+  }
+
   void reduceNodes(std::string const & aMeasurementSpec) {
     boost::regex spec(aMeasurementSpec);
     measurement_collection selected_measurements;
@@ -860,6 +875,19 @@ public:
     // }
   }
 
+  bool evaluate(std::string const & anExpression, std::string const & aMeasurement, double & aValue) {
+    std::map<std::string, Measurement *> measurements;
+    for (auto & entry : theMeasurements)
+      measurements[entry.first] = entry.second.get();
+
+    std::string error;
+    if (! evalEXPR(anExpression, measurements, aMeasurement, aValue, error)) {
+      std::cout << "Cannot evaluate " << anExpression << " on " << aMeasurement << ": " << error << std::endl;
+      return false;
+    }
+    return true;
+  }
+
   void closeMeasurement(std::string const & aName) {
     measurement_collection::iterator iter = theMeasurements.find(aName);
     if (iter == theMeasurements.end()) {
@@ -1129,8 +1157,10 @@ public:
   void tick(int64_t anAdvance = 1) {
     theTick += anAdvance;
     while (! theEventQueue.empty() && ticks() >= theEventQueue.top().theDeadline) {
-      theEventQueue.top().theEvent();
+      //Pop before firing, since the event may schedule another one
+      std::function< void() > fire( theEventQueue.top().theEvent );
       theEventQueue.pop();
+      fire();
     }
   }
 
@@ -1172,6 +1202,7 @@ public:
     ar.template register_type<StatValue_CountAccumulator>();
     ar.template register_type<StatValue_StdDevLog2Histogram>();
     ar.template register_type<StatValue_UniqueCounter<uint32_t> >();
+    ar.template register_type<ConfidenceMeasurement>();
   }
 
   void save(std::ostream & anOstream) const {
@@ -399,28 +399,40 @@ struct calculator : public grammar<calculator> {
 
 };
 
-void doEXPR( std::ostream & anOstream, std::string const & options, std::map<std::string, Measurement *> & measurements,  std::string const & default_measurement ) {
+bool evalEXPR( std::string const & anExpression, std::map<std::string, Measurement *> & measurements,  std::string const & default_measurement, double & aValue, std::string & anError ) {
 
   stack<float> eval;
   calculator  calc(eval, measurements, default_measurement); //  Our parser
 
   try {
-    parse_info<> info = parse(options.c_str(), calc, space_p);
+    parse_info<> info = parse(anExpression.c_str(), calc, space_p);
 
     if (info.full) {
       if (eval.size() == 1) {
-        anOstream << std::fixed << std::setw(5) << std::setprecision(2) << std::showpoint << std::right << static_cast<float>(eval.top());
+        aValue = eval.top();
+        return true;
       } else {
-        anOstream << "{ERR:Bad EXPR: Unable to calculate}";
+        anError = "{ERR:Bad EXPR: Unable to calculate}";
       }
     } else {
-      anOstream << "{ERR:Bad EXPR: Parse failed at " << info.stop << "}";
+      anError = std::string("{ERR:Bad EXPR: Parse failed at ") + info.stop + "}";
     }
 
   } catch (CalcException & anException) {
-    anOstream << anException.theReason;
+    anError = anException.theReason;
   } catch (...) {
-    anOstream << "{ERR:Attempt to access non-SimpleMeasurement}";
+    anError = "{ERR:Attempt to access non-SimpleMeasurement}";
+  }
+  return false;
+}
+
+void doEXPR( std::ostream & anOstream, std::string const & options, std::map<std::string, Measurement *> & measurements,  std::string const & default_measurement ) {
+  double value;
+  std::string error;
+  if (evalEXPR(options, measurements, default_measurement, value, error)) {
+    anOstream << std::fixed << std::setw(5) << std::setprecision(2) << std::showpoint << std::right << static_cast<float>(value);
+  } else {
+    anOstream << error;
   }
 }
 
@@ -0,0 +1,165 @@
+// DO-NOT-REMOVE begin-copyright-block 
+//QFlex consists of several software components that are governed by various
+//licensing terms, in addition to software that was developed internally.
+//Anyone interested in using QFlex needs to fully understand and abide by the
+//licenses governing all the software components.
+//
+//### Software developed externally (not by the QFlex group)
+//
+//    * [NS-3](https://www.gnu.org/copyleft/gpl.html)
+//    * [QEMU](http://wiki.qemu.org/License) 
+//    * [SimFlex] (http://parsa.epfl.ch/simflex/)
+//
+//Software developed internally (by the QFlex group)
+//**QFlex License**
+//
+//QFlex
+//Copyright (c) 2016, Parallel Systems Architecture Lab, EPFL
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//    * Neither the name of the Parallel Systems Architecture Laboratory, EPFL,
+//      nor the names of its contributors may be used to endorse or promote
+//      products derived from this software without specific prior written
+//      permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE PARALLEL SYSTEMS ARCHITECTURE LABORATORY,
+//EPFL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+//GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+//LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+//THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// DO-NOT-REMOVE end-copyright-block   
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+#include <components/CommonQEMU/CacheImage.hpp>
+
+using namespace nCacheImage;
+
+namespace {
+
+struct TestBlock {
+  uint64_t theTag;
+  uint32_t theState;
+  uint32_t theAge;
+};
+
+// Six bytes, so the section after it starts on padding
+struct TestEntry {
+  uint16_t theIndex;
+  uint16_t theSharers;
+  uint16_t theOwner;
+};
+
+std::string imageName(char const * aTest) {
+  return "/tmp/flexus-test-" + std::to_string(getpid()) + "-" + aTest + ".img";
+}
+
+void writeImage(std::string const & aFileName, uint64_t aSets, uint32_t anAssoc) {
+  std::vector<TestBlock> blocks;
+  for (uint64_t i = 0; i < aSets * anAssoc; ++i) {
+    TestBlock block = { i << 6, static_cast<uint32_t>(i % 4), static_cast<uint32_t>(i % anAssoc) };
+    blocks.push_back(block);
+  }
+  std::vector<TestEntry> entries;
+  for (uint16_t i = 0; i < 3; ++i) {
+    TestEntry entry = { i, static_cast<uint16_t>(1 << i), static_cast<uint16_t>(i + 1) };
+    entries.push_back(entry);
+  }
+  ImageWriter writer(aFileName);
+  writer.section(aSets, anAssoc, blocks);
+  writer.section(0, 0, entries);
+  writer.section(0, 0, std::vector<TestBlock>(1, blocks.back()));
+  BOOST_REQUIRE( writer.good() );
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE( cache_image )
+
+BOOST_AUTO_TEST_CASE( round_trip ) {
+  std::string fname( imageName("round-trip") );
+  writeImage(fname, 16, 4);
+  {
+    ImageReader reader(fname);
+    BOOST_REQUIRE( reader.good() );
+
+    uint64_t count = 0;
+    TestBlock const * blocks = reader.section<TestBlock>(16, 4, count);
+    BOOST_REQUIRE( blocks != nullptr );
+    BOOST_REQUIRE_EQUAL( count, 64U );
+    for (uint64_t i = 0; i < count; ++i) {
+      BOOST_CHECK_EQUAL( blocks[i].theTag, i << 6 );
+      BOOST_CHECK_EQUAL( blocks[i].theState, i % 4 );
+      BOOST_CHECK_EQUAL( blocks[i].theAge, i % 4 );
+    }
+
+    TestEntry const * entries = reader.section<TestEntry>(0, 0, count);
+    BOOST_REQUIRE( entries != nullptr );
+    BOOST_REQUIRE_EQUAL( count, 3U );
+    BOOST_CHECK_EQUAL( entries[2].theIndex, 2 );
+    BOOST_CHECK_EQUAL( entries[2].theSharers, 4 );
+    BOOST_CHECK_EQUAL( entries[2].theOwner, 3 );
+
+    // The 18 bytes of entries are padded so this section stays aligned
+    blocks = reader.section<TestBlock>(0, 0, count);
+    BOOST_REQUIRE( blocks != nullptr );
+    BOOST_REQUIRE_EQUAL( count, 1U );
+    BOOST_CHECK_EQUAL( reinterpret_cast<uintptr_t>(blocks) % 8, 0U );
+    BOOST_CHECK_EQUAL( blocks[0].theTag, 63U << 6 );
+  }
+  std::remove(fname.c_str());
+}
+
+BOOST_AUTO_TEST_CASE( geometry_mismatch ) {
+  std::string fname( imageName("geometry") );
+  writeImage(fname, 16, 4);
+  {
+    ImageReader reader(fname);
+    BOOST_REQUIRE( reader.good() );
+    uint64_t count = 0;
+    BOOST_CHECK( reader.section<TestBlock>(32, 4, count) == nullptr );
+  }
+  {
+    ImageReader reader(fname);
+    uint64_t count = 0;
+    BOOST_CHECK( reader.section<TestBlock>(16, 8, count) == nullptr );
+  }
+  {
+    // A different record layout, e.g. another MAX_NUM_SHARERS
+    ImageReader reader(fname);
+    uint64_t count = 0;
+    BOOST_CHECK( reader.section<TestEntry>(16, 4, count) == nullptr );
+  }
+  std::remove(fname.c_str());
+}
+
+BOOST_AUTO_TEST_CASE( not_an_image ) {
+  std::string fname( imageName("not-an-image") );
+  {
+    std::ofstream out(fname.c_str());
+    out << "this is a text flexpoint";
+  }
+  BOOST_CHECK( ! ImageReader(fname).good() );
+  std::remove(fname.c_str());
+  BOOST_CHECK( ! ImageReader(fname).good() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,130 @@
+// DO-NOT-REMOVE begin-copyright-block 
+//QFlex consists of several software components that are governed by various
+//licensing terms, in addition to software that was developed internally.
+//Anyone interested in using QFlex needs to fully understand and abide by the
+//licenses governing all the software components.
+//
+//### Software developed externally (not by the QFlex group)
+//
+//    * [NS-3](https://www.gnu.org/copyleft/gpl.html)
+//    * [QEMU](http://wiki.qemu.org/License) 
+//    * [SimFlex] (http://parsa.epfl.ch/simflex/)
+//
+//Software developed internally (by the QFlex group)
+//**QFlex License**
+//
+//QFlex
+//Copyright (c) 2016, Parallel Systems Architecture Lab, EPFL
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//    * Neither the name of the Parallel Systems Architecture Laboratory, EPFL,
+//      nor the names of its contributors may be used to endorse or promote
+//      products derived from this software without specific prior written
+//      permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE PARALLEL SYSTEMS ARCHITECTURE LABORATORY,
+//EPFL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+//GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+//LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+//THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// DO-NOT-REMOVE end-copyright-block   
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <memory>
+
+#include <core/stats.hpp>
+
+using Flexus::Stat::aux_::ConfidenceMeasurement;
+
+namespace {
+
+// A period of zero means nothing is scheduled with the StatManager; the
+// test feeds the intervals itself through addSample().
+ConfidenceMeasurement * makeMeasurement(double aTargetError, int64_t aMinSamples, int32_t * aConverged = 0) {
+  return new ConfidenceMeasurement("test-confidence", "^$", "{x}", 0, 0.95, aTargetError, aMinSamples,
+                                   [aConverged]() {
+                                     if (aConverged) {
+                                       ++*aConverged;
+                                     }
+                                   });
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE( confidence_measurement )
+
+BOOST_AUTO_TEST_CASE( welford_mean_and_variance ) {
+  std::unique_ptr<ConfidenceMeasurement> m( makeMeasurement(0.0, 1000) );
+  double values[] = { 2, 4, 4, 4, 5, 5, 7, 9 };
+  for (double v : values) {
+    m->addSample(v);
+  }
+  BOOST_CHECK_EQUAL( m->samples(), 8 );
+  BOOST_CHECK_CLOSE( m->mean(), 5.0, 1e-9 );
+  // Sum of squared deviations is 32, over n - 1 = 7
+  BOOST_CHECK_CLOSE( m->variance(), 32.0 / 7.0, 1e-9 );
+}
+
+BOOST_AUTO_TEST_CASE( welford_is_stable_with_a_large_offset ) {
+  std::unique_ptr<ConfidenceMeasurement> m( makeMeasurement(0.0, 1000) );
+  for (int32_t i = 0; i < 1000; ++i) {
+    m->addSample(1e9 + (i % 2));
+  }
+  BOOST_CHECK_CLOSE( m->mean(), 1e9 + 0.5, 1e-12 );
+  BOOST_CHECK_CLOSE( m->variance(), 0.25 * 1000 / 999, 1e-6 );
+}
+
+BOOST_AUTO_TEST_CASE( relative_error ) {
+  std::unique_ptr<ConfidenceMeasurement> m( makeMeasurement(0.0, 1000) );
+  BOOST_CHECK_EQUAL( m->relativeError(), HUGE_VAL );
+  m->addSample(9);
+  BOOST_CHECK_EQUAL( m->relativeError(), HUGE_VAL );
+  m->addSample(11);
+  double half_width = ConfidenceMeasurement::zScore(0.95) * std::sqrt(2.0 / 2);
+  BOOST_CHECK_CLOSE( m->relativeError(), half_width / 10, 1e-9 );
+}
+
+BOOST_AUTO_TEST_CASE( z_score ) {
+  BOOST_CHECK_CLOSE( ConfidenceMeasurement::zScore(0.95), 1.959964, 1e-4 );
+  BOOST_CHECK_CLOSE( ConfidenceMeasurement::zScore(0.99), 2.575829, 1e-4 );
+}
+
+BOOST_AUTO_TEST_CASE( constant_zero_metric_converges ) {
+  int32_t converged = 0;
+  std::unique_ptr<ConfidenceMeasurement> m( makeMeasurement(0.03, 5, &converged) );
+  for (int32_t i = 0; i < 4; ++i) {
+    m->addSample(0);
+  }
+  BOOST_CHECK( ! m->converged() );
+  m->addSample(0);
+  BOOST_CHECK_EQUAL( m->relativeError(), 0.0 );
+  BOOST_CHECK( m->converged() );
+  BOOST_CHECK_EQUAL( converged, 1 );
+  // The callback fires only on the interval that converges
+  m->addSample(0);
+  BOOST_CHECK_EQUAL( converged, 1 );
+}
+
+BOOST_AUTO_TEST_CASE( noisy_zero_mean_does_not_converge ) {
+  std::unique_ptr<ConfidenceMeasurement> m( makeMeasurement(0.03, 2) );
+  m->addSample(-1);
+  m->addSample(1);
+  BOOST_CHECK_EQUAL( m->relativeError(), HUGE_VAL );
+  BOOST_CHECK( ! m->converged() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
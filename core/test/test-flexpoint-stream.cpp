@@ -0,0 +1,127 @@
+// DO-NOT-REMOVE begin-copyright-block 
+//QFlex consists of several software components that are governed by various
+//licensing terms, in addition to software that was developed internally.
+//Anyone interested in using QFlex needs to fully understand and abide by the
+//licenses governing all the software components.
+//
+//### Software developed externally (not by the QFlex group)
+//
+//    * [NS-3](https://www.gnu.org/copyleft/gpl.html)
+//    * [QEMU](http://wiki.qemu.org/License) 
+//    * [SimFlex] (http://parsa.epfl.ch/simflex/)
+//
+//Software developed internally (by the QFlex group)
+//**QFlex License**
+//
+//QFlex
+//Copyright (c) 2016, Parallel Systems Architecture Lab, EPFL
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//    * Neither the name of the Parallel Systems Architecture Laboratory, EPFL,
+//      nor the names of its contributors may be used to endorse or promote
+//      products derived from this software without specific prior written
+//      permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE PARALLEL SYSTEMS ARCHITECTURE LABORATORY,
+//EPFL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+//GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+//LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+//THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// DO-NOT-REMOVE end-copyright-block   
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+#include <components/CommonQEMU/FlexpointStream.hpp>
+
+using namespace nFlexpoint;
+
+namespace {
+
+std::string flexpointName(char const * aTest) {
+  return "/tmp/flexus-test-" + std::to_string(getpid()) + "-" + aTest;
+}
+
+// Several codec blocks' worth of text that does not compress to nothing
+std::string makeContent(std::size_t aLines) {
+  std::string content;
+  for (std::size_t i = 0; i < aLines; ++i) {
+    content += std::to_string(i * 2654435761U) + " " + std::to_string(i) + "\n";
+  }
+  return content;
+}
+
+std::string roundTrip(std::string const & aFileName, eFlexpointCodec aCodec, uint32_t aThreads, std::string const & aContent) {
+  {
+    FlexpointOutput out(aFileName, aCodec, aThreads);
+    out.stream() << aContent;
+  }
+  FlexpointInput in(aFileName, aThreads);
+  BOOST_REQUIRE( in.good() );
+  std::string read( (std::istreambuf_iterator<char>(in.stream())), std::istreambuf_iterator<char>() );
+  std::remove(aFileName.c_str());
+  return read;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE( flexpoint_stream )
+
+BOOST_AUTO_TEST_CASE( parse_codec ) {
+  BOOST_CHECK_EQUAL( parseFlexpointCodec("none"), kRawFlexpoint );
+  BOOST_CHECK_EQUAL( parseFlexpointCodec("gzip"), kGZipFlexpoint );
+  BOOST_CHECK_EQUAL( parseFlexpointCodec("fast"), kFastFlexpoint );
+}
+
+// The reader detects the codec from the file, so each round trip below
+// also checks auto-detection
+BOOST_AUTO_TEST_CASE( round_trip_each_codec ) {
+  std::string content( makeContent(1000) );
+  BOOST_CHECK( roundTrip(flexpointName("raw"), kRawFlexpoint, 0, content) == content );
+  BOOST_CHECK( roundTrip(flexpointName("gzip"), kGZipFlexpoint, 0, content) == content );
+  BOOST_CHECK( roundTrip(flexpointName("fast"), kFastFlexpoint, 0, content) == content );
+}
+
+BOOST_AUTO_TEST_CASE( fast_codec_spans_blocks ) {
+  // Well over one 4MB block, read back with a different worker count
+  std::string content( makeContent(600000) );
+  BOOST_REQUIRE( content.size() > 2 * 4 * 1024 * 1024 );
+  std::string fname( flexpointName("fast-blocks") );
+  {
+    FlexpointOutput out(fname, kFastFlexpoint, 3);
+    out.stream() << content;
+  }
+  FlexpointInput in(fname, 1);
+  BOOST_REQUIRE( in.good() );
+  std::string read( (std::istreambuf_iterator<char>(in.stream())), std::istreambuf_iterator<char>() );
+  std::remove(fname.c_str());
+  BOOST_CHECK_EQUAL( read.size(), content.size() );
+  BOOST_CHECK( read == content );
+}
+
+BOOST_AUTO_TEST_CASE( empty_flexpoint ) {
+  BOOST_CHECK( roundTrip(flexpointName("empty-fast"), kFastFlexpoint, 0, std::string()).empty() );
+  BOOST_CHECK( roundTrip(flexpointName("empty-gzip"), kGZipFlexpoint, 0, std::string()).empty() );
+}
+
+BOOST_AUTO_TEST_CASE( missing_file ) {
+  FlexpointInput in(flexpointName("missing"));
+  BOOST_CHECK( ! in.good() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
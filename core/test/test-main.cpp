@@ -44,6 +44,13 @@ namespace Flexus {
 namespace Core {
 void Break() {}
 }
+
+// The tests run without a simulator wiring; ComponentManager still links it
+namespace Wiring {
+bool connectWiring() {
+  return true;
+}
+}
 }
 
 using namespace boost::unit_test_framework;